@@ -6,6 +6,7 @@
 #include <string> 
 #include <algorithm> 
 #include <map>
+#include <cmath>
 
 #include <glm/glm.hpp> 
 #include <glm/gtc/matrix_transform.hpp> 
@@ -64,6 +65,98 @@ void App::load_settings() {
         }
     }
 
+    // Kontrola existence objektu "culling"
+    if (data.contains("culling")) {
+        // Načtení nastavení GPU cullingu (pokud existuje)
+        if (data["culling"].contains("gpu")) {
+            culling_settings_.gpu = data["culling"]["gpu"];
+        }
+        if (data["culling"].contains("occlusion")) {
+            culling_settings_.occlusion = data["culling"]["occlusion"];
+        }
+    }
+
+    // Kontrola existence objektu "terrain"
+    if (data.contains("terrain")) {
+        // Načtení velikosti dlaždice terénu (pokud existuje)
+        if (data["terrain"].contains("tile_size")) {
+            terrain_settings_.tile_size = (std::max)(data["terrain"]["tile_size"].get<int>(), 1);
+        }
+        if (data["terrain"].contains("heightmap")) {
+            terrain_settings_.heightmap = data["terrain"]["heightmap"];
+        }
+        if (data["terrain"].contains("renderer")) {
+            std::string renderer = data["terrain"]["renderer"];
+            if (renderer == "tessellation") {
+                terrain_settings_.renderer = TERRAIN_TESSELLATION;
+            } else if (renderer == "vertex_pulling") {
+                terrain_settings_.renderer = TERRAIN_VERTEX_PULLING;
+            } else if (renderer == "streaming") {
+                terrain_settings_.renderer = TERRAIN_STREAMING;
+            } else if (renderer != "mesh") {
+                std::cerr << "Neznamy renderer terenu: " << renderer << ", pouzije se mesh" << std::endl;
+            }
+        }
+        if (data["terrain"].contains("edge_pixels")) {
+            terrain_settings_.edge_pixels = data["terrain"]["edge_pixels"];
+        }
+        if (data["terrain"].contains("lod")) {
+            terrain_settings_.lod = data["terrain"]["lod"];
+        }
+        if (data["terrain"].contains("screen_error")) {
+            terrain_settings_.screen_error = data["terrain"]["screen_error"];
+        }
+        if (data["terrain"].contains("stream_radius")) {
+            terrain_settings_.stream_radius = data["terrain"]["stream_radius"];
+        }
+        if (data["terrain"].contains("stream_workers")) {
+            terrain_settings_.stream_workers = (std::max)(data["terrain"]["stream_workers"].get<int>(), 1);
+        }
+        if (data["terrain"].contains("stream_budget_ms")) {
+            terrain_settings_.stream_budget_ms = data["terrain"]["stream_budget_ms"];
+        }
+    }
+
+    // Kontrola existence objektu "physics"
+    if (data.contains("physics")) {
+        if (data["physics"].contains("rate")) {
+            physics_settings_.rate = (std::max)(data["physics"]["rate"].get<float>(), 1.0f);
+        }
+        if (data["physics"].contains("max_steps")) {
+            physics_settings_.max_steps = (std::max)(data["physics"]["max_steps"].get<int>(), 1);
+        }
+    }
+
+    // Kontrola existence objektu "agents"
+    if (data.contains("agents")) {
+        if (data["agents"].contains("count")) {
+            agent_settings_.count = (std::max)(data["agents"]["count"].get<int>(), 0);
+        }
+        if (data["agents"].contains("rate")) {
+            agent_settings_.rate = (std::max)(data["agents"]["rate"].get<float>(), 1.0f);
+        }
+    }
+
+    // Kontrola existence objektu "textures"
+    if (data.contains("textures")) {
+        if (data["textures"].contains("upload_budget_ms")) {
+            texture_settings_.upload_budget_ms = data["textures"]["upload_budget_ms"];
+        }
+        if (data["textures"].contains("compressed")) {
+            texture_settings_.compressed = data["textures"]["compressed"];
+        }
+        if (data["textures"].contains("cache")) {
+            texture_settings_.cache = data["textures"]["cache"].get<std::string>();
+        }
+    }
+
+    // Kontrola existence objektu "startup"
+    if (data.contains("startup")) {
+        if (data["startup"].contains("progressive")) {
+            startup_settings_.progressive = data["startup"]["progressive"];
+        }
+    }
+
     // Výpis statusu AA
     if (antialiasing_settings_.enabled) {
         std::cout << "Antialiasing je povolen s urovni " << antialiasing_settings_.level << std::endl;
@@ -72,9 +165,86 @@ void App::load_settings() {
     }
 }
 
+// --- Stav načítání ---
+// Výsledky úloh, které čekají na nahrání do GL, čítače etap a zástupci, kteří se mají vyměnit
+struct App::Loading {
+    struct ObjData {
+        std::vector<vertex> vertices;
+        std::vector<GLuint> indices;
+        bool ok = false;
+    };
+    ObjData cube, bunny;
+    JobCounter models, materials, textures, material_build, maze, terrain, audio;
+
+    std::exception_ptr terrain_error;
+    std::vector<vertex> terrain_vertices;
+    std::vector<std::filesystem::path> texture_files;     // bez duplicit: krabice, stěny, atlas terénu
+    std::vector<size_t> wall_files;                        // textury stěn jako indexy do texture_files
+    std::vector<cv::Mat> texture_images;
+    std::vector<TextureUploader::MipChain> texture_mips;  // hotové mip úrovně (ne pro atlas terénu)
+    std::vector<std::exception_ptr> texture_errors;
+    std::vector<TextureUploader::MipChain> material_layers;  // vrstvy pole materiálů (z cache nebo z úlohy material_build)
+    std::exception_ptr material_error;
+
+    uint32_t cube_mesh = 0, bunny_mesh = 0;   // sloty mesh_library, do načtení v nich je krychle
+    GLuint placeholder_texture = 0;           // bílá 1x1, do načtení textur
+    GLuint box_texture = 0;
+    double textures_start = 0.0;              // začátek nahrávání textur přes staging
+    bool models_done = false, textures_uploading = false, textures_done = false, world_built = false;
+};
+
+// BGR/BGRA obrázek jako BGRA (formát stagingu TextureUploader)
+static cv::Mat to_bgra(const cv::Mat& image) {
+    cv::Mat bgra;
+    switch (image.channels()) {
+    case 3:
+        cv::cvtColor(image, bgra, cv::COLOR_BGR2BGRA);
+        break;
+    case 4:
+        bgra = image;
+        break;
+    default:
+        throw std::runtime_error("Nepodorovany pocet channelu v texture:" + std::to_string(image.channels()));
+    }
+    return bgra;
+}
+
+// mip úrovně obrázku na CPU (smí běžet na pracovním vlákně)
+static TextureUploader::MipChain build_mips(const cv::Mat& image) {
+    cv::Mat bgra = to_bgra(image);
+    return TextureUploader::buildMipChain(bgra.data, bgra.cols, bgra.rows, bgra.step);
+}
+
+// velikost mip pyramidy chain, kdyby byla nekomprimovaná (RGBA8)
+static size_t rgba8_bytes(const TextureUploader::MipChain& chain) {
+    size_t sum = 0;
+    for (size_t level = 0; level < chain.levels.size(); ++level) {
+        sum += static_cast<size_t>((std::max)(chain.width >> level, 1)) * (std::max)(chain.height >> level, 1) * 4;
+    }
+    return sum;
+}
+
+// Zástupná krychle (24 vrcholů, 36 indexů) pro modely, které se ještě načítají
+static Model placeholder_cube() {
+    std::vector<vertex> vertices;
+    std::vector<GLuint> indices;
+    const glm::vec3 normals[6] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
+    for (const auto& n : normals) {
+        glm::vec3 u = (n.y != 0.0f) ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+        glm::vec3 v = glm::cross(n, u);
+        GLuint base = static_cast<GLuint>(vertices.size());
+        vertices.push_back({ (n - u - v) * 0.5f, n, {0.0f, 0.0f} });
+        vertices.push_back({ (n + u - v) * 0.5f, n, {1.0f, 0.0f} });
+        vertices.push_back({ (n + u + v) * 0.5f, n, {1.0f, 1.0f} });
+        vertices.push_back({ (n - u + v) * 0.5f, n, {0.0f, 1.0f} });
+        indices.insert(indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+    }
+    return Model("placeholder_cube", vertices, indices);
+}
+
 // --- Konstruktor App ---
 // Inicializace GLFW, vytváření okna a nastavení OpenGL
-App::App() : camera(Camera(glm::vec3(0.0f, 0.0f, 3.0f))) {
+App::App(StartupMode mode) : camera(Camera(glm::vec3(0.0f, 0.0f, 3.0f))) {
     // Načtení nastavení ze souboru JSON
     load_settings();
 
@@ -138,11 +308,214 @@ App::App() : camera(Camera(glm::vec3(0.0f, 0.0f, 3.0f))) {
         exit(EXIT_FAILURE);
     }
 
+    // --- Progresivní start ---
+    // CPU etapy (parsování OBJ, dekódování obrázků, labyrint, výšková mapa a síť terénu, zvuk) běží jako
+    // úlohy na thread_pool. Konstruktor počká jen na shadery a zástupce (krychle místo modelů, bílá
+    // textura 1x1), run() pak hotové etapy nahrává do GL mezi snímky (update_loading). GL volání
+    // zůstávají jen na vlákně s kontextem. Každá etapa se zapíše do startup_timeline.
+    const bool progressive = mode == STARTUP_PROGRESSIVE || (mode == STARTUP_SETTINGS && startup_settings_.progressive);
+    loading_ = std::make_unique<Loading>();
+    Loading& loading = *loading_;
+    thread_pool.setProfiling(true);   // vytížení vláken v titulku okna
+
+    // výšková mapa je nejdelší etapa - jde do fronty první, pracovníci kradou od nejstarších úloh
+    flatten_area = cv::Rect(25, 25, 50, 50);
+    if (terrain_settings_.renderer == TERRAIN_STREAMING) {
+        // Streamování: mapa se jen namapuje, výšky jsou už ve světových jednotkách (--convert-heightmap)
+        terrain_file.open(terrain_settings_.heightmap);
+        std::cout << "Vyskova mapa " << terrain_file.width() << "x" << terrain_file.height() << " (streamovana, dlazdice souboru " << terrain_file.tileSize() << ")" << std::endl;
+    } else {
+        thread_pool.submit([this, &loading]() {
+            try {
+                {
+                    StartupTimeline::Scope stage(startup_timeline, "heightmapa (nacteni)");
+                    // Načtení heightmapy v plné přesnosti (16bitové PNG a float mapy bez schodů po 1/256)
+                    hmap = load_heightmap(terrain_settings_.heightmap);
+
+                    // Normalizace výškové mapy (na rozsah 0-255, stále float)
+                    double min, max;
+                    cv::minMaxLoc(hmap, &min, &max);
+                    std::cout << "Vyskova mapa " << hmap.cols << "x" << hmap.rows << " min hodnota: " << min << ", max hodnota: " << max << std::endl;
+                    cv::normalize(hmap, hmap, 0, 255, cv::NORM_MINMAX);
+                }
+                if (terrain_settings_.renderer == TERRAIN_MESH) {
+                    StartupTimeline::Scope stage(startup_timeline, "heightmapa (sit)");
+                    loading.terrain_vertices = GenHeightMapVertices(hmap, terrain_mesh_step, terrain_settings_.tile_size, flatten_area, flatten_height);
+                }
+            } catch (...) {
+                loading.terrain_error = std::current_exception();
+            }
+        }, &loading.terrain);
+    }
+
+    thread_pool.submit([this, &loading]() {
+        StartupTimeline::Scope stage(startup_timeline, "OBJ cube_triangles_vnt");
+        loading.cube.ok = Model::parse("resources/objects/cube_triangles_vnt.obj", loading.cube.vertices, loading.cube.indices);
+    }, &loading.models);
+    thread_pool.submit([this, &loading]() {
+        StartupTimeline::Scope stage(startup_timeline, "OBJ bunny_tri_vnt");
+        loading.bunny.ok = Model::parse("resources/objects/bunny_tri_vnt.obj", loading.bunny.vertices, loading.bunny.indices);
+    }, &loading.models);
+
+    // Textury: krabice, stěny (všechny ostatní soubory ve složce) a atlas terénu, každá jako vlastní úloha
+    // (dekódování a mip úrovně, do VRAM je po snímcích nahraje texture_uploader). S kompresí se textury
+    // čtou jako hotové bloky BC1/BC3 z cache (DDS). Při prvním startu nebo po změně zdroje se PNG dekóduje,
+    // zkomprimuje a uloží do cache.
+    // Každý soubor jen jednou - stěna ze stejného souboru jako krabice (i ta je ve složce) sdílí její
+    // dekódování, cache i GL texturu
+    loading.texture_files = { std::filesystem::path("resources/textures/box_rgb888.png").lexically_normal() };
+    for (const auto& entry : std::filesystem::directory_iterator("resources/textures")) {
+        if (entry.is_regular_file()) {
+            std::string filename = entry.path().filename().string();
+            if (filename != std::filesystem::path(terrain_settings_.heightmap).filename().string() && filename != "heights.png" && filename != "tex_256.png") {
+                const std::filesystem::path path = entry.path().lexically_normal();
+                auto found = std::find(loading.texture_files.begin(), loading.texture_files.end(), path);
+                loading.wall_files.push_back(static_cast<size_t>(found - loading.texture_files.begin()));
+                if (found == loading.texture_files.end()) {
+                    loading.texture_files.push_back(path);
+                }
+            }
+        }
+    }
+    loading.texture_files.push_back("resources/textures/tex_256.png");
+    loading.texture_images.resize(loading.texture_files.size());
+    loading.texture_mips.resize(loading.texture_files.size());
+    loading.texture_errors.resize(loading.texture_files.size());
+
+    // Pole materiálů z cache: vrstvy textur a 5 vrstev terénu z atlasu. Když platí, obrázky se pro něj
+    // nedekódují vůbec - úlohy textur proto běží až po této.
+    if (texture_settings_.compressed) {
+        const size_t layer_count = loading.texture_files.size() - 1 + 5;
+        thread_pool.submit([this, layer_count, &loading]() {
+            const std::filesystem::path path = texture_settings_.cache / "materials.dds";
+            if (!DdsFile::isFresh(path, loading.texture_files)) {
+                return;
+            }
+            StartupTimeline::Scope stage(startup_timeline, "pole materialu (cache)");
+            try {
+                std::vector<TextureUploader::MipChain> layers = DdsFile::read(path);
+                if (layers.size() == layer_count) {
+                    loading.material_layers = std::move(layers);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Cache textur: " << e.what() << std::endl;
+            }
+        }, &loading.materials);
+    }
+
+    for (size_t i = 0; i < loading.texture_files.size(); ++i) {
+        thread_pool.submitAfter(loading.materials, [this, i, &loading]() {
+            const std::filesystem::path& file = loading.texture_files[i];
+            StartupTimeline::Scope stage(startup_timeline, "textura " + file.filename().string());
+            try {
+                // atlas terénu jde jen do pole materiálů, mip úrovně vrstev se počítají až tam
+                const bool atlas = i + 1 == loading.texture_files.size();
+                const std::filesystem::path cache = texture_settings_.cache / (file.stem().string() + ".dds");
+                if (!atlas && texture_settings_.compressed && DdsFile::isFresh(cache, { file })) {
+                    try {
+                        loading.texture_mips[i] = std::move(DdsFile::read(cache).front());
+                    } catch (const std::exception& e) {
+                        std::cerr << "Cache textur: " << e.what() << std::endl;
+                    }
+                }
+
+                // obrázek potřebuje stavba pole materiálů (bez cache) a textura, která v cache není
+                const bool has_mips = !loading.texture_mips[i].levels.empty();
+                if (loading.material_layers.empty() || (!atlas && !has_mips)) {
+                    loading.texture_images[i] = load_texture(file);
+                }
+                if (!atlas && !has_mips) {
+                    loading.texture_mips[i] = build_mips(loading.texture_images[i]);
+                    if (texture_settings_.compressed) {
+                        StartupTimeline::Scope encode(startup_timeline, "BCn komprese " + file.filename().string());
+                        TextureUploader::MipChain& mips = loading.texture_mips[i];
+                        mips = BcEncoder::compress(mips, BcEncoder::chooseFormat(mips));
+                        try {
+                            DdsFile::write(cache, { mips });
+                        } catch (const std::exception& e) {
+                            std::cerr << "Cache textur: " << e.what() << std::endl;
+                        }
+                    }
+                }
+            } catch (...) {
+                loading.texture_errors[i] = std::current_exception();
+            }
+        }, &loading.textures);
+    }
+
+    // Vrstvy pole materiálů z dekódovaných textur (textury v pořadí souborů, pak vrstvy terénu z atlasu) -
+    // sjednocení velikosti a mip úrovně jsou úloha, aby stavba pole nezdržela snímek
+    thread_pool.submitAfter(loading.textures, [this, &loading]() {
+        if (!loading.material_layers.empty()) {
+            return;
+        }
+        for (const auto& error : loading.texture_errors) {
+            if (error) {
+                return;   // chybu textury vyhodí update_loading
+            }
+        }
+        StartupTimeline::Scope stage(startup_timeline, "pole materialu (vrstvy)");
+        try {
+            std::vector<cv::Mat> images(loading.texture_images.begin(), loading.texture_images.end() - 1);
+            for (cv::Mat& tile : terrain_tiles(loading.texture_images.back())) {
+                images.push_back(std::move(tile));
+            }
+            std::vector<TextureUploader::MipChain> layers = build_material_layers(images);
+
+            // první start nebo zastaralá cache: komprese vrstev a zápis materials.dds tady, ne na GL vlákně
+            if (texture_settings_.compressed) {
+                StartupTimeline::Scope encode(startup_timeline, "BCn komprese pole materialu");
+                // pole má jeden formát: BC3, když má alfu aspoň jedna vrstva, jinak BC1
+                GLenum format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                for (const auto& layer : layers) {
+                    if (BcEncoder::chooseFormat(layer) == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) {
+                        format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                    }
+                }
+                thread_pool.parallelFor(layers.size(), 1, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        layers[i] = BcEncoder::compress(layers[i], format);
+                    }
+                });
+                try {
+                    DdsFile::write(texture_settings_.cache / "materials.dds", layers);
+                } catch (const std::exception& e) {
+                    std::cerr << "Cache textur: " << e.what() << std::endl;
+                }
+            }
+            loading.material_layers = std::move(layers);
+        } catch (...) {
+            loading.material_error = std::current_exception();
+        }
+    }, &loading.material_build);
+
+    // Generace mapy labyrintu
+    maze_map = cv::Mat(10, 25, CV_8U);
+    thread_pool.submit([this]() {
+        StartupTimeline::Scope stage(startup_timeline, "labyrint");
+        genLabyrinth(maze_map);
+    }, &loading.maze);
+
+    // Zvuk - inicializace enginu a dekódování WAV do paměti (MA_SOUND_FLAG_DECODE)
+    thread_pool.submit([this]() {
+        StartupTimeline::Scope stage(startup_timeline, "zvuk");
+        if (ma_engine_init(NULL, &engine) != MA_SUCCESS) {
+            printf("Selhala inicializace sound enginu.\n");
+        }
+        if (ma_sound_init_from_file(&engine, "resources/audio/jump_male.wav", MA_SOUND_FLAG_DECODE, NULL, NULL, &jump_sound) != MA_SUCCESS) {
+            printf("Selhalo nacteni zvuku skakani.\n");
+        }
+    }, &loading.audio);
+
     // --- Nastavení shaderů a světel ---
     // Načtení a kompilace shaderů
+    double gl_start = startup_timeline.now();
     lighting_shader = ShaderProgram("resources/shaders/phong.vert", "resources/shaders/phong.frag");
     lamp_shader = ShaderProgram("resources/shaders/basic.vert", "resources/shaders/basic.frag");
     transparent_shader = ShaderProgram("resources/shaders/phong.vert", "resources/shaders/transparent.frag");
+    mdi_shader = ShaderProgram("resources/shaders/phong_mdi.vert", "resources/shaders/phong_mdi.frag");
+    agent_shader = ShaderProgram("resources/shaders/agent.vert", "resources/shaders/phong.frag");
+    startup_timeline.add("GL shadery", gl_start, startup_timeline.now());
 
     // Nastavení směrového světla
     dir_light.direction = glm::vec3(-0.2f, -1.0f, -0.3f);
@@ -223,92 +596,47 @@ App::App() : camera(Camera(glm::vec3(0.0f, 0.0f, 3.0f))) {
     spot_light.cutOff = glm::cos(glm::radians(12.5f)); // Vnitřní úhel kužele
     spot_light.outerCutOff = glm::cos(glm::radians(15.0f)); // Vnější úhel kužele
 
-    // --- Načítání modelů a textur ---
-    // Načtení modelu kostky a textury
-    Model cube_model("resources/objects/cube_triangles_vnt.obj");
-    light_cube_model = cube_model;
-    GLuint box_texture = textureInit("resources/textures/box_rgb888.png");
-    cube_model.setTexture(box_texture);
-
-
+    // Staging pro textury (kruh trvale namapovaných bufferů)
+    TextureUploader::Settings upload;
+    upload.upload_budget_ms = texture_settings_.upload_budget_ms;
+    texture_uploader.init(upload);
+
+    // --- Zástupci do načtení ---
+    // Entity od začátku odkazují na své sloty v mesh_library a na texturu - update_loading v nich
+    // vymění zástupce za načtená data, entity ani fronta vykreslování o výměně neví
+    gl_start = startup_timeline.now();
+    cv::Mat placeholder_image(1, 1, CV_8UC4, cv::Scalar(255, 255, 255, 255));
+    loading.placeholder_texture = gen_tex(placeholder_image);
+    loading.cube_mesh = add_mesh(placeholder_cube());
+    loading.bunny_mesh = add_mesh(placeholder_cube());
+    light_cube_model = mesh_library[loading.cube_mesh];
+    startup_timeline.add("GL zastupci", gl_start, startup_timeline.now());
 
     // Vytvoření průhledných kostek
-    Model transparent_cube1 = cube_model;
-    transparent_cube1.transparent = true;
-    transparent_cube1.diffuse_color = glm::vec4(1.0f, 0.0f, 0.0f, 0.2f); // Červená s 20% průhledností
     glm::mat4 model_m = glm::mat4(1.0f);
     model_m = glm::translate(model_m, glm::vec3(40.0f, 101.0f, 40.0f));
     model_m = glm::scale(model_m, glm::vec3(2.0f));
-    transparent_cube1.setMatrix(model_m);
-    scene["transparent_cube1"] = transparent_cube1;
+    transparent_cube1 = scene.create(loading.cube_mesh, model_m, { loading.placeholder_texture, glm::vec4(1.0f, 0.0f, 0.0f, 0.2f) }, // Červená s 20% průhledností
+                                     ENTITY_TRANSPARENT | ENTITY_DYNAMIC); // rotuje každý snímek
 
-    Model transparent_cube2 = cube_model;
-    transparent_cube2.transparent = true;
-    transparent_cube2.diffuse_color = glm::vec4(0.0f, 1.0f, 0.0f, 0.4f); // Zelená s 40% průhledností
     model_m = glm::mat4(1.0f);
     model_m = glm::translate(model_m, glm::vec3(43.0f, 101.0f, 40.0f));
     model_m = glm::scale(model_m, glm::vec3(2.0f));
-    transparent_cube2.setMatrix(model_m);
-    scene["transparent_cube2"] = transparent_cube2;
+    scene.create(loading.cube_mesh, model_m, { loading.placeholder_texture, glm::vec4(0.0f, 1.0f, 0.0f, 0.4f) }, ENTITY_TRANSPARENT); // Zelená s 40% průhledností
 
-    Model transparent_cube3 = cube_model;
-    transparent_cube3.transparent = true;
-    transparent_cube3.diffuse_color = glm::vec4(0.0f, 0.0f, 1.0f, 0.6f); // Modrá s 60% průhledností
     model_m = glm::mat4(1.0f);
     model_m = glm::translate(model_m, glm::vec3(46.0f, 101.0f, 40.0f));
     model_m = glm::scale(model_m, glm::vec3(2.0f));
-    transparent_cube3.setMatrix(model_m);
-    scene["transparent_cube3"] = transparent_cube3;
+    scene.create(loading.cube_mesh, model_m, { loading.placeholder_texture, glm::vec4(0.0f, 0.0f, 1.0f, 0.6f) }, ENTITY_TRANSPARENT); // Modrá s 60% průhledností
 
-    // Načtení modelu králíčka
-    Model bunny_model("resources/objects/bunny_tri_vnt.obj");
-    bunny_model.setTexture(box_texture);
+    // Králíček
     glm::mat4 bunny_matrix = glm::mat4(1.0f);
     bunny_matrix = glm::translate(bunny_matrix, glm::vec3(50.0f, 101.0f, 40.0f));
     bunny_matrix = glm::scale(bunny_matrix, glm::vec3(0.5f));
-    bunny_model.setMatrix(bunny_matrix);
-    scene["bunny"] = bunny_model;
+    scene.create(loading.bunny_mesh, bunny_matrix, { loading.placeholder_texture }, 0);
 
-
-    // Načtení textur stěn
-    wall_textures.clear();
-    for (const auto& entry : std::filesystem::directory_iterator("resources/textures")) {
-        if (entry.is_regular_file()) {
-            std::string filename = entry.path().filename().string();
-            if (filename != "heights.png" && filename != "tex_256.png") {
-                wall_textures.push_back(textureInit(entry.path()));
-            }
-        }
-    }
-
-    // --- Generování labyrintu a heightmapy ---
-    // Generace mapy labyrintu
-    maze_map = cv::Mat(10, 25, CV_8U);
-    genLabyrinth(maze_map);
-
-    // Definování oblasti pro zplacatění na heightmapě
-    flatten_area = cv::Rect(25, 25, 50, 50);
-
-    // Načtení obrázku heightmapy
-    hmap = cv::imread("resources/textures/heights.png", cv::IMREAD_GRAYSCALE); // nacteni stupni sedi
-    if (hmap.empty()) {
-        throw std::runtime_error("Selhalo nacteni heightmapy.");
-    }
-
-    // Normalizace výškové mapy (na rozsah 0-255)
-    double min, max;
-    cv::minMaxLoc(hmap, &min, &max);
-    std::cout << "Vyskova mapa min hodnota: " << min << ", max hodnota: " << max << std::endl;
-    cv::normalize(hmap, hmap, 0, 255, cv::NORM_MINMAX);
-
-    // Generace modelu vyskove mapy
-    Model height_map_model = GenHeightMap(hmap, 1, flatten_area, flatten_height);
-    height_map_model.setTexture(textureInit("resources/textures/tex_256.png"));
-    scene["height_map"] = height_map_model;
-
-    // Načtení modelu "sten" labyrintu
-        Model wall_model("resources/objects/cube_triangles_vnt.obj");
-        scene["wall"] = wall_model;
+    // Nastavení pozice kamery
+    camera.Position = glm::vec3(43.0f, 103.0f, 60.0f);
 
     // --- Ostatní nastavení ---
     // Nastavení počáteční pozice myši
@@ -329,15 +657,232 @@ App::App() : camera(Camera(glm::vec3(0.0f, 0.0f, 3.0f))) {
         glEnable(GL_MULTISAMPLE);
     }
 
-    // Inicializace sound enginu
-    if (ma_engine_init(NULL, &engine) != MA_SUCCESS) {
-        printf("Selhala inicializace sound enginu.\n");
+    // Bez progresivního startu (startup.progressive = false) se vše načte ještě v konstruktoru
+    if (!progressive) {
+        for (JobCounter* counter : { &loading.models, &loading.textures, &loading.material_build, &loading.terrain, &loading.maze, &loading.audio }) {
+            thread_pool.wait(*counter);
+        }
+        while (!update_loading()) {
+            texture_uploader.flush();
+        }
+    }
+
+    startup_metrics_.constructor_ms = startup_timeline.now();
+}
+
+// --- Progresivní načítání ---
+// Volá se na začátku snímku: hotové etapy úloh nahraje do GL a vymění za zástupce. Za snímek se
+// nahraje nejvýš jedna GL etapa (modely, textury, svět), aby se jejich cena rozložila do více snímků.
+// Vrací true, když je načtené všechno.
+bool App::update_loading() {
+    if (!loading_) {
+        return true;
+    }
+    Loading& loading = *loading_;
+
+    // wait() na hotový čítač nic nezpracuje, jen počká, až poslední úloha pustí jeho zámek
+    if (!audio_loaded_ && loading.audio.done()) {
+        thread_pool.wait(loading.audio);
+        audio_loaded_ = true;
     }
 
-    // Načtení zvuku skoku
-    if (ma_sound_init_from_file(&engine, "resources/audio/jump_male.wav", 0, NULL, NULL, &jump_sound) != MA_SUCCESS) {
-        printf("Selhalo nacteni zvuku skakani.\n");
+    if (!loading.models_done && loading.models.done()) {
+        thread_pool.wait(loading.models);
+        double gl_start = startup_timeline.now();
+        if (!loading.cube.ok || !loading.bunny.ok) {
+            std::cerr << "Failed to load model: " << (loading.cube.ok ? "bunny_tri_vnt.obj" : "cube_triangles_vnt.obj") << std::endl;
+        }
+        // sdílená geometrie - entity na ni odkazují indexem do mesh_library
+        mesh_library[loading.cube_mesh].clear();
+        mesh_library[loading.cube_mesh] = Model("cube_triangles_vnt", loading.cube.vertices, loading.cube.indices);
+        light_cube_model = mesh_library[loading.cube_mesh];
+        mesh_library[loading.bunny_mesh].clear();
+        mesh_library[loading.bunny_mesh] = Model("bunny_tri_vnt", loading.bunny.vertices, loading.bunny.indices);
+        loading.cube = {};
+        loading.bunny = {};
+        loading.models_done = true;
+        startup_timeline.add("GL modely", gl_start, startup_timeline.now());
+    } else if (!loading.textures_uploading && loading.textures.done()) {
+        thread_pool.wait(loading.textures);
+        loading.textures_start = startup_timeline.now();
+        for (const auto& error : loading.texture_errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        // Textury v pořadí souborů (pořadí vrstev v poli materiálů nezávisí na tom, co se dekódovalo dřív),
+        // data jdou do fronty texture_uploader
+        std::vector<GLuint> textures;
+        for (size_t i = 0; i + 1 < loading.texture_mips.size(); ++i) {
+            textures.push_back(textureInit(std::move(loading.texture_mips[i])));
+        }
+        loading.box_texture = textures.front();
+        wall_textures.clear();
+        for (size_t file : loading.wall_files) {
+            wall_textures.push_back(textures[file]);
+        }
+        loading.texture_mips.clear();
+        loading.textures_uploading = true;
+    } else if (loading.textures_uploading && !loading.textures_done && texture_uploader.pending() == 0) {
+        // všechna data zadaná - zástupce lze vyměnit
+        for (auto& entity_material : scene.materials) {
+            if (entity_material.texture == loading.placeholder_texture) {
+                entity_material.texture = loading.box_texture;
+            }
+        }
+        glDeleteTextures(1, &loading.placeholder_texture);
+        loading.textures_done = true;
+        startup_timeline.add("GL textury (staging)", loading.textures_start, startup_timeline.now());
+    } else if (!loading.world_built && loading.models_done && loading.textures_done && loading.material_build.done() && loading.maze.done() && loading.terrain.done()) {
+        thread_pool.wait(loading.material_build);
+        thread_pool.wait(loading.maze);
+        thread_pool.wait(loading.terrain);
+        if (loading.terrain_error) {
+            std::rethrow_exception(loading.terrain_error);
+        }
+        if (loading.material_error) {
+            std::rethrow_exception(loading.material_error);
+        }
+        load_world(loading);
+        loading.world_built = true;
+    } else if (loading.world_built && !world_loaded_ && texture_uploader.pending() == 0) {
+        // vrstvy pole materiálů nahrané - statická dávka se může kreslit
+        world_loaded_ = true;
     }
+
+    if (!world_loaded_ || !audio_loaded_) {
+        return false;
+    }
+    startup_metrics_.loaded_ms = startup_timeline.now();
+    startup_timeline.print(std::cout, startup_metrics_.loaded_ms);
+    std::cout << "Vse nacteno za " << startup_metrics_.loaded_ms << " ms (" << startup_metrics_.loading_frames << " snimku behem nacitani)" << std::endl;
+    std::cout << "Textury: " << texture_memory_.bytes / 1024 << " KB VRAM (RGBA8 by bylo " << texture_memory_.rgba8_bytes / 1024 << " KB)" << std::endl;
+    loading_.reset();
+    return true;
+}
+
+// Terén, labyrint, fyzika, agenti a statická dávka - potřebují modely, textury, mapu labyrintu i terén
+void App::load_world(Loading& loading) {
+    double gl_start = startup_timeline.now();
+
+    // Dlaždice výškové mapy - každá dlaždice je entita s vlastním AABB (culling po dlaždicích)
+    // Textury terénu jsou vrstvy pole materiálů, vybírají se podle výšky ve fragment shaderu
+    terrain_layer = add_terrain_layers();
+    loading.texture_images.clear();
+    if (terrain_settings_.renderer == TERRAIN_TESSELLATION) {
+        // Teselace: na GPU jde jen výšková mapa jako textura, vrcholy vzniknou až v teselačních shaderech
+        cv::rectangle(hmap, flatten_area, cv::Scalar(flatten_height), -1);
+        terrain_tess_shader = ShaderProgram("resources/shaders/terrain_tess.vert", "resources/shaders/terrain_tess.tesc",
+                                            "resources/shaders/terrain_tess.tese", "resources/shaders/phong_mdi.frag");
+        terrain_tessellation.init(hmap.ptr<float>(), hmap.cols, hmap.rows, hmap.step1(), terrain_settings_.tile_size);
+        terrain_stats_.tiles = terrain_tessellation.patchCount();
+        std::cout << "Teren (teselace): " << terrain_tessellation.patchCount() << " patchu, " << terrain_tessellation.gpuBytes() / 1024 << " KB VRAM" << std::endl;
+    } else if (terrain_settings_.renderer == TERRAIN_VERTEX_PULLING) {
+        // Vertex pulling: stejná mřížka jako dlaždice z GenHeightMapTiles, ale vrcholy skládá vertex shader z textury
+        cv::rectangle(hmap, flatten_area, cv::Scalar(flatten_height), -1);
+        terrain_pull_shader = ShaderProgram("resources/shaders/terrain_pull.vert", "resources/shaders/phong_mdi.frag");
+        terrain_pulling.init(hmap.ptr<float>(), hmap.cols, hmap.rows, hmap.step1(), terrain_settings_.tile_size);
+        terrain_stats_.tiles = terrain_pulling.tileCount();
+        std::cout << "Teren (vertex pulling): " << terrain_pulling.tileCount() << " dlazdic, " << terrain_pulling.gpuBytes() / 1024 << " KB VRAM" << std::endl;
+    } else if (terrain_settings_.renderer == TERRAIN_STREAMING) {
+        // Dlaždice kolem kamery čtou a generují pracovní vlákna, zplacatění labyrintu se aplikuje na přečtené okno
+        TerrainStreamer::Settings stream;
+        stream.tile_size = static_cast<unsigned int>(terrain_settings_.tile_size);
+        stream.radius = terrain_settings_.stream_radius;
+        stream.workers = static_cast<unsigned int>(terrain_settings_.stream_workers);
+        stream.upload_budget_ms = terrain_settings_.stream_budget_ms;
+        const cv::Rect area = flatten_area;
+        const float height = flatten_height;
+        terrain_streamer.init(terrain_file, stream, terrain_layer, [area, height](int x0, int z0, int w, int h, float* heights, size_t row_stride) {
+            cv::Mat window(h, w, CV_32F, heights, row_stride * sizeof(float));
+            cv::rectangle(window, area - cv::Point(x0, z0), cv::Scalar(height), -1);
+        });
+        terrain_stats_.tiles = terrain_streamer.stats().capacity;
+        std::cout << "Teren (streamovani): " << terrain_streamer.stats().capacity << " slotu po " << terrain_streamer.tileBytes() / 1024 << " KB, "
+                  << terrain_streamer.gpuBytes() / (1024 * 1024) << " MB VRAM, " << terrain_settings_.stream_workers << " vlakna" << std::endl;
+    } else {
+        std::vector<Model> terrain_tiles = GenHeightMapTiles(hmap.cols, hmap.rows, terrain_mesh_step, terrain_settings_.tile_size, loading.terrain_vertices);
+        loading.terrain_vertices.clear();
+        for (auto& tile : terrain_tiles) {
+            scene.create(add_mesh(tile), glm::mat4(1.0f), {}, ENTITY_TERRAIN);
+        }
+        terrain_stats_.tiles = terrain_tiles.size();
+        std::cout << "Teren: " << terrain_tiles.size() << " dlazdic po " << terrain_settings_.tile_size << "x" << terrain_settings_.tile_size << " ctyruhelnicich" << std::endl;
+
+        // LOD terénu (vzory indexů se přidají do dávky v build_static_batch)
+        const unsigned int tile_extent = terrain_settings_.tile_size * terrain_mesh_step;
+        init_terrain_lod((hmap.cols - terrain_mesh_step + tile_extent - 1) / tile_extent, (hmap.rows - terrain_mesh_step + tile_extent - 1) / tile_extent);
+    }
+
+    startup_timeline.add("GL teren", gl_start, startup_timeline.now());
+
+    // Dotazy na terén nad finální (zplacatělou) mapou - hmap se už nemění
+    if (!hmap.empty()) {
+        terrain_field = TerrainHeightField(hmap.ptr<float>(), hmap.cols, hmap.rows, hmap.step1());
+    }
+
+    // Fyzika hráče - pevný krok, swept sphere nad terrain_field (při streamování jen výška pod hráčem,
+    // dokud streamer nenačte dlaždici pod hráčem, hráč stojí) a stěny labyrintu jako boxy kostek ze scény
+    // (buňka '#' maze_map)
+    physics_clock = FixedTimestep(1.0 / physics_settings_.rate, physics_settings_.max_steps);
+    player_physics.setGround({ &terrain_field,
+                               [this](float x, float z) { return getTerrainHeight(x, z); },
+                               [this](float x, float z) { return getTerrainNormal(x, z); },
+                               [this](float x, float z) { return terrain_ready(x, z); } });
+    maze_collider = MazeCollider(maze_map.ptr<uint8_t>(), maze_map.cols, maze_map.rows, maze_map.step, '#',
+                                 glm::vec3(flatten_area.x, flatten_height, flatten_area.y), 1.0f, flatten_height - 0.5f, flatten_height + 0.5f);
+    player_physics.setWalls(&maze_collider);
+
+    // Agenti - náhodně po volných buňkách oblasti labyrintu, vlastní pevný krok (agents.rate)
+    agent_clock = FixedTimestep(1.0 / agent_settings_.rate, physics_settings_.max_steps);
+    agents.setWorld(&terrain_field, &maze_collider);
+    if (terrain_field.valid() && agent_settings_.count > 0) {
+        std::default_random_engine agent_rng(44);
+        std::uniform_real_distribution<float> agent_x(static_cast<float>(flatten_area.x), static_cast<float>(flatten_area.x + flatten_area.width - 1));
+        std::uniform_real_distribution<float> agent_z(static_cast<float>(flatten_area.y), static_cast<float>(flatten_area.y + flatten_area.height - 1));
+        std::uniform_real_distribution<float> agent_angle(0.0f, 6.2831853f);
+        agents.reserve(agent_settings_.count);
+        while (agents.size() < static_cast<size_t>(agent_settings_.count)) {
+            const glm::vec3 pos(agent_x(agent_rng), 0.0f, agent_z(agent_rng));
+            if (maze_collider.overlapsCapsule(glm::vec3(pos.x, flatten_height, pos.z), agents.settings().height, agents.settings().radius)) {
+                continue;
+            }
+            const float a = agent_angle(agent_rng);
+            agents.spawn(glm::vec3(pos.x, terrain_field.height(pos.x, pos.z), pos.z), glm::vec2(std::cos(a), std::sin(a)));
+        }
+        agent_renderer.init(mesh_library[loading.bunny_mesh].meshes.front(), 0.5f);
+        agent_texture = loading.box_texture;
+        std::cout << "Agenti: " << agents.size() << ", " << agent_settings_.rate << " Hz, " << thread_pool.threadCount() << " vlaken" << std::endl;
+    }
+
+    // Stěny labyrintu - jedna entita na buňku, textura se vybere náhodně při vytvoření
+    std::random_device r;
+    std::default_random_engine e1(r());
+    std::uniform_int_distribution<int> uniform_tex(0, (std::max)(static_cast<int>(wall_textures.size()) - 1, 0));
+    for (int y = 0; y < maze_map.rows; ++y) {
+        for (int x = 0; x < maze_map.cols; ++x) {
+            if (getmap(maze_map, x, y) == '#') {
+                glm::mat4 wall_matrix = glm::translate(glm::mat4(1.0f), glm::vec3(flatten_area.x + x, flatten_height, flatten_area.y + y));
+                if (wall_textures.empty()) {
+                    scene.create(loading.cube_mesh, wall_matrix, {}, ENTITY_WALL | ENTITY_HIDDEN);
+                } else {
+                    scene.create(loading.cube_mesh, wall_matrix, { wall_textures[uniform_tex(e1)] }, ENTITY_WALL);
+                }
+            }
+        }
+    }
+
+    // Stavba BVH nad statickými objekty
+    gl_start = startup_timeline.now();
+    build_static_bvh();
+
+    // Statická geometrie do jedné dávky pro glMultiDrawElementsIndirect
+    build_material_array(std::move(loading.material_layers));
+    build_static_batch();
+    if (culling_settings_.gpu) {
+        gpu_culling.init(static_batch.drawCount());
+    }
+    startup_timeline.add("BVH + MDI davka", gl_start, startup_timeline.now());
 }
 
 // --- Přepínání fullscreen/window ---
@@ -390,64 +935,100 @@ void App::save_settings() {
 
 // --- Destruktor aplikace ---
 App::~App() {
+    // úlohy načítání zapisují do App - před úklidem musí doběhnout
+    if (loading_) {
+        for (JobCounter* counter : { &loading_->models, &loading_->materials, &loading_->textures, &loading_->material_build, &loading_->terrain, &loading_->maze, &loading_->audio }) {
+            thread_pool.wait(*counter);
+        }
+    }
     save_settings();
+    terrain_streamer.clear();
+    texture_uploader.clear();
+    agent_renderer.clear();
     ma_engine_uninit(&engine);
     glfwDestroyWindow(window);
     glfwTerminate();
 }
 
 // --- Main loop aplikace ---
-void App::run() {
+void App::run(bool exit_when_loaded) {
     double last_time = glfwGetTime();
     int nb_frames = 0;
 
-    float last_frame = 0.0f;
+    double last_frame = glfwGetTime();
+    player.position = camera.Position;
+    player_previous = player;
     glm::vec3 light_pos; 
     glm::vec3 light_pos2;
+    bool first_frame_shown = false;
 
     while (!glfwWindowShouldClose(window)) {
         // --- FPS counter a aktualizace titlu okna ---
         double current_time = glfwGetTime();
         nb_frames++;
         if (current_time - last_time >= 1.0) {
+            // průměrný počet vláken plánovače, která za poslední sekundu pracovala na úlohách
+            double busy_ms = 0.0;
+            for (const auto& thread : thread_pool.stats()) {
+                busy_ms += thread.busy_ms;
+            }
             std::string title = window_settings_.title + " | FPS: " + std::to_string(nb_frames) + 
                                 " | VSync (F12): " + (window_settings_.vsync ? "Zap" : "Vyp") + 
                                 " | Fullscreen (F10): " + (window_settings_.fullscreen ? "Zap" : "Vyp") + 
                                 " | AA (F11): " + (antialiasing_settings_.enabled ? "Zap (" + std::to_string(antialiasing_settings_.level) + "x)" : "Vyp") + 
-                                " | Pozice: (" + std::to_string(camera.Position.x) + ", " + std::to_string(camera.Position.y) + ", " + std::to_string(camera.Position.z) + ")";
+                                " | Agenti: " + std::to_string(agent_renderer.instanceCount()) + "/" + std::to_string(agents.size()) +
+                                " | Vlakna: " + std::to_string(busy_ms / (1000.0 * (current_time - last_time))) + "/" + std::to_string(thread_pool.threadCount()) +
+                                " | Culling: " + std::to_string(culling_stats_.visible) + "/" + std::to_string(culling_stats_.tested) +
+                                " | Snimek: " + std::to_string(1000.0 * (current_time - last_time) / nb_frames) + " ms" +
+                                " | Teren: " + std::to_string(terrain_stats_.visible_tiles) + "/" + std::to_string(terrain_stats_.tiles) + " dlazdic, " +
+                                std::to_string(terrain_stats_.triangles) + " troj. (bez LOD " + std::to_string(terrain_stats_.full_triangles) + ")" +
+                                (terrain_settings_.renderer == TERRAIN_STREAMING ?
+                                    " | Stream: " + std::to_string(terrain_streamer.stats().resident) + " rez., " + std::to_string(terrain_streamer.stats().pending()) + " ceka, " +
+                                    std::to_string(terrain_stats_.stream_bytes / (1024.0 * 1024.0) / nb_frames) + " MB/snimek (max " + std::to_string(terrain_stats_.stream_peak_bytes / (1024.0 * 1024.0)) + ")" : "") +
+                                (culling_settings_.gpu ? " | GPU culling: " + std::to_string(gpu_culling.readVisibleCount()) + "/" + std::to_string(static_batch.drawCount()) : "") +
+                                " | Zmeny stavu: " + std::to_string(render_queue.stats().state_changes) + " (bez razeni " + std::to_string(render_queue.stats().naive_state_changes) + ")" +
+                                " | Pozice: (" + std::to_string(camera.Position.x) + ", " + std::to_string(camera.Position.y) + ", " + std::to_string(camera.Position.z) + ")" +
+                                (loading_ ? " | Nacitani..." : "");
             glfwSetWindowTitle(window, title.c_str());
+            thread_pool.resetStats();
+            terrain_stats_.stream_bytes = 0;
+            terrain_stats_.stream_peak_bytes = 0;
             nb_frames = 0;
             last_time += 1.0;
         }
 
         // --- Výpočet delta time ---
-        float current_frame = static_cast<float>(glfwGetTime());
-        float delta_time = current_frame - last_frame;
+        double current_frame = glfwGetTime();
+        double delta_time = current_frame - last_frame;
         last_frame = current_frame;
 
         // Zpracování inputu od uživatele
-        process_input(delta_time);
+        process_input();
 
-        // --- Aktualizace fyziky ---
-        const float gravity = -20.0f; // -20 se mi líbí nejvíc
-        const float player_height = 2.0f; // Výška hráče
+        // Textury ze stagingu (rozpočet textures.upload_budget_ms) a hotové etapy načítání do GL
+        // (výměna zástupců za načtená data)
+        texture_uploader.upload();
+        const bool loaded = update_loading();
 
-        // Gravitace pracuje
-        if (!camera_on_ground) {
-            camera_velocity.y += gravity * delta_time;
+        // --- Aktualizace fyziky ---
+        // Pevný krok (physics.rate): dráha nezávisí na FPS a po záseku proběhne nejvýš physics.max_steps
+        // kroků. Kamera se vykresluje interpolovaná mezi posledními dvěma kroky. Bez terénu a labyrintu
+        // (během načítání) hráč stojí a jen se rozhlíží.
+        const unsigned int physics_steps = world_loaded_ ? physics_clock.advance(delta_time) : 0;
+        for (unsigned int i = 0; i < physics_steps; ++i) {
+            player_previous = player;
+            if (player_physics.step(player, player_input, static_cast<float>(physics_clock.step())) && audio_loaded_) {
+                ma_sound_seek_to_pcm_frame(&jump_sound, 0);
+                ma_sound_start(&jump_sound);
+            }
+            player_input.jump = false;
         }
+        camera.Position = glm::mix(player_previous.position, player.position, physics_clock.alpha());
 
-        // Aktualizace pozice podle rychlosti
-        camera.Position += camera_velocity * delta_time;
-
-        // Kontrola kolize se zemí
-        float terrainHeight = getTerrainHeight(camera.Position.x, camera.Position.z);
-        if (camera.Position.y < terrainHeight + player_height) {
-            camera.Position.y = terrainHeight + player_height;
-            camera_velocity.y = 0;
-            camera_on_ground = true;
-        } else {
-            camera_on_ground = false;
+        // Agenti - bloky po AgentSystem::CHUNK paralelně na thread_pool
+        const unsigned int agent_steps = world_loaded_ ? agent_clock.advance(delta_time) : 0;
+        for (unsigned int i = 0; i < agent_steps; ++i) {
+            agents.update(static_cast<float>(agent_clock.step()), &thread_pool);
         }
 
         // --- Vykreslování ---
@@ -459,14 +1040,6 @@ void App::run() {
         update_projection_matrix();
         view_matrix = camera.GetViewMatrix();
 
-        // --- Nastavení uniform ---
-        lighting_shader.activate();
-        lighting_shader.setUniform("uP_m", projection_matrix);
-        lighting_shader.setUniform("uV_m", view_matrix);
-        lighting_shader.setUniform("u_view_pos", camera.Position);
-        lighting_shader.setUniform("material.diffuse", 0);
-        lighting_shader.setUniform("material.shininess", material.shininess);
-
         // --- Směrového světlo ---
         glm::vec3 scene_center = glm::vec3(flatten_area.x + flatten_area.width / 2.0f, 0.0f, flatten_area.y + flatten_area.height / 2.0f);
         float radius = 150.0f;
@@ -480,11 +1053,6 @@ void App::run() {
         float light_z2 = scene_center.z + cos(glfwGetTime() * sun_rotation_speed + 3.14159f) * radius;
         light_pos2 = glm::vec3(light_x2, 301.0f, light_z2);
 
-        lighting_shader.setUniform("dirLight.direction", dir_light.direction);
-        lighting_shader.setUniform("dirLight.ambient", dir_light.ambient);
-        lighting_shader.setUniform("dirLight.diffuse", dir_light.diffuse);
-        lighting_shader.setUniform("dirLight.specular", dir_light.specular);
-
         // --- Pohyb bodových světel ---
         float amplitude = 2.0f;
         float speed = 2.0f;
@@ -492,124 +1060,152 @@ void App::run() {
             point_lights[i].position.y = 102.0f + sin(glfwGetTime() * speed + i) * amplitude;
         }
 
-        // --- Nastavení bodových světel ---
-        for (int i = 0; i < NR_POINT_LIGHTS; i++)
-        {
-            std::string base = "pointLights[" + std::to_string(i) + "]";
-            lighting_shader.setUniform(base + ".position", point_lights[i].position);
-            lighting_shader.setUniform(base + ".ambient", point_lights[i].ambient);
-            lighting_shader.setUniform(base + ".diffuse", point_lights[i].diffuse);
-            lighting_shader.setUniform(base + ".specular", point_lights[i].specular);
-            lighting_shader.setUniform(base + ".constant", point_lights[i].constant);
-            lighting_shader.setUniform(base + ".linear", point_lights[i].linear);
-            lighting_shader.setUniform(base + ".quadratic", point_lights[i].quadratic);
-        }
-
-        // --- Nastavení kuželového světla (čelenky) ---
+        // --- Kuželové světlo (čelenka) ---
         spot_light.position = camera.Position; // Pozice kamery
         spot_light.direction = camera.Front; // Kouká stejně jako hráč
-        lighting_shader.setUniform("spotLight.position", spot_light.position);
-        lighting_shader.setUniform("spotLight.direction", spot_light.direction);
-        lighting_shader.setUniform("spotLight.ambient", spot_light.ambient);
-        lighting_shader.setUniform("spotLight.diffuse", spot_light.diffuse);
-        lighting_shader.setUniform("spotLight.specular", spot_light.specular);
-        lighting_shader.setUniform("spotLight.constant", spot_light.constant);
-        lighting_shader.setUniform("spotLight.linear", spot_light.linear);
-        lighting_shader.setUniform("spotLight.quadratic", spot_light.quadratic);
-        lighting_shader.setUniform("spotLight.cutOff", spot_light.cutOff);
-        lighting_shader.setUniform("spotLight.outerCutOff", spot_light.outerCutOff);
+
+        // --- Nastavení uniform ---
+        // Všechny osvětlené shadery sdílí stejná světla
+        set_light_uniforms(lighting_shader);
+        set_light_uniforms(transparent_shader);
+        set_light_uniforms(mdi_shader);
+        set_light_uniforms(agent_shader);
+        // shadery terénu vzniknou až s terénem (load_world)
+        if (world_loaded_ && terrain_settings_.renderer == TERRAIN_TESSELLATION) {
+            set_light_uniforms(terrain_tess_shader);
+        } else if (world_loaded_ && terrain_settings_.renderer == TERRAIN_VERTEX_PULLING) {
+            set_light_uniforms(terrain_pull_shader);
+        }
 
         // --- Rotace průhledné kostky ---
-        glm::mat4& cube1_model_matrix = scene.at("transparent_cube1").model_matrix;
+        glm::mat4& cube1_model_matrix = scene.transform(transparent_cube1);
         cube1_model_matrix = glm::translate(glm::mat4(1.0f), glm::vec3(40.0f, 101.0f, 40.0f));
         cube1_model_matrix = glm::rotate(cube1_model_matrix, (float)glfwGetTime(), glm::vec3(0.0f, 1.0f, 0.0f));
         cube1_model_matrix = glm::scale(cube1_model_matrix, glm::vec3(2.0f));
 
-        // --- Vykreslování objektů ---
-        std::vector<Model*> transparent_models;
-        transparent_models.reserve(scene.size());
+        // --- Frustum culling ---
+        // Statické entity (stěny, terén, rekvizity) přes BVH, pohyblivé dávkově. Než se postaví
+        // BVH (načítání), jdou dávkově všechny entity.
+        Frustum frustum = Frustum::fromMatrix(projection_matrix * view_matrix);
+        visible_static.clear();
+        size_t static_tested = static_bvh.queryFrustum(frustum, visible_static);
+
+        std::vector<uint32_t> dynamic_entities;
+        culling_batch.clear();
+        for (uint32_t i = 0; i < scene.size(); ++i) {
+            if (!world_loaded_ || (scene.flags[i] & ENTITY_DYNAMIC)) {
+                dynamic_entities.push_back(i);
+                culling_batch.add(entity_bounds(i));
+            }
+        }
+        size_t dynamic_visible = culling_batch.cull(frustum);
 
-        // Vykreslení neprůhledných objektů
-        glDepthMask(GL_TRUE);
-        lighting_shader.activate();
-        for (auto& [name, model] : scene) {
-            if (!model.transparent) {
-                if (name == "height_map") {
-                    model.draw(lighting_shader);
-                } else if (name == "wall") {
-                    if (!wall_textures.empty()) {
-                        std::random_device r;
-                        std::default_random_engine e1(r());
-                        std::uniform_int_distribution<int> uniform_tex(0, static_cast<int>(wall_textures.size()) - 1);
-
-                        for (int y = 0; y < maze_map.rows; ++y) {
-                            for (int x = 0; x < maze_map.cols; ++x) {
-                                if (getmap(maze_map, x, y) == '#') {
-                                    glm::mat4 model_matrix = glm::mat4(1.0f);
-                                    model_matrix = glm::translate(model_matrix, glm::vec3(flatten_area.x + x, flatten_height, flatten_area.y + y));
-                                    model.setMatrix(model_matrix);
-                                    model.setTexture(wall_textures[uniform_tex(e1)]);
-                                    model.draw(lighting_shader);
-                                }
-                            }
-                        }
-                    }
-                }
-                else {
-                    model.draw(lighting_shader);
+        // Instance agentů z viditelných bloků
+        agent_renderer.update(agents, frustum, &thread_pool);
+
+        // Streamovaný terén - nové dlaždice kolem kamery do fronty, hotové do VRAM (jen v rozpočtu snímku)
+        if (terrain_settings_.renderer == TERRAIN_STREAMING && world_loaded_) {
+            terrain_streamer.update(camera.Position);
+            terrain_streamer.upload();
+            terrain_stats_.stream_bytes += terrain_streamer.stats().uploaded_bytes;
+            terrain_stats_.stream_peak_bytes = (std::max)(terrain_stats_.stream_peak_bytes, terrain_streamer.stats().uploaded_bytes);
+        }
+        culling_stats_.tested = static_tested + culling_batch.size();
+        culling_stats_.visible = visible_static.size() + dynamic_visible;
+
+        terrain_stats_.visible_tiles = 0;
+        for (uint32_t idx : visible_static) {
+            if (scene.flags[scene.indexOf(static_entities[idx])] & ENTITY_TERRAIN) {
+                terrain_stats_.visible_tiles++;
+            }
+        }
+
+        // Viditelné entity (husté indexy) - statické neprůhledné jen zapnou své příkazy v dávce
+        std::vector<uint32_t> visible_entities;
+        visible_entities.reserve(visible_static.size() + dynamic_visible);
+        static_batch.setAllVisible(false);
+        for (uint32_t idx : visible_static) {
+            const BatchRange& range = static_draws[idx];
+            if (range.count > 0) {
+                for (uint32_t d = 0; d < range.count; ++d) {
+                    static_batch.setVisible(range.first + d, true);
                 }
             } else {
-                transparent_models.push_back(&model);
+                visible_entities.push_back(scene.indexOf(static_entities[idx]));
+            }
+        }
+        for (uint32_t i = 0; i < dynamic_entities.size(); ++i) {
+            if (culling_batch.isVisible(i)) {
+                visible_entities.push_back(dynamic_entities[i]);
             }
         }
 
-        // Seřazení průhledných objektů odzadu dopředu
-        std::sort(transparent_models.begin(), transparent_models.end(), [&](const Model* a, const Model* b) {
-            glm::vec3 a_pos = glm::vec3(a->model_matrix[3]);
-            glm::vec3 b_pos = glm::vec3(b->model_matrix[3]);
-            return glm::distance(camera.Position, a_pos) > glm::distance(camera.Position, b_pos);
-        });
+        // --- Vykreslování statické geometrie ---
+        // Stěny, terén a rekvizity jedním glMultiDrawElementsIndirect, textury jako vrstvy pole.
+        // S GPU cullingem si viditelné příkazy sestaví compute shader (frustum + Hi-Z z minulého snímku).
+        if (world_loaded_) {
+            // LOD terénu podle kamery (rozsahy indexů příkazů dlaždic + uniformy morphu)
+            update_terrain_lod();
 
-        // Vykreslení průhledných objektů
-        glDepthMask(GL_FALSE);
-        transparent_shader.activate();
-        transparent_shader.setUniform("uP_m", projection_matrix);
-        transparent_shader.setUniform("uV_m", view_matrix);
-        transparent_shader.setUniform("u_view_pos", camera.Position);
-        transparent_shader.setUniform("material.diffuse", 0);
-        transparent_shader.setUniform("material.shininess", material.shininess);
-        transparent_shader.setUniform("dirLight.direction", dir_light.direction);
-        transparent_shader.setUniform("dirLight.ambient", dir_light.ambient);
-        transparent_shader.setUniform("dirLight.diffuse", dir_light.diffuse);
-        transparent_shader.setUniform("dirLight.specular", dir_light.specular);
-        for (int i = 0; i < NR_POINT_LIGHTS; i++)
-        {
-            std::string base = "pointLights[" + std::to_string(i) + "]";
-            transparent_shader.setUniform(base + ".position", point_lights[i].position);
-            transparent_shader.setUniform(base + ".ambient", point_lights[i].ambient);
-            transparent_shader.setUniform(base + ".diffuse", point_lights[i].diffuse);
-            transparent_shader.setUniform(base + ".specular", point_lights[i].specular);
-            transparent_shader.setUniform(base + ".constant", point_lights[i].constant);
-            transparent_shader.setUniform(base + ".linear", point_lights[i].linear);
-            transparent_shader.setUniform(base + ".quadratic", point_lights[i].quadratic);
-        }
-        transparent_shader.setUniform("spotLight.position", camera.Position);
-        transparent_shader.setUniform("spotLight.direction", camera.Front);
-        transparent_shader.setUniform("spotLight.ambient", spot_light.ambient);
-        transparent_shader.setUniform("spotLight.diffuse", spot_light.diffuse);
-        transparent_shader.setUniform("spotLight.specular", spot_light.specular);
-        transparent_shader.setUniform("spotLight.constant", spot_light.constant);
-        transparent_shader.setUniform("spotLight.linear", spot_light.linear);
-        transparent_shader.setUniform("spotLight.quadratic", spot_light.quadratic);
-        transparent_shader.setUniform("spotLight.cutOff", spot_light.cutOff);
-        transparent_shader.setUniform("spotLight.outerCutOff", spot_light.outerCutOff);
-
-        for (const auto& model : transparent_models) {
-            transparent_shader.setUniform("u_diffuse_color", model->diffuse_color);
-            model->draw(transparent_shader);
+            if (culling_settings_.gpu) {
+                gpu_culling.cull(static_batch, frustum, culling_settings_.occlusion);
+            }
+            mdi_shader.activate();
+            glBindTextureUnit(0, material_array);
+            glBindTextureUnit(1, terrain_height_texture);
+            if (culling_settings_.gpu) {
+                gpu_culling.draw(static_batch);
+            } else {
+                static_batch.draw();
+            }
+
+            // Teselovaný terén (culling patchů dělá teselační shader) nebo terén z vertex pullingu
+            if (terrain_settings_.renderer == TERRAIN_TESSELLATION) {
+                int fb_width, fb_height;
+                glfwGetFramebufferSize(window, &fb_width, &fb_height);
+                terrain_tessellation.draw(terrain_tess_shader, frustum, glm::vec2(fb_width, fb_height), terrain_settings_.edge_pixels, terrain_layer);
+                terrain_stats_.visible_tiles = terrain_tessellation.visiblePatches(frustum);
+                terrain_stats_.triangles = terrain_tessellation.primitiveCount();
+                terrain_stats_.full_triangles = static_cast<size_t>(hmap.cols - 1) * (hmap.rows - 1) * 2;
+            } else if (terrain_settings_.renderer == TERRAIN_VERTEX_PULLING) {
+                glBindTextureUnit(0, material_array);
+                terrain_pulling.draw(terrain_pull_shader, frustum, terrain_layer);
+                terrain_stats_.visible_tiles = terrain_pulling.visibleTiles();
+                terrain_stats_.triangles = terrain_pulling.triangleCount();
+                terrain_stats_.full_triangles = terrain_pulling.tileCount() * terrain_settings_.tile_size * terrain_settings_.tile_size * 2;
+            } else if (terrain_settings_.renderer == TERRAIN_STREAMING) {
+                mdi_shader.activate();
+                terrain_streamer.draw(frustum);
+                terrain_stats_.visible_tiles = terrain_streamer.stats().visible;
+                terrain_stats_.triangles = terrain_streamer.triangleCount();
+                terrain_stats_.full_triangles = terrain_streamer.triangleCount();
+            }
         }
+
+        // --- Vykreslování objektů ---
+        // Zbylé neprůhledné i průhledné entity jdou do jedné fronty, seřadí se klíčem
+        // (průchod, shader, textura, mesh, hloubka) a odešlou s minimem změn stavu
+        render_queue.clear();
+        for (uint32_t i : visible_entities) {
+            uint32_t flags = scene.flags[i];
+            if (flags & ENTITY_HIDDEN) {
+                continue;
+            }
+            bool transparent = (flags & ENTITY_TRANSPARENT) != 0;
+            float depth = glm::distance(camera.Position, glm::vec3(scene.transforms[i][3])) / far_plane;
+            for (const auto& mesh : mesh_library[scene.meshes[i]].meshes) {
+                DrawItem item{ transparent ? &transparent_shader : &lighting_shader, &mesh,
+                               scene.materials[i].texture, scene.transforms[i], scene.materials[i].diffuse_color };
+                render_queue.push(transparent ? PASS_TRANSPARENT : PASS_OPAQUE, item, depth);
+            }
+        }
+        render_queue.sort();
+        render_queue.submit();
         glDepthMask(GL_TRUE);
 
+        // --- Agenti (instancovaně) ---
+        agent_renderer.draw(agent_shader, agent_texture);
+
         // --- Vykreslení světýlek (lamp?) ---
         lamp_shader.activate();
         lamp_shader.setUniform("uP_m", projection_matrix);
@@ -641,10 +1237,241 @@ void App::run() {
         lamp_shader.setUniform("ourColor", glm::vec4(1.0f, 0.5f, 0.0f, 1.0f)); // Oranžová barva
         light_cube_model.draw(lamp_shader);
 
+        // Hloubka tohoto snímku -> Hi-Z pyramida pro occlusion culling v dalším snímku
+        if (culling_settings_.gpu && culling_settings_.occlusion && world_loaded_) {
+            int fb_width, fb_height;
+            glfwGetFramebufferSize(window, &fb_width, &fb_height);
+            gpu_culling.captureDepth(0, fb_width, fb_height, projection_matrix * view_matrix);
+        }
+
         // Swapování bufferů a zpracování eventů
         glfwSwapBuffers(window);
         glfwPollEvents();
+
+        // Čas do prvního snímku (od začátku konstruktoru), snímky vykreslené se zástupci
+        if (!first_frame_shown) {
+            first_frame_shown = true;
+            startup_metrics_.first_frame_ms = startup_timeline.now();
+            std::cout << "Prvni snimek za " << startup_metrics_.first_frame_ms << " ms (konstruktor " << startup_metrics_.constructor_ms << " ms)" << std::endl;
+        }
+        if (!loaded) {
+            startup_metrics_.loading_frames++;
+        } else if (exit_when_loaded) {
+            break;
+        }
+    }
+}
+
+// --- Uniformy osvětlení ---
+// Kamera, materiál a všechna světla (směrové, bodová, kuželové) do daného shaderu
+void App::set_light_uniforms(ShaderProgram& shader) {
+    shader.activate();
+    shader.setUniform("uP_m", projection_matrix);
+    shader.setUniform("uV_m", view_matrix);
+    shader.setUniform("u_view_pos", camera.Position);
+    shader.setUniform("material.diffuse", 0);
+    shader.setUniform("material.shininess", material.shininess);
+
+    shader.setUniform("dirLight.direction", dir_light.direction);
+    shader.setUniform("dirLight.ambient", dir_light.ambient);
+    shader.setUniform("dirLight.diffuse", dir_light.diffuse);
+    shader.setUniform("dirLight.specular", dir_light.specular);
+
+    for (int i = 0; i < NR_POINT_LIGHTS; i++)
+    {
+        std::string base = "pointLights[" + std::to_string(i) + "]";
+        shader.setUniform(base + ".position", point_lights[i].position);
+        shader.setUniform(base + ".ambient", point_lights[i].ambient);
+        shader.setUniform(base + ".diffuse", point_lights[i].diffuse);
+        shader.setUniform(base + ".specular", point_lights[i].specular);
+        shader.setUniform(base + ".constant", point_lights[i].constant);
+        shader.setUniform(base + ".linear", point_lights[i].linear);
+        shader.setUniform(base + ".quadratic", point_lights[i].quadratic);
+    }
+
+    shader.setUniform("spotLight.position", spot_light.position);
+    shader.setUniform("spotLight.direction", spot_light.direction);
+    shader.setUniform("spotLight.ambient", spot_light.ambient);
+    shader.setUniform("spotLight.diffuse", spot_light.diffuse);
+    shader.setUniform("spotLight.specular", spot_light.specular);
+    shader.setUniform("spotLight.constant", spot_light.constant);
+    shader.setUniform("spotLight.linear", spot_light.linear);
+    shader.setUniform("spotLight.quadratic", spot_light.quadratic);
+    shader.setUniform("spotLight.cutOff", spot_light.cutOff);
+    shader.setUniform("spotLight.outerCutOff", spot_light.outerCutOff);
+}
+
+// --- Sdílená geometrie ---
+// Přidá model do knihovny meshů a vrátí jeho index (textura se bere z materiálu entity)
+uint32_t App::add_mesh(Model model) {
+    model.setTexture(0);
+    mesh_library.push_back(model);
+    return static_cast<uint32_t>(mesh_library.size() - 1);
+}
+
+// Bounding box entity ve světových souřadnicích
+AABB App::entity_bounds(uint32_t i) const {
+    return mesh_library[scene.meshes[i]].getLocalBounds().transformed(scene.transforms[i]);
+}
+
+// --- BVH statických objektů ---
+// Všechny entity bez příznaku ENTITY_DYNAMIC (stěny, terén, rekvizity)
+void App::build_static_bvh() {
+    static_entities.clear();
+    std::vector<AABB> boxes;
+
+    for (uint32_t i = 0; i < scene.size(); ++i) {
+        if (scene.flags[i] & ENTITY_DYNAMIC) {
+            continue;
+        }
+        static_entities.push_back(scene.handleAt(i));
+        boxes.push_back(entity_bounds(i));
+    }
+
+    static_bvh.build(boxes);
+    std::cout << "BVH: " << static_entities.size() << " statickych objektu, " << static_bvh.nodeCount() << " uzlu" << std::endl;
+}
+
+// --- Dávka statické geometrie (multi-draw indirect) ---
+// Neprůhledné statické entity se suballokují do sdílených bufferů, každý mesh entity je jeden příkaz
+void App::build_static_batch() {
+    static_batch.clear();
+    static_draws.assign(static_entities.size(), BatchRange{});
+    terrain_draws.clear();
+    terrain_bounds.clear();
+    terrain_patterns.clear();
+    std::vector<uint32_t> model_ranges(mesh_library.size(), UINT32_MAX); // model -> první rozsah v dávce
+    uint32_t range_count = 0;
+
+    for (uint32_t item = 0; item < static_entities.size(); ++item) {
+        uint32_t i = scene.indexOf(static_entities[item]);
+        if (scene.flags[i] & (ENTITY_TRANSPARENT | ENTITY_HIDDEN)) {
+            continue;
+        }
+        const Model& model = mesh_library[scene.meshes[i]];
+        bool triangles = std::all_of(model.meshes.begin(), model.meshes.end(), [](const Mesh& m) { return m.primitive_type == GL_TRIANGLES; });
+        if (!triangles) {
+            continue;
+        }
+
+        // geometrie modelu se do dávky kopíruje jen jednou
+        if (model_ranges[scene.meshes[i]] == UINT32_MAX) {
+            model_ranges[scene.meshes[i]] = range_count;
+            for (const auto& mesh : model.meshes) {
+                static_batch.addMesh(mesh);
+                range_count++;
+            }
+        }
+
+        auto layer = texture_layers.find(scene.materials[i].texture);
+        GLuint texture_layer = (layer != texture_layers.end()) ? layer->second : 0;
+        GLuint draw_flags = 0;
+        if (scene.flags[i] & ENTITY_TERRAIN) {
+            texture_layer = terrain_layer;
+            draw_flags = DRAW_TERRAIN;
+        }
+
+        if (scene.flags[i] & ENTITY_TERRAIN) {
+            terrain_draws.push_back(static_cast<uint32_t>(static_batch.drawCount())); // entity jsou v pořadí dlaždic
+        }
+
+        static_draws[item].first = static_cast<uint32_t>(static_batch.drawCount());
+        static_draws[item].count = static_cast<uint32_t>(model.meshes.size());
+        for (uint32_t m = 0; m < model.meshes.size(); ++m) {
+            static_batch.addDraw(model_ranges[scene.meshes[i]] + m, scene.transforms[i], texture_layer, scene.materials[i].diffuse_color, draw_flags);
+        }
+    }
+
+    // indexy všech úrovní LOD terénu - platí pro každou dlaždici (stejná mřížka vrcholů)
+    terrain_tile_diagonal = 0.0f;
+    for (uint32_t draw : terrain_draws) {
+        const AABB& box = static_batch.drawBounds()[draw];
+        terrain_bounds.push_back(box);
+        terrain_tile_diagonal = (std::max)(terrain_tile_diagonal, glm::length(glm::vec2(box.max.x - box.min.x, box.max.z - box.min.z)));
+    }
+    if (terrain_lod.levels() > 1 && terrain_draws.size() == terrain_lod.tileCount()) {
+        for (unsigned int level = 0; level < terrain_lod.levels(); ++level) {
+            for (uint32_t mask = 0; mask < EDGE_MASKS; ++mask) {
+                const std::vector<GLuint>& pattern = terrain_lod.pattern(level, mask);
+                terrain_patterns.push_back(BatchRange{ static_batch.addIndices(pattern), static_cast<uint32_t>(pattern.size()) });
+            }
+        }
+    }
+
+    static_batch.upload();
+    std::cout << "MDI: " << static_batch.drawCount() << " prikazu, " << static_batch.vertexCount() << " vrcholu, "
+              << static_batch.indexCount() << " indexu" << std::endl;
+}
+
+// --- Pole textur materiálů ---
+// Vrstvy pole z obrázků: BGRA, sjednocená velikost (největší obrázek), mip úrovně. Bez GL volání -
+// běží jako úloha načítání, obrázky paralelně přes thread_pool
+std::vector<TextureUploader::MipChain> App::build_material_layers(const std::vector<cv::Mat>& images) {
+    int width = 0, height = 0;
+    for (const auto& image : images) {
+        width = (std::max)(width, image.cols);
+        height = (std::max)(height, image.rows);
+        if (image.channels() != 3 && image.channels() != 4) {
+            throw std::runtime_error("Nepodorovany pocet channelu v texture:" + std::to_string(image.channels()));
+        }
+    }
+
+    std::vector<TextureUploader::MipChain> layers(images.size());
+    thread_pool.parallelFor(images.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            cv::Mat layer = to_bgra(images[i]);
+            if (layer.cols != width || layer.rows != height) {
+                cv::resize(layer, layer, cv::Size(width, height), 0.0, 0.0, cv::INTER_LINEAR);
+            }
+            layers[i] = TextureUploader::buildMipChain(layer.data, width, height, layer.step);
+        }
+    });
+    return layers;
+}
+
+// Všechny textury načtené přes textureInit jako vrstvy jednoho GL_TEXTURE_2D_ARRAY (stejná velikost vrstev).
+// Vrstvy jsou hotové z úlohy načítání (nebo z cache) - tady jen úložiště, do VRAM po snímcích přes texture_uploader
+void App::build_material_array(std::vector<TextureUploader::MipChain> layers) {
+    if (layers.empty()) {
+        return;
+    }
+    if (layers.size() != material_layer_count) {
+        throw std::runtime_error("Pocet vrstev pole materialu (" + std::to_string(layers.size()) + ") neodpovida texturam (" + std::to_string(material_layer_count) + ")");
+    }
+
+    const TextureUploader::MipChain& first = layers.front();
+    const GLenum format = first.format ? first.format : GL_RGBA8;
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &material_array);
+    glTextureStorage3D(material_array, static_cast<GLsizei>(first.levels.size()), format, first.width, first.height, static_cast<GLsizei>(layers.size()));
+    for (size_t i = 0; i < layers.size(); ++i) {
+        texture_memory_.bytes += layers[i].bytes();
+        texture_memory_.rgba8_bytes += rgba8_bytes(layers[i]);
+        texture_uploader.enqueue(material_array, static_cast<GLint>(i), std::move(layers[i]));
+    }
+
+    glTextureParameteri(material_array, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(material_array, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+    glTextureParameteri(material_array, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(material_array, GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+
+// --- Výběr objektu paprskem z kamery ---
+void App::pick_object() {
+    uint32_t hit_item;
+    float hit_t;
+    if (!static_bvh.raycast(camera.Position, camera.Front, 500.0f, hit_item, hit_t)) {
+        std::cout << "Pick: nic" << std::endl;
+        return;
+    }
+
+    uint32_t i = scene.indexOf(static_entities[hit_item]);
+    glm::vec3 pos = glm::vec3(scene.transforms[i][3]);
+    std::cout << "Pick: entita " << static_entities[hit_item].index << " (" << mesh_library[scene.meshes[i]].name << ")";
+    if (scene.flags[i] & ENTITY_WALL) {
+        std::cout << " stena [" << pos.x - flatten_area.x << ", " << pos.z - flatten_area.y << "]";
     }
+    std::cout << " ve vzdalenosti " << hit_t << std::endl;
 }
 
 // --- Aktualizace projekční matice ---
@@ -653,15 +1480,11 @@ void App::update_projection_matrix() {
     glfwGetFramebufferSize(window, &width, &height);
     if (height == 0) height = 1;
     float ratio = (float)width / height;
-    projection_matrix = glm::perspective(glm::radians(camera.Zoom), ratio, 0.1f, 1000.0f);
+    projection_matrix = glm::perspective(glm::radians(camera.Zoom), ratio, near_plane, far_plane);
 }
 
 // --- Zpracování vstupu ---
-void App::process_input(float delta_time) {
-    // Reset horizontální rychlosti každý snímek
-    camera_velocity.x = 0.0f;
-    camera_velocity.z = 0.0f;
-
+void App::process_input() {
     // Vektor pohybu, který je nezávislý na sklonu kamery
     glm::vec3 front_flat = glm::normalize(glm::vec3(camera.Front.x, 0.0f, camera.Front.z));
     glm::vec3 right_flat = glm::normalize(glm::cross(front_flat, camera.WorldUp));
@@ -677,32 +1500,16 @@ void App::process_input(float delta_time) {
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
         intended_movement += right_flat;
 
-    // Normalizace vektoru pohybu a aplikace rychlosti
+    // Normalizace vektoru pohybu a aplikace rychlosti (sklon svahu řeší krok fyziky)
     if (glm::length(intended_movement) > 0.0f) {
         intended_movement = glm::normalize(intended_movement) * camera.MovementSpeed;
-
-        // Chození po svahu
-        if (camera_on_ground) {
-            glm::vec3 new_pos = camera.Position + intended_movement * delta_time;
-            glm::vec3 terrain_normal = getTerrainNormal(new_pos.x, new_pos.z);
-            const float max_slope_y_component = 0.7f; // Povolení chůze po svazích do ~45 stupňů
-
-            if (terrain_normal.y < max_slope_y_component) { // Příliš strmé
-                intended_movement = intended_movement - glm::dot(intended_movement, terrain_normal) * terrain_normal;
-            }
-        }
-
-        // Aktualizace rychlosti kamery
-        camera_velocity.x = intended_movement.x;
-        camera_velocity.z = intended_movement.z;
     }
+    player_input.move = intended_movement;
 
-    // Skákání
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS && camera_on_ground) {
-        camera_velocity.y = 10.0f; // Rychlost skoku
-        camera_on_ground = false;
-        ma_sound_seek_to_pcm_frame(&jump_sound, 0);
-        ma_sound_start(&jump_sound);
+    // Skákání - platí do nejbližšího kroku fyziky (při vysokém FPS nemusí krok proběhnout každý snímek).
+    // Během načítání fyzika neběží, stisk by jinak zůstal uložený a hráč by vyskočil hned po načtení.
+    if (world_loaded_ && glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
+        player_input.jump = true;
     }
 }
 
@@ -799,8 +1606,6 @@ void App::genLabyrinth(cv::Mat& map) {
         std::cout << std::endl;
     }
 
-    // Nastavení pozice kamery
-    camera.Position = glm::vec3(43.0f, 103.0f, 60.0f);
 }
 
 // --- Generování výškové mapy a terénu ---
@@ -810,149 +1615,331 @@ glm::vec2 App::get_subtex_st(const int x, const int y)
     return glm::vec2(x * 1.0f / 16.0f, y * 1.0f / 16.0f);
 }
 
-// Vrací subtexturu na základě výšky
-glm::vec2 App::get_subtex_by_height(float height)
+// Vrstvy terénu z atlasu textur (podle výšky: tráva, půda, skála, led, sníh) - obrázky pro pole textur
+// materiálů, smí běžet jako úloha. Míchání podle výšky dělá fragment shader (phong_mdi.frag).
+std::vector<cv::Mat> App::terrain_tiles(const cv::Mat& atlas)
 {
-    if (height > 0.9f)
-        return get_subtex_st(2, 4); //sníh
-    else if (height > 0.8f)
-        return get_subtex_st(3, 4); //led
-    else if (height > 0.5f)
-        return get_subtex_st(6, 0); //skála
-    else if (height > 0.3f)
-        return get_subtex_st(3, 1); //půda
-    else
-        return get_subtex_st(0, 0); //tráva
-}
-
-// Generuje "model" výškové mapy
-Model App::GenHeightMap(cv::Mat& hmap, const unsigned int mesh_step_size, const cv::Rect& flatten_area, uchar flatten_height)
+    const glm::vec2 layers[] = {
+        get_subtex_st(0, 0), //tráva
+        get_subtex_st(3, 1), //půda
+        get_subtex_st(6, 0), //skála
+        get_subtex_st(3, 4), //led
+        get_subtex_st(2, 4), //sníh
+    };
+    const int tile_w = atlas.cols / 16;
+    const int tile_h = atlas.rows / 16;
+
+    std::vector<cv::Mat> tiles;
+    for (const auto& st : layers) {
+        cv::Rect tile(static_cast<int>(st.x * atlas.cols), static_cast<int>(st.y * atlas.rows), tile_w, tile_h);
+        tiles.push_back(atlas(tile).clone());
+    }
+    return tiles;
+}
+
+// Vrstvy terénu v poli materiálů (za texturami, stejné pořadí jako terrain_tiles), vrací index první vrstvy
+GLuint App::add_terrain_layers()
 {
-    // Zploštění kusu ve výškové mapě
-    cv::rectangle(hmap, flatten_area, cv::Scalar(flatten_height), -1);
+    GLuint first_layer = material_layer_count;
+    material_layer_count += 5;
+    return first_layer;
+}
 
-    std::vector<vertex> vertices;
-    std::vector<GLuint> indices;
+// --- LOD terénu ---
+// Vzory indexů a geometrická chyba úrovní ze zploštělé výškové mapy, výšky jako textura pro morph
+void App::init_terrain_lod(unsigned int tiles_x, unsigned int tiles_z) {
+    glCreateTextures(GL_TEXTURE_2D, 1, &terrain_height_texture);
+    glTextureStorage2D(terrain_height_texture, 1, GL_R32F, hmap.cols, hmap.rows);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(hmap.step1()));
+    glTextureSubImage2D(terrain_height_texture, 0, 0, 0, hmap.cols, hmap.rows, GL_RED, GL_FLOAT, hmap.data);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    const unsigned int tile_size = terrain_settings_.tile_size;
+    if (!terrain_settings_.lod) {
+        return;
+    }
+    if (!TerrainLod::supportsTileSize(tile_size)) {
+        std::cerr << "LOD terenu vypnut: velikost dlazdice " << tile_size << " neni mocnina 2" << std::endl;
+        return;
+    }
 
-    // Generování vrcholů a indexů pro model výškové mapy
-    for (unsigned int x_coord = 0; x_coord < (hmap.cols - mesh_step_size); x_coord += mesh_step_size)
-    {
-        for (unsigned int z_coord = 0; z_coord < (hmap.rows - mesh_step_size); z_coord += mesh_step_size)
-        {
-            // Získání čtyř rohových bodů čtyřúhelníku
-            glm::vec3 p0(x_coord, hmap.at<uchar>(cv::Point(x_coord, z_coord)), z_coord);
-            glm::vec3 p1(x_coord + mesh_step_size, hmap.at<uchar>(cv::Point(x_coord + mesh_step_size, z_coord)), z_coord);
-            glm::vec3 p2(x_coord + mesh_step_size, hmap.at<uchar>(cv::Point(x_coord + mesh_step_size, z_coord + mesh_step_size)), z_coord + mesh_step_size);
-            glm::vec3 p3(x_coord, hmap.at<uchar>(cv::Point(x_coord, z_coord + mesh_step_size)), z_coord + mesh_step_size);
-
-            // Získání maximální výšky čtyřúhelníku
-            float max_h = (std::max)({ (float)hmap.at<uchar>(cv::Point(x_coord, z_coord)) / 255.0f,
-                                     (float)hmap.at<uchar>(cv::Point(x_coord, z_coord + mesh_step_size)) / 255.0f,
-                                     (float)hmap.at<uchar>(cv::Point(x_coord + mesh_step_size, z_coord + mesh_step_size)) / 255.0f,
-                                     (float)hmap.at<uchar>(cv::Point(x_coord + mesh_step_size, z_coord)) / 255.0f });
-
-            // Získání souřadnic textury na základě výšky
-            glm::vec2 tc0 = get_subtex_by_height(max_h);
-            glm::vec2 tc1 = tc0 + glm::vec2(1.0f / 16.0f, 0.0f);
-            glm::vec2 tc2 = tc0 + glm::vec2(1.0f / 16.0f, 1.0f / 16.0f);
-            glm::vec2 tc3 = tc0 + glm::vec2(0.0f, 1.0f / 16.0f);
-
-            // Výpočet normals
-            glm::vec3 n1 = glm::normalize(glm::cross(p2 - p0, p1 - p0));
-            glm::vec3 n2 = glm::normalize(glm::cross(p3 - p0, p2 - p0));
-            glm::vec3 navg = glm::normalize(n1 + n2);
-
-            // Přidání vertexů a indices do vektorů
-            unsigned int start_index = static_cast<unsigned int>(vertices.size());
-            vertices.emplace_back(vertex{ p0, navg, tc0 });
-            vertices.emplace_back(vertex{ p1, n1,   tc1 });
-            vertices.emplace_back(vertex{ p2, navg, tc2 });
-            vertices.emplace_back(vertex{ p3, n2,   tc3 });
-
-            indices.push_back(start_index + 0);
-            indices.push_back(start_index + 1);
-            indices.push_back(start_index + 2);
-            indices.push_back(start_index + 0);
-            indices.push_back(start_index + 2);
-            indices.push_back(start_index + 3);
-        }
-    }
-
-    // Vytvoření a vrácení modelu
-    Model model;
-    model.meshes.emplace_back(GL_TRIANGLES, vertices, indices, glm::vec3(0.0f), glm::vec3(0.0f));
-    return model;
-}
-
-// Vrací normal terénu na zadané pozici
-glm::vec3 App::getTerrainNormal(float x, float z) {
-    if (x < 0 || x >= hmap.cols - 1 || z < 0 || z >= hmap.rows - 1) {
-        return glm::vec3(0.0f, 1.0f, 0.0f);
+    auto height_at = [this](int x, int z) {
+        x = std::clamp(x, 0, hmap.cols - 1);
+        z = std::clamp(z, 0, hmap.rows - 1);
+        return hmap.at<float>(cv::Point(x, z));
+    };
+
+    terrain_lod.init(tile_size, tiles_x, tiles_z);
+    std::vector<float> errors(terrain_lod.levels(), 0.0f);
+    const int step = static_cast<int>(terrain_mesh_step);
+    const int tile_extent = static_cast<int>(tile_size) * step;
+    for (unsigned int tx = 0; tx < tiles_x; ++tx) {
+        for (unsigned int tz = 0; tz < tiles_z; ++tz) {
+            for (unsigned int level = 1; level < terrain_lod.levels(); ++level) {
+                errors[level] = (std::max)(errors[level], TerrainLod::levelError(height_at, tx * tile_extent, tz * tile_extent, step, tile_size, level));
+            }
+        }
     }
+    terrain_lod.setLevelErrors(errors);
 
-    int grid_x = static_cast<int>(x);
-    int grid_z = static_cast<int>(z);
+    std::cout << "Teren LOD: " << terrain_lod.levels() << " urovni, chyba urovni:";
+    for (float error : errors) {
+        std::cout << " " << error;
+    }
+    std::cout << ", cil " << terrain_settings_.screen_error << " px" << std::endl;
+}
 
-    float h00 = hmap.at<uchar>(cv::Point(grid_x, grid_z));
-    float h10 = hmap.at<uchar>(cv::Point(grid_x + 1, grid_z));
-    float h01 = hmap.at<uchar>(cv::Point(grid_x, grid_z + 1));
-    float h11 = hmap.at<uchar>(cv::Point(grid_x + 1, grid_z + 1));
+// Úroveň a sešití každé dlaždice pro tento snímek, uniformy morphu a počet trojúhelníků viditelných dlaždic
+void App::update_terrain_lod() {
+    const size_t full_tile_triangles = static_cast<size_t>(terrain_settings_.tile_size) * terrain_settings_.tile_size * 2;
+    terrain_stats_.triangles = 0;
+    terrain_stats_.full_triangles = 0;
+
+    mdi_shader.activate();
+    mdi_shader.setUniform("u_heightmap", 1);
+    mdi_shader.setUniform("u_terrain_step", static_cast<int>(terrain_mesh_step));
+
+    if (terrain_patterns.empty()) {
+        mdi_shader.setUniform("u_lod_levels", 1);
+        for (uint32_t draw : terrain_draws) {
+            if (static_batch.isVisible(draw)) {
+                terrain_stats_.triangles += full_tile_triangles;
+                terrain_stats_.full_triangles += full_tile_triangles;
+            }
+        }
+        return;
+    }
 
-    glm::vec3 p00(grid_x, h00, grid_z);
-    glm::vec3 p10(grid_x + 1, h10, grid_z);
-    glm::vec3 p01(grid_x, h01, grid_z + 1);
-    glm::vec3 p11(grid_x + 1, h11, grid_z + 1);
+    // hranice úrovní závisí na výšce viewportu a zorném poli (zoom)
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+    terrain_lod.updateRanges(terrain_settings_.screen_error, static_cast<float>((std::max)(height, 1)), glm::radians(camera.Zoom), terrain_tile_diagonal);
+    terrain_lod.selectLevels(terrain_bounds, camera.Position, terrain_levels, terrain_masks);
+
+    for (size_t t = 0; t < terrain_draws.size(); ++t) {
+        const BatchRange& pattern = terrain_patterns[terrain_levels[t] * EDGE_MASKS + terrain_masks[t]];
+        static_batch.setDrawIndices(terrain_draws[t], pattern.first, pattern.count);
+        if (static_batch.isVisible(terrain_draws[t])) {
+            terrain_stats_.triangles += pattern.count / 3;
+            terrain_stats_.full_triangles += full_tile_triangles;
+        }
+    }
+    static_batch.flushCommands();
 
-    float x_frac = x - grid_x;
-    float z_frac = z - grid_z;
+    mdi_shader.setUniform("u_lod_levels", static_cast<int>(terrain_lod.levels()));
+    for (unsigned int level = 0; level < terrain_lod.levels(); ++level) {
+        mdi_shader.setUniform("u_lod_morph[" + std::to_string(level) + "]", terrain_lod.morphRange(level));
+    }
+}
 
-    glm::vec3 normal;
-    if (x_frac > z_frac) { // Pravý dolní trojúhelník
-        normal = glm::normalize(glm::cross(p10 - p00, p11 - p00));
-    } else { // Levý horní trojúhelník
-        normal = glm::normalize(glm::cross(p11 - p00, p01 - p00));
+// --- Výšková mapa ---
+// Načtení v plné přesnosti jako CV_32F (hodnoty beze změny, normalizuje až volající)
+cv::Mat App::load_heightmap(const std::filesystem::path& path)
+{
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    cv::Mat heights;
+    if (extension == ".thm") {
+        // dlaždicový formát - celá mapa se přečte z namapovaného souboru
+        HeightMapFile file;
+        file.open(path);
+        heights.create(file.height(), file.width(), CV_32F);
+        file.readRegion(0, 0, file.width(), file.height(), heights.ptr<float>(), heights.step1());
+    } else if (extension == ".r32") {
+        // surová čtvercová mapa float32 (export z editorů terénu)
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        const size_t samples = in ? static_cast<size_t>(in.tellg()) / sizeof(float) : 0;
+        const int size = static_cast<int>(std::lround(std::sqrt(static_cast<double>(samples))));
+        if (samples == 0 || static_cast<size_t>(size) * size != samples) {
+            throw std::runtime_error("Surova vyskova mapa neni ctvercova float32: " + path.string());
+        }
+        heights.create(size, size, CV_32F);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(heights.data), samples * sizeof(float));
+    } else {
+        // PNG / TIFF - 8 i 16 bitů (IMREAD_ANYDEPTH), bez převodu na 8 bitů
+        cv::Mat image = cv::imread(path.string(), cv::IMREAD_GRAYSCALE | cv::IMREAD_ANYDEPTH);
+        if (image.empty()) {
+            throw std::runtime_error("Selhalo nacteni heightmapy: " + path.string());
+        }
+        std::cout << "Heightmapa " << path.filename().string() << ": " << (image.depth() == CV_16U ? 16 : image.depth() == CV_8U ? 8 : 32) << " bitu" << std::endl;
+        image.convertTo(heights, CV_32F);
     }
+    return heights;
+}
 
-    return normal;
+int App::convert_heightmap(int argc, char* argv[])
+{
+    if (argc < 4) {
+        std::cerr << "Pouziti: --convert-heightmap <vstup.png|.r32> <vystup.thm> [velikost dlazdice]" << std::endl;
+        return 1;
+    }
+    try {
+        // výšky v jednotkách světa (0-255 jako po načtení v App) - streamování soubor čte beze změny
+        cv::Mat heights = load_heightmap(argv[2]);
+        cv::normalize(heights, heights, 0, 255, cv::NORM_MINMAX);
+        const int tile_size = (argc > 4) ? (std::max)(std::atoi(argv[4]), 1) : 256;
+        HeightMapFile::write(argv[3], heights.ptr<float>(), heights.cols, heights.rows, heights.step1(), tile_size);
+        std::cout << "Zapsano " << argv[3] << ": " << heights.cols << "x" << heights.rows << ", dlazdice " << tile_size << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
 }
 
-// Vrací výšku terénu na zadané pozici pomocí bilinear interpolation
-float App::getTerrainHeight(float x, float z) {
-    if (x < 0 || x >= hmap.cols - 1 || z < 0 || z >= hmap.rows - 1) {
-        return 0.0f;
+// Dlaždice terénu - jeden vrchol na každý mesh_step_size-tý vzorek výškové mapy (sousední dlaždice sdílí okrajový řádek/sloupec vzorků)
+std::vector<vertex> App::GenHeightMapVertices(cv::Mat& hmap, const unsigned int mesh_step_size, const unsigned int tile_size, const cv::Rect& flatten_area, uchar flatten_height)
+{
+    // Zploštění kusu ve výškové mapě
+    cv::rectangle(hmap, flatten_area, cv::Scalar(flatten_height), -1);
+
+    // Dlaždice po tile_size x tile_size čtyřúhelnících - každá je samostatný model s vlastním AABB.
+    // Všechny dlaždice mají stejnou mřížku, takže i stejné indexy (sdílí se v StaticBatch, LOD vzory
+    // platí pro každou) - poslední řada dlaždic přesahuje mapu, chybějící vzorky opakují okraj.
+    // Vrcholy se počítají paralelně do jednoho předem alokovaného pole (bez GL - smí běžet jako úloha).
+    const TerrainTileGrid grid = TerrainMesh::layout(hmap.cols, hmap.rows, mesh_step_size, tile_size);
+    std::vector<vertex> vertices(grid.vertexCount());
+    TerrainMesh::generate(hmap.ptr<float>(), hmap.cols, hmap.rows, hmap.step1(), mesh_step_size, tile_size, vertices.data(), &thread_pool);
+    return vertices;
+}
+
+// GL buffery dlaždic z vrcholů GenHeightMapVertices (hlavní vlákno)
+std::vector<Model> App::GenHeightMapTiles(int width, int height, const unsigned int mesh_step_size, const unsigned int tile_size, const std::vector<vertex>& vertices)
+{
+    const TerrainTileGrid grid = TerrainMesh::layout(width, height, mesh_step_size, tile_size);
+
+    // Indexy - stejné rozdělení čtyřúhelníku jako dřív: (p0, p1, p2) a (p0, p2, p3)
+    const std::vector<GLuint> indices = TerrainLod::buildPattern(tile_size, 0, 0);
+
+    std::vector<Model> tiles;
+    tiles.reserve(grid.tileCount());
+    for (unsigned int tile_x = 0; tile_x < grid.tiles_x; ++tile_x)
+    {
+        for (unsigned int tile_z = 0; tile_z < grid.tiles_z; ++tile_z)
+        {
+            auto first = vertices.begin() + (static_cast<size_t>(tile_x) * grid.tiles_z + tile_z) * grid.tileVertices();
+            std::vector<vertex> tile_vertices(first, first + grid.tileVertices());
+
+            // Vytvoření modelu dlaždice
+            Model tile;
+            tile.name = "height_map[" + std::to_string(tile_x) + "," + std::to_string(tile_z) + "]";
+            tile.meshes.emplace_back(GL_TRIANGLES, tile_vertices, indices, glm::vec3(0.0f), glm::vec3(0.0f));
+            tiles.push_back(std::move(tile));
+        }
     }
 
-    int grid_x = static_cast<int>(x);
-    int grid_z = static_cast<int>(z);
+    return tiles;
+}
+
+// Výška vzorku - celá mapa v hmap, nebo (streamování) z dlaždic, které už přečetla vlákna streameru.
+// Namapovaný soubor se v hlavní smyčce nečte (výpadek stránky by zastavil snímek) - dlaždice, která ještě
+// není načtená (teleport, kamera předběhla streamování), vrátí false.
+bool App::terrain_sample(int x, int z, float& height) const {
+    if (terrain_settings_.renderer == TERRAIN_STREAMING) {
+        if (flatten_area.contains(cv::Point(x, z))) {
+            height = static_cast<float>(flatten_height);
+            return true;
+        }
+        return terrain_streamer.sampleHeight(x, z, height);
+    }
+    height = hmap.at<float>(cv::Point(x, z));
+    return true;
+}
+
+// Terén pod bodem je k dispozici: vždy, jen při streamování musí být načtené všechny rohy buňky
+bool App::terrain_ready(float x, float z) const {
+    if (terrain_settings_.renderer != TERRAIN_STREAMING) {
+        return true;
+    }
+    const cv::Size size = terrain_size();
+    if (!(x >= 0.0f && x < size.width - 1 && z >= 0.0f && z < size.height - 1)) {
+        return true;    // mimo mapu je výška 0 bez vzorků
+    }
+    const int gx = static_cast<int>(x), gz = static_cast<int>(z);
+    float height;
+    return terrain_sample(gx, gz, height) && terrain_sample(gx + 1, gz, height) &&
+           terrain_sample(gx, gz + 1, height) && terrain_sample(gx + 1, gz + 1, height);
+}
 
-    float x_frac = x - grid_x;
-    float z_frac = z - grid_z;
+cv::Size App::terrain_size() const {
+    if (terrain_settings_.renderer == TERRAIN_STREAMING) {
+        return cv::Size(terrain_file.width(), terrain_file.height());
+    }
+    return hmap.size();
+}
 
-    float h00 = hmap.at<uchar>(cv::Point(grid_x, grid_z));
-    float h10 = hmap.at<uchar>(cv::Point(grid_x + 1, grid_z));
-    float h01 = hmap.at<uchar>(cv::Point(grid_x, grid_z + 1));
-    float h11 = hmap.at<uchar>(cv::Point(grid_x + 1, grid_z + 1));
+glm::vec3 App::getTerrainNormal(float x, float z) {
+    if (terrain_field.valid()) {
+        return terrain_field.normal(x, z);
+    }
+    const cv::Size size = terrain_size();
+    // volající ověřil terrain_ready, vzorky buňky jsou načtené
+    return TerrainHeightField::normalAt([this](int sx, int sz) { float h = 0.0f; terrain_sample(sx, sz, h); return h; }, size.width, size.height, x, z);
+}
 
-    // Bilineární interpolace
-    float h_top = (1 - x_frac) * h00 + x_frac * h10;
-    float h_bottom = (1 - x_frac) * h01 + x_frac * h11;
-    return (1 - z_frac) * h_top + z_frac * h_bottom;
+// Vrací výšku terénu na zadané pozici - na trojúhelníku, který kreslí GPU (stejně jako kolize hráče)
+float App::getTerrainHeight(float x, float z) {
+    if (terrain_field.valid()) {
+        return terrain_field.height(x, z);
+    }
+    const cv::Size size = terrain_size();
+    return TerrainHeightField::heightAt([this](int sx, int sz) { float h = 0.0f; terrain_sample(sx, sz, h); return h; }, size.width, size.height, x, z);
 }
 
 // --- Načítání textur ---
-// Inicializace textur ze souboru
-GLuint App::textureInit(const std::filesystem::path& file_name)
+// Dekódování obrázku textury (bez GL, smí běžet na pracovním vlákně)
+cv::Mat App::load_texture(const std::filesystem::path& file_name)
 {
     cv::Mat image = cv::imread(file_name.string(), cv::IMREAD_UNCHANGED);
     if (image.empty()) {
         throw std::runtime_error("V souboru neni zadna textura: " + file_name.string());
     }
+    return image;
+}
+
+// Inicializace textur ze souboru
+GLuint App::textureInit(const std::filesystem::path& file_name)
+{
+    cv::Mat image = load_texture(file_name);
+    return textureInit(image);
+}
 
-    GLuint texture = gen_tex(image);
+// Textura z už dekódovaného obrázku (vlákno s GL kontextem), mimo pole materiálů (statická dávka použije vrstvu 0)
+GLuint App::textureInit(cv::Mat& image)
+{
+    return gen_tex(image);
+}
 
+// Textura s mip úrovněmi spočítanými na pracovním vlákně (nebo přečtenými z cache) - tady jen úložiště,
+// data nahraje texture_uploader po snímcích (do té doby je obsah textury nedefinovaný)
+GLuint App::textureInit(TextureUploader::MipChain mips)
+{
+    GLuint texture = 0;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    glTextureStorage2D(texture, static_cast<GLsizei>(mips.levels.size()), mips.format ? mips.format : GL_RGBA8, mips.width, mips.height);
+    texture_memory_.bytes += mips.bytes();
+    texture_memory_.rgba8_bytes += rgba8_bytes(mips);
+
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    texture_uploader.enqueue(texture, -1, std::move(mips));
+    add_material_layer(texture);
     return texture;
 }
 
+// textura dostane vrstvu v poli materiálů (statická dávka), data vrstvy staví úloha načítání
+void App::add_material_layer(GLuint texture)
+{
+    if (material_array == 0) {
+        texture_layers[texture] = material_layer_count++;
+    }
+}
+
 // Generuje texturu OpenGL z obrázku
 GLuint App::gen_tex(cv::Mat& image)
 {
@@ -4,6 +4,8 @@
 #include <filesystem>
 #include <random>
 #include <algorithm>
+#include <unordered_map>
+#include <memory>
 
 #include <glm/glm.hpp>
 #include <opencv2/opencv.hpp>
@@ -11,6 +13,29 @@
 #include "src/ShaderProgram.hpp"
 #include "src/Model.hpp"
 #include "src/camera.hpp"
+#include "src/Frustum.hpp"
+#include "src/BVH.hpp"
+#include "src/EntityStore.hpp"
+#include "src/RenderQueue.hpp"
+#include "src/StaticBatch.hpp"
+#include "src/GpuCulling.hpp"
+#include "src/TerrainLod.hpp"
+#include "src/TerrainTessellation.hpp"
+#include "src/TerrainVertexPulling.hpp"
+#include "src/TerrainMesh.hpp"
+#include "src/ThreadPool.hpp"
+#include "src/HeightMapFile.hpp"
+#include "src/TerrainStreamer.hpp"
+#include "src/TerrainHeightField.hpp"
+#include "src/PlayerPhysics.hpp"
+#include "src/MazeCollider.hpp"
+#include "src/FixedTimestep.hpp"
+#include "src/AgentSystem.hpp"
+#include "src/AgentRenderer.hpp"
+#include "src/StartupTimeline.hpp"
+#include "src/TextureUploader.hpp"
+#include "src/BcEncoder.hpp"
+#include "src/DdsFile.hpp"
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -23,7 +48,21 @@ struct GLFWwindow;
 
 class App {
 public:
-    App();
+    // start: okno hned se zástupci a assety se dosypou za běhu, nebo vše ještě v konstruktoru
+    enum StartupMode {
+        STARTUP_SETTINGS,       // podle startup.progressive v app_settings.json
+        STARTUP_PROGRESSIVE,
+        STARTUP_BLOCKING,
+    };
+    // časy od začátku konstruktoru (ms)
+    struct StartupMetrics {
+        double constructor_ms = 0.0;        // návrat z App::App()
+        double first_frame_ms = 0.0;        // první snímek na obrazovce
+        double loaded_ms = 0.0;             // všechny assety načtené a vyměněné za zástupce
+        unsigned int loading_frames = 0;    // snímky vykreslené před načtením všeho
+    };
+
+    explicit App(StartupMode mode = STARTUP_SETTINGS);
     ~App();
     App(const App&) = delete;
     App& operator=(const App&) = delete;
@@ -32,10 +71,20 @@ public:
 
     void toggle_fullscreen();
     void toggle_vsync();
-    void run();
+    void run(bool exit_when_loaded = false);  // exit_when_loaded: konec po prvním snímku s načteným vším (měření startu)
+    const StartupMetrics& startup_metrics() const { return startup_metrics_; }
     void update_projection_matrix();
     GLuint textureInit(const std::filesystem::path& file_name);
+    GLuint textureInit(cv::Mat& image);
+    GLuint textureInit(TextureUploader::MipChain mips);   // mip úrovně (BGRA8 nebo BCn) z pracovního vlákna, data přes texture_uploader
+    static cv::Mat load_texture(const std::filesystem::path& file_name);   // jen dekódování, bez GL
     GLuint gen_tex(cv::Mat& image);
+    void pick_object();
+
+    // výšková mapa v plné přesnosti (CV_32F): PNG 8/16 bit, .r32 (čtvercová float32) nebo .thm (HeightMapFile)
+    static cv::Mat load_heightmap(const std::filesystem::path& path);
+    // --convert-heightmap <vstup> <výstup.thm> [dlaždice] - převod do dlaždicového formátu pro mapování
+    static int convert_heightmap(int argc, char* argv[]);
 
     GLFWwindow* window;
     Camera camera;
@@ -46,9 +95,10 @@ public:
     GLFWmonitor* primary_monitor = nullptr;
 
     cv::Mat maze_map;
-    cv::Mat hmap;
+    cv::Mat hmap;                     // výšky CV_32F, 0..255 = výška ve světě
+    TerrainHeightField terrain_field; // dotazy na výšku/normálu nad hmap (při streamování prázdné)
+    MazeCollider maze_collider;       // kolize se stěnami nad maze_map
     std::vector<GLuint> wall_textures;
-    Model height_map_model;
     cv::Rect flatten_area;
     uchar flatten_height = 100;
 
@@ -57,6 +107,9 @@ private:
     void save_settings();
     float getTerrainHeight(float x, float z);
     glm::vec3 getTerrainNormal(float x, float z);
+    bool terrain_sample(int x, int z, float& height) const;  // výška vzorku z hmap, při streamování z dlaždic streameru (false = nenačtená)
+    bool terrain_ready(float x, float z) const;               // vzorky buňky pod bodem jsou k dispozici
+    cv::Size terrain_size() const;
 
     struct WindowSettings {
         int width = 1280;
@@ -73,18 +126,158 @@ private:
         int level = 0;
     } antialiasing_settings_;
 
-    void process_input(float delta_time);
+    struct CullingSettings {
+        bool gpu = true;        // culling statické dávky compute shaderem
+        bool occlusion = true;  // Hi-Z test proti hloubce minulého snímku
+    } culling_settings_;
+
+    enum TerrainRenderer {
+        TERRAIN_MESH,           // dlaždice z GenHeightMapTiles v MDI dávce (geomipmapping)
+        TERRAIN_TESSELLATION,   // patche teselované z textury výškové mapy
+        TERRAIN_VERTEX_PULLING, // mřížka bez vertex bufferu, vrcholy z gl_VertexID a textury výšek
+        TERRAIN_STREAMING,      // dlaždice z .thm načítané na pozadí kolem kamery (TerrainStreamer)
+    };
+    struct TerrainSettings {
+        TerrainRenderer renderer = TERRAIN_MESH;
+        std::string heightmap = "resources/textures/heights.png";
+        int tile_size = 64;     // čtyřúhelníků na stranu dlaždice (u teselace vzorků na stranu patche)
+        bool lod = true;        // geomipmapping (tile_size musí být mocnina 2)
+        float screen_error = 2.0f; // cílová chyba LOD na obrazovce v pixelech
+        float edge_pixels = 8.0f;  // teselace: cílová délka hrany trojúhelníku na obrazovce
+        float stream_radius = 512.0f;   // streamování: okruh načtených dlaždic kolem kamery
+        int stream_workers = 2;         // streamování: vlákna pro čtení a generování dlaždic
+        float stream_budget_ms = 2.0f;  // streamování: čas nahrávání do VRAM za snímek
+    } terrain_settings_;
+
+    struct PhysicsSettings {
+        float rate = 120.0f;    // kroků simulace za sekundu
+        int max_steps = 8;      // nejvýš kroků za snímek (po záseku se zbytek času zahodí)
+    } physics_settings_;
+
+    struct AgentSettings {
+        int count = 2000;       // agentů (NPC) v oblasti labyrintu, 0 = žádní
+        float rate = 60.0f;     // kroků simulace agentů za sekundu
+    } agent_settings_;
+
+    struct TextureSettings {
+        float upload_budget_ms = 2.0f;  // čas nahrávání textur přes staging za snímek
+        bool compressed = true;         // textury ve VRAM jako BC1/BC3 (BC7 z hotových DDS), jinak RGBA8
+        std::filesystem::path cache = "resources/cache";   // komprimované textury (DDS) z prvního startu
+    } texture_settings_;
+
+    struct StartupSettings {
+        bool progressive = true;    // run() hned se zástupci, assety se nahrají mezi snímky
+    } startup_settings_;
+
+    void process_input();
     void genLabyrinth(cv::Mat& map);
     void carve_passages(int cx, int cy, cv::Mat& map, std::default_random_engine& rng);
     uchar getmap(cv::Mat& map, int x, int y);
-    Model GenHeightMap(cv::Mat& hmap, const unsigned int mesh_step_size, const cv::Rect& flatten_area, uchar flatten_height);
-    glm::vec2 get_subtex_by_height(float height);
+    void build_static_bvh();
+    uint32_t add_mesh(Model model);
+    void build_static_batch();
+    std::vector<TextureUploader::MipChain> build_material_layers(const std::vector<cv::Mat>& images);   // bez GL, smí běžet jako úloha
+    void build_material_array(std::vector<TextureUploader::MipChain> layers);
+    void add_material_layer(GLuint texture);
+    void set_light_uniforms(ShaderProgram& shader);
+    void init_terrain_lod(unsigned int tiles_x, unsigned int tiles_z);
+    void update_terrain_lod();
+    AABB entity_bounds(uint32_t i) const;
+    // progresivní načítání: hotové etapy do GL (jedna za snímek), true = vše načtené
+    struct Loading;
+    bool update_loading();
+    void load_world(Loading& loading);
+    // síť terénu: vrcholy (CPU, smí běžet jako úloha) a dlaždice s GL buffery (vlákno s kontextem)
+    std::vector<vertex> GenHeightMapVertices(cv::Mat& hmap, const unsigned int mesh_step_size, const unsigned int tile_size, const cv::Rect& flatten_area, uchar flatten_height);
+    std::vector<Model> GenHeightMapTiles(int width, int height, const unsigned int mesh_step_size, const unsigned int tile_size, const std::vector<vertex>& vertices);
+    std::vector<cv::Mat> terrain_tiles(const cv::Mat& atlas);
+    GLuint add_terrain_layers();
     glm::vec2 get_subtex_st(const int x, const int y);
 
     ShaderProgram shader;
-    std::map<std::string, Model> scene;
+    std::vector<Model> mesh_library;  // sdílená geometrie
+    EntityStore scene;                // entity scény (SoA)
+    EntityHandle transparent_cube1;   // rotující průhledná kostka
     glm::mat4 projection_matrix;
     glm::mat4 view_matrix;
+    float near_plane = 0.1f;          // ořezové roviny projekce (far zároveň normalizuje hloubku v řazení)
+    float far_plane = 1000.0f;
+
+    ThreadPool thread_pool;              // plánovač úloh (start, generování terénu, agenti, culling agentů)
+    StartupTimeline startup_timeline;    // etapy startu (časy od začátku konstruktoru)
+    StartupMetrics startup_metrics_;
+    std::unique_ptr<Loading> loading_;   // do načtení všeho (úlohy zapisují sem)
+    bool world_loaded_ = false;          // terén, labyrint, fyzika, statická dávka
+    bool audio_loaded_ = false;
+
+    // frustum culling
+    CullingBatch culling_batch;          // pohyblivé modely
+    BVH static_bvh;                      // statické objekty
+    std::vector<EntityHandle> static_entities; // položka BVH -> entita
+    std::vector<uint32_t> visible_static;
+
+    // fronta vykreslování (řazení podle klíče)
+    RenderQueue render_queue;
+    struct CullingStats {
+        size_t tested = 0;
+        size_t visible = 0;
+    } culling_stats_;
+    struct TerrainStats {
+        size_t tiles = 0;
+        size_t visible_tiles = 0;   // po frustum cullingu (BVH)
+        size_t triangles = 0;       // trojúhelníky viditelných dlaždic s LOD
+        size_t full_triangles = 0;  // totéž v plném rozlišení
+        size_t stream_bytes = 0;        // streamování: nahráno od poslední aktualizace titulku
+        size_t stream_peak_bytes = 0;   // nejvíc za jeden snímek
+    } terrain_stats_;
+
+    // statická neprůhledná geometrie kreslená přes multi-draw indirect
+    struct BatchRange {
+        uint32_t first = 0;
+        uint32_t count = 0;     // 0 = entita není v dávce (průhledná, skrytá)
+    };
+    StaticBatch static_batch;
+    std::vector<BatchRange> static_draws;             // položka BVH -> příkazy v dávce
+    ShaderProgram mdi_shader;
+    GLuint material_array = 0;                        // textury materiálů jako vrstvy GL_TEXTURE_2D_ARRAY
+    GLuint material_layer_count = 0;                  // vrstvy přidělené texturám (data staví úloha načítání)
+    std::unordered_map<GLuint, GLuint> texture_layers; // textura -> vrstva pole
+    GLuint terrain_layer = 0;                         // první z vrstev terénu (tráva..sníh)
+    TextureUploader texture_uploader;                 // textury do VRAM přes staging, po snímcích
+    struct TextureMemory {
+        size_t bytes = 0;                             // textur materiálů ve VRAM
+        size_t rgba8_bytes = 0;                       // totéž nekomprimovaně (RGBA8)
+    } texture_memory_;
+    GpuCulling gpu_culling;
+
+    // LOD terénu - dlaždice v pořadí GenHeightMapTiles, vzory indexů jsou v dávce za ostatní geometrií
+    TerrainLod terrain_lod;
+    std::vector<uint32_t> terrain_draws;              // dlaždice -> příkaz v dávce
+    std::vector<AABB> terrain_bounds;                 // bounding box dlaždice
+    std::vector<BatchRange> terrain_patterns;         // [level * EDGE_MASKS + mask] -> (first_index, count)
+    std::vector<uint8_t> terrain_levels, terrain_masks;
+    unsigned int terrain_mesh_step = 1;              // vzorků výškové mapy mezi vrcholy terénu
+    float terrain_tile_diagonal = 0.0f;
+    GLuint terrain_height_texture = 0;                // výšky pro morph ve vertex shaderu (R32F)
+
+    // teselovaný terén (terrain.renderer = "tessellation")
+    TerrainTessellation terrain_tessellation;
+    ShaderProgram terrain_tess_shader;
+
+    // terén bez vertex bufferu (terrain.renderer = "vertex_pulling")
+    TerrainVertexPulling terrain_pulling;
+    ShaderProgram terrain_pull_shader;
+
+    // streamovaný terén (terrain.renderer = "streaming", heightmap = .thm), mapa zůstává v souboru
+    HeightMapFile terrain_file;
+    TerrainStreamer terrain_streamer;
+
+    // agenti (NPC) - SoA simulace po blocích na thread_pool, kreslení instancovaně jedním voláním
+    AgentSystem agents;
+    AgentRenderer agent_renderer;
+    ShaderProgram agent_shader;
+    FixedTimestep agent_clock;
+    GLuint agent_texture = 0;
 
     // lighting
     ShaderProgram lighting_shader;
@@ -140,8 +333,11 @@ private:
     SpotLight spot_light;
 
 public:
-    glm::vec3 camera_velocity = glm::vec3(0.0f);
-    bool camera_on_ground = false;
+    // fyzika hráče s pevným krokem, kamera = interpolace mezi player_previous a player
+    PlayerPhysics player_physics;
+    FixedTimestep physics_clock;
+    PlayerState player, player_previous;
+    PlayerInput player_input;       // vstup pro další krok (skok drží, dokud ho krok nezpracuje)
 
     ma_engine engine;
     ma_sound jump_sound;
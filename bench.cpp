@@ -0,0 +1,2391 @@
+#include "bench.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <cmath>
+#include <set>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+#include <cstring>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "src/BVH.hpp"
+#include "src/Mesh.hpp"
+#include "src/ShaderProgram.hpp"
+#include "src/StaticBatch.hpp"
+#include "src/GpuCulling.hpp"
+#include "src/TerrainLod.hpp"
+#include "src/TerrainTessellation.hpp"
+#include "src/TerrainVertexPulling.hpp"
+#include "src/TerrainMesh.hpp"
+#include "src/ThreadPool.hpp"
+#include "src/HeightMapFile.hpp"
+#include "src/TerrainStreamer.hpp"
+#include "src/TerrainHeightField.hpp"
+#include "src/PlayerPhysics.hpp"
+#include "src/FixedTimestep.hpp"
+#include "src/MazeCollider.hpp"
+#include "src/AgentSystem.hpp"
+#include "src/TextureUploader.hpp"
+#include "src/BcEncoder.hpp"
+#include "src/DdsFile.hpp"
+
+#define NOMINMAX    // app.h vkládá windows.h - bez maker min/max (glm::max)
+#include "app.h"
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+static double elapsed_ms(bench_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(bench_clock::now() - start).count();
+}
+
+// --- BVH: stavba a dotazy nad 1M instancí ---
+static void bench_bvh() {
+    const size_t N = 1000000;
+    std::default_random_engine rng(42);
+    std::uniform_real_distribution<float> pos(0.0f, 2000.0f);
+    std::uniform_real_distribution<float> height(0.0f, 200.0f);
+    std::uniform_real_distribution<float> size(0.25f, 2.0f);
+
+    std::vector<AABB> boxes(N);
+    for (auto& b : boxes) {
+        glm::vec3 c(pos(rng), height(rng), pos(rng));
+        glm::vec3 e(size(rng), size(rng), size(rng));
+        b = AABB{ c - e, c + e };
+    }
+
+    BVH bvh;
+    auto t0 = bench_clock::now();
+    bvh.build(boxes);
+    double build_ms = elapsed_ms(t0);
+    std::cout << "BVH build: " << N << " instanci, " << bvh.nodeCount() << " uzlu, " << build_ms << " ms" << std::endl;
+
+    // frustum dotazy z náhodných pozic kamery
+    const int frustum_queries = 200;
+    glm::mat4 proj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 300.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831f);
+    std::vector<uint32_t> visible;
+    size_t total_visible = 0, total_tested = 0;
+    t0 = bench_clock::now();
+    for (int q = 0; q < frustum_queries; ++q) {
+        glm::vec3 eye(pos(rng), 100.0f, pos(rng));
+        float a = angle(rng);
+        glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(std::cos(a), -0.2f, std::sin(a)), glm::vec3(0.0f, 1.0f, 0.0f));
+        visible.clear();
+        total_tested += bvh.queryFrustum(Frustum::fromMatrix(proj * view), visible);
+        total_visible += visible.size();
+    }
+    double frustum_ms = elapsed_ms(t0);
+    std::cout << "BVH frustum: " << frustum_ms / frustum_queries << " ms/dotaz, prumerne " << total_visible / frustum_queries
+              << " viditelnych, " << total_tested / frustum_queries << " testu boxu" << std::endl;
+
+    // paprsky
+    const int rays = 1000000;
+    std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+    size_t hits = 0;
+    t0 = bench_clock::now();
+    for (int r = 0; r < rays; ++r) {
+        glm::vec3 o(pos(rng), height(rng), pos(rng));
+        glm::vec3 d = glm::normalize(glm::vec3(dir(rng), dir(rng) * 0.2f, dir(rng)) + glm::vec3(1e-4f));
+        uint32_t item;
+        float t;
+        hits += bvh.raycast(o, d, 100.0f, item, t) ? 1 : 0;
+    }
+    double ray_ms = elapsed_ms(t0);
+    std::cout << "BVH raycast: " << rays / (ray_ms / 1000.0) / 1e6 << " Mray/s, zasahu " << hits << std::endl;
+
+    // překryvy boxů (kolize)
+    const int overlaps = 1000000;
+    std::vector<uint32_t> found;
+    size_t total_found = 0;
+    t0 = bench_clock::now();
+    for (int q = 0; q < overlaps; ++q) {
+        glm::vec3 c(pos(rng), height(rng), pos(rng));
+        found.clear();
+        bvh.queryOverlap(AABB{ c - glm::vec3(1.0f), c + glm::vec3(1.0f) }, found);
+        total_found += found.size();
+    }
+    double overlap_ms = elapsed_ms(t0);
+    std::cout << "BVH overlap: " << overlaps / (overlap_ms / 1000.0) / 1e6 << " Mdotazu/s, nalezeno " << total_found << std::endl;
+}
+
+// --- Skryté okno s OpenGL 4.6 kontextem pro benchmarky vykreslování ---
+static GLFWwindow* create_bench_context() {
+    if (!glfwInit()) {
+        std::cerr << "Selhala inicializace GLFW" << std::endl;
+        return nullptr;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(1280, 720, "bench", nullptr, nullptr);
+    if (!window) {
+        std::cerr << "Selhalo vytvoreni okna GLFW" << std::endl;
+        glfwTerminate();
+        return nullptr;
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+    if (glewInit() != GLEW_OK) {
+        std::cerr << "Selhala inicializace GLEW" << std::endl;
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return nullptr;
+    }
+    glEnable(GL_DEPTH_TEST);
+    std::cout << "OpenGL: " << glGetString(GL_VERSION) << ", " << glGetString(GL_RENDERER) << std::endl;
+    return window;
+}
+
+static void destroy_bench_context(GLFWwindow* window) {
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
+
+// jednotková krychle (24 vrcholů, 36 indexů)
+static Mesh make_cube_mesh() {
+    std::vector<vertex> vertices;
+    std::vector<GLuint> indices;
+    const glm::vec3 normals[6] = { {1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1} };
+    for (const auto& n : normals) {
+        glm::vec3 u = (n.y != 0.0f) ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+        glm::vec3 v = glm::cross(n, u);
+        GLuint base = static_cast<GLuint>(vertices.size());
+        vertices.push_back({ (n - u - v) * 0.5f, n, {0.0f, 0.0f} });
+        vertices.push_back({ (n + u - v) * 0.5f, n, {1.0f, 0.0f} });
+        vertices.push_back({ (n + u + v) * 0.5f, n, {1.0f, 1.0f} });
+        vertices.push_back({ (n - u + v) * 0.5f, n, {0.0f, 1.0f} });
+        indices.insert(indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+    }
+    return Mesh(GL_TRIANGLES, vertices, indices, glm::vec3(0.0f), glm::vec3(0.0f));
+}
+
+// offscreen cíl benchmarků vykreslování (RGBA8 + hloubka ve stejném formátu jako výchozí framebuffer)
+struct BenchFramebuffer {
+    GLuint fbo{ 0 }, color{ 0 }, depth{ 0 };
+    int width, height;
+
+    BenchFramebuffer(int w, int h) : width(w), height(h) {
+        glCreateRenderbuffers(1, &color);
+        glNamedRenderbufferStorage(color, GL_RGBA8, width, height);
+        glCreateRenderbuffers(1, &depth);
+        glNamedRenderbufferStorage(depth, GL_DEPTH24_STENCIL8, width, height);
+        glCreateFramebuffers(1, &fbo);
+        glNamedFramebufferRenderbuffer(fbo, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+        glNamedFramebufferRenderbuffer(fbo, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+    }
+
+    // počet pixelů dané barvy (RGBA8 jako uint32, little endian)
+    size_t countColor(uint32_t rgba) const {
+        std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        return static_cast<size_t>(std::count(pixels.begin(), pixels.end(), rgba));
+    }
+
+    void destroy() {
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &color);
+        glDeleteRenderbuffers(1, &depth);
+        fbo = color = depth = 0;
+    }
+};
+
+// barva pozadí při hledání děr v terénu (purpurová, nikde jinde se nevyskytuje)
+static constexpr uint32_t BENCH_HOLE_COLOR = 0xFFFF00FFu;
+
+// syntetická výšková mapa size x size (0..255 v plné přesnosti, několik oktáv sinusů), řádek = z
+static std::vector<float> make_bench_heightmap(int size) {
+    std::vector<float> heights(static_cast<size_t>(size) * size);
+    for (int z = 0; z < size; ++z) {
+        for (int x = 0; x < size; ++x) {
+            float h = 127.5f + 70.0f * std::sin(x * 0.011f) * std::cos(z * 0.013f) + 30.0f * std::sin(x * 0.05f + z * 0.037f)
+                      + 8.0f * std::sin(x * 0.21f) * std::sin(z * 0.17f);
+            heights[static_cast<size_t>(z) * size + x] = std::clamp(h, 0.0f, 255.0f);
+        }
+    }
+    return heights;
+}
+
+// --- MDI: CPU čas odeslání statické geometrie, draw call na objekt vs. glMultiDrawElementsIndirect ---
+static void bench_mdi() {
+    GLFWwindow* window = create_bench_context();
+    if (!window) {
+        return;
+    }
+
+    {
+        Mesh cube = make_cube_mesh();
+        ShaderProgram per_object_shader("resources/shaders/phong.vert", "resources/shaders/phong.frag");
+        ShaderProgram mdi_shader("resources/shaders/phong_mdi.vert", "resources/shaders/phong_mdi.frag");
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 2000.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 300.0f, -50.0f), glm::vec3(0.0f, 0.0f, 300.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        const int frames = 20;
+        std::cout << "objektu | draw/objekt [ms CPU] | MDI [ms CPU] | MDI [draw calls]" << std::endl;
+        for (size_t n : { size_t(100), size_t(10000), size_t(100000) }) {
+            // objekty v mřížce
+            const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n))));
+            std::vector<glm::mat4> matrices(n);
+            for (size_t i = 0; i < n; ++i) {
+                matrices[i] = glm::translate(glm::mat4(1.0f), glm::vec3(float(i % side) * 2.0f - side, 0.0f, float(i / side) * 2.0f));
+            }
+
+            StaticBatch batch;
+            uint32_t range = batch.addMesh(cube);
+            for (const auto& m : matrices) {
+                batch.addDraw(range, m, 0);
+            }
+            batch.upload();
+
+            // jeden draw call na objekt (Mesh::draw)
+            double per_object_ms = 0.0;
+            for (int f = 0; f < frames; ++f) {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                auto t0 = bench_clock::now();
+                per_object_shader.activate();
+                per_object_shader.setUniform("uP_m", proj);
+                per_object_shader.setUniform("uV_m", view);
+                for (const auto& m : matrices) {
+                    cube.draw(per_object_shader, m);
+                }
+                per_object_ms += elapsed_ms(t0);
+                glFinish();
+            }
+
+            // jeden glMultiDrawElementsIndirect (včetně nahrání příkazů)
+            double mdi_ms = 0.0;
+            for (int f = 0; f < frames; ++f) {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                auto t0 = bench_clock::now();
+                mdi_shader.activate();
+                mdi_shader.setUniform("uP_m", proj);
+                mdi_shader.setUniform("uV_m", view);
+                batch.setAllVisible(true);
+                batch.draw();
+                mdi_ms += elapsed_ms(t0);
+                glFinish();
+            }
+
+            std::cout << n << " | " << per_object_ms / frames << " | " << mdi_ms / frames << " | 1" << std::endl;
+            batch.clear();
+        }
+        per_object_shader.clear();
+        mdi_shader.clear();
+        cube.clear();
+    }
+
+    destroy_bench_context(window);
+}
+
+// --- GPU culling: frustum + Hi-Z compute pass vs. CPU reference nad labyrintem ---
+static void bench_gpu_cull() {
+    GLFWwindow* window = create_bench_context();
+    if (!window) {
+        return;
+    }
+
+    {
+        const int width = 1280, height = 720;
+        const int maze_size = 200;  // 200x200 buněk, ~40 % stěn
+
+        Mesh cube = make_cube_mesh();
+        ShaderProgram mdi_shader("resources/shaders/phong_mdi.vert", "resources/shaders/phong_mdi.frag");
+
+        // stěny labyrintu jako statická dávka
+        std::default_random_engine rng(7);
+        std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+        std::vector<glm::vec2> free_cells;
+        StaticBatch batch;
+        uint32_t range = batch.addMesh(cube);
+        for (int y = 0; y < maze_size; ++y) {
+            for (int x = 0; x < maze_size; ++x) {
+                if (chance(rng) < 0.4f) {
+                    batch.addDraw(range, glm::translate(glm::mat4(1.0f), glm::vec3(float(x), 0.5f, float(y))), 0);
+                } else {
+                    free_cells.push_back(glm::vec2(float(x), float(y)));
+                }
+            }
+        }
+        batch.upload();
+        std::cout << "Labyrint: " << batch.drawCount() << " sten" << std::endl;
+
+        // offscreen framebuffer (hloubka ve stejném formátu jako výchozí framebuffer)
+        BenchFramebuffer target(width, height);
+        const GLuint fbo = target.fbo;
+
+        GpuCulling culling;
+        culling.init(batch.drawCount());
+        std::cout << "Indirect count: " << (culling.usesIndirectCount() ? "ano" : "ne (prikazy doplnene nulami)") << std::endl;
+
+        GLuint query;
+        glCreateQueries(GL_TIME_ELAPSED, 1, &query);
+
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), float(width) / float(height), 0.1f, 1000.0f);
+        std::uniform_int_distribution<size_t> cell(0, free_cells.size() - 1);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831f);
+
+        size_t mismatches = 0, compaction_errors = 0, pixel_errors = 0;
+        std::vector<float> depth_all(static_cast<size_t>(width) * height), depth_culled(depth_all.size());
+        const int views = 8;
+        for (int v = 0; v < views; ++v) {
+            glm::vec2 c = free_cells[cell(rng)];
+            glm::vec3 eye(c.x, 0.5f, c.y);
+            float a = angle(rng);
+            glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(std::cos(a), 0.0f, std::sin(a)), glm::vec3(0.0f, 1.0f, 0.0f));
+            glm::mat4 view_proj = proj * view;
+            Frustum frustum = Frustum::fromMatrix(view_proj);
+
+            // 1. snímek: vykreslit vše a postavit Hi-Z
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glViewport(0, 0, width, height);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            mdi_shader.activate();
+            mdi_shader.setUniform("uP_m", proj);
+            mdi_shader.setUniform("uV_m", view);
+            batch.setAllVisible(true);
+            batch.draw();
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            culling.captureDepth(fbo, width, height, view_proj);
+
+            // 2. snímek ze stejného místa: culling na GPU
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            culling.cull(batch, frustum, true);
+            glEndQuery(GL_TIME_ELAPSED);
+            GLuint64 gpu_ns = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &gpu_ns);
+
+            std::vector<uint32_t> gpu_visible = culling.readVisibility();
+            uint32_t gpu_count = culling.readVisibleCount();
+
+            // CPU reference nad staženou pyramidou
+            HiZReadback hiz = culling.readHiZ();
+            auto t0 = bench_clock::now();
+            size_t frustum_visible = 0, cpu_visible = 0, gpu_sum = 0;
+            for (size_t i = 0; i < batch.drawCount(); ++i) {
+                const AABB& box = batch.drawBounds()[i];
+                frustum_visible += frustum.intersects(box) ? 1 : 0;
+                bool visible = GpuCulling::isVisibleReference(box, frustum, &hiz);
+                cpu_visible += visible ? 1 : 0;
+                gpu_sum += gpu_visible[i];
+                mismatches += (visible != (gpu_visible[i] != 0)) ? 1 : 0;
+            }
+            double cpu_ms = elapsed_ms(t0);
+            compaction_errors += (gpu_sum != gpu_count) ? 1 : 0;
+
+            // hloubka po vykreslení jen viditelných musí být stejná jako po vykreslení všeho
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, depth_all.data());
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            mdi_shader.activate();
+            culling.draw(batch);
+            glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, depth_culled.data());
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            size_t diff = 0;
+            for (size_t p = 0; p < depth_all.size(); ++p) {
+                diff += (depth_all[p] != depth_culled[p]) ? 1 : 0;
+            }
+            pixel_errors += diff;
+
+            std::cout << "pohled " << v << ": frustum " << frustum_visible << ", Hi-Z CPU " << cpu_visible << ", GPU " << gpu_count
+                      << " | GPU " << gpu_ns / 1e6 << " ms, CPU reference " << cpu_ms << " ms | rozdilnych pixelu " << diff << std::endl;
+        }
+
+        if (mismatches == 0 && compaction_errors == 0 && pixel_errors == 0) {
+            std::cout << "Validace: OK (viditelne mnoziny GPU a CPU se shoduji, obraz beze zmeny)" << std::endl;
+        } else {
+            std::cout << "Validace: CHYBA - " << mismatches << " neshod viditelnosti, " << compaction_errors << " chyb kompakce, "
+                      << pixel_errors << " rozdilnych pixelu" << std::endl;
+        }
+
+        glDeleteQueries(1, &query);
+        target.destroy();
+        culling.clear();
+        batch.clear();
+        mdi_shader.clear();
+        cube.clear();
+    }
+
+    destroy_bench_context(window);
+}
+
+// --- LOD terénu: trojúhelníky a GPU čas plné mřížky vs. geomipmapping, kontrola sešití (bez děr) ---
+static void bench_terrain_lod() {
+    GLFWwindow* window = create_bench_context();
+    if (!window) {
+        return;
+    }
+
+    {
+        const int width = 1280, height = 720;
+        const int map_size = 1024;              // vzorků na stranu jako heights.png
+        const unsigned int tile_size = 64;
+        const float screen_error = 2.0f;
+        const float fov = glm::radians(60.0f);
+
+        const std::vector<float> heights = make_bench_heightmap(map_size);
+        auto height_at = [&](int x, int z) {
+            x = std::clamp(x, 0, map_size - 1);
+            z = std::clamp(z, 0, map_size - 1);
+            return heights[static_cast<size_t>(z) * map_size + x];
+        };
+
+        // dlaždice stejně jako TerrainMesh::generate (sdílená mřížka, poslední řada přesahuje mapu)
+        const unsigned int tiles = (map_size - 1 + tile_size - 1) / tile_size;
+        TerrainLod lod;
+        lod.init(tile_size, tiles, tiles);
+        std::vector<float> errors(lod.levels(), 0.0f);
+
+        StaticBatch batch;
+        std::vector<Mesh> meshes;
+        for (unsigned int tx = 0; tx < tiles; ++tx) {
+            for (unsigned int tz = 0; tz < tiles; ++tz) {
+                std::vector<vertex> vertices;
+                for (unsigned int i = 0; i <= tile_size; ++i) {
+                    for (unsigned int j = 0; j <= tile_size; ++j) {
+                        int x = tx * tile_size + i, z = tz * tile_size + j;
+                        glm::vec3 normal = glm::normalize(glm::vec3(height_at(x - 1, z) - height_at(x + 1, z), 2.0f, height_at(x, z - 1) - height_at(x, z + 1)));
+                        vertices.push_back({ glm::vec3(x, height_at(x, z), z), normal, glm::vec2(x, z) });
+                    }
+                }
+                meshes.emplace_back(GL_TRIANGLES, vertices, lod.pattern(0, 0), glm::vec3(0.0f), glm::vec3(0.0f));
+                batch.addDraw(batch.addMesh(meshes.back()), glm::mat4(1.0f), 0, glm::vec4(1.0f), DRAW_TERRAIN);
+                for (unsigned int level = 1; level < lod.levels(); ++level) {
+                    errors[level] = (std::max)(errors[level], TerrainLod::levelError(height_at, tx * tile_size, tz * tile_size, 1, tile_size, level));
+                }
+            }
+        }
+        lod.setLevelErrors(errors);
+
+        std::vector<GLuint> pattern_first(lod.levels() * EDGE_MASKS);
+        for (unsigned int p = 0; p < pattern_first.size(); ++p) {
+            pattern_first[p] = batch.addIndices(lod.pattern(p / EDGE_MASKS, p % EDGE_MASKS));
+        }
+        batch.upload();
+
+        float diagonal = 0.0f;
+        for (const auto& box : batch.drawBounds()) {
+            diagonal = (std::max)(diagonal, glm::length(glm::vec2(box.max.x - box.min.x, box.max.z - box.min.z)));
+        }
+        lod.updateRanges(screen_error, float(height), fov, diagonal);
+        std::cout << "Teren: " << tiles * tiles << " dlazdic, " << lod.levels() << " urovni LOD, hranice:";
+        for (unsigned int level = 0; level + 1 < lod.levels(); ++level) {
+            std::cout << " " << lod.range(level);
+        }
+        std::cout << std::endl;
+
+        // 1. Vzory: stejná orientace trojúhelníků a pokrytí celé dlaždice
+        size_t pattern_errors = 0;
+        const unsigned int samples = tile_size + 1;
+        for (unsigned int p = 0; p < pattern_first.size(); ++p) {
+            const std::vector<GLuint>& indices = lod.pattern(p / EDGE_MASKS, p % EDGE_MASKS);
+            long long area2 = 0;
+            for (size_t t = 0; t < indices.size(); t += 3) {
+                long long ax = indices[t] / samples, az = indices[t] % samples;
+                long long bx = indices[t + 1] / samples, bz = indices[t + 1] % samples;
+                long long cx = indices[t + 2] / samples, cz = indices[t + 2] % samples;
+                long long o = (bz - az) * (cx - ax) - (bx - ax) * (cz - az);
+                if (o >= 0) {
+                    pattern_errors++;
+                }
+                area2 -= o;
+            }
+            if (area2 != 2LL * tile_size * tile_size) {
+                pattern_errors++;
+            }
+        }
+
+        // vrcholy vzoru na jedné straně dlaždice (souřadnice podél strany)
+        auto edge_vertices = [&](unsigned int level, uint32_t mask, int side) {
+            std::set<unsigned int> out;
+            for (GLuint index : lod.pattern(level, mask)) {
+                unsigned int x = index / samples, z = index % samples;
+                if (side == 0 && x == 0) out.insert(z);
+                if (side == 1 && x == tile_size) out.insert(z);
+                if (side == 2 && z == 0) out.insert(x);
+                if (side == 3 && z == tile_size) out.insert(x);
+            }
+            return out;
+        };
+
+        glm::mat4 proj = glm::perspective(fov, float(width) / float(height), 0.1f, 2000.0f);
+        ShaderProgram mdi_shader("resources/shaders/phong_mdi.vert", "resources/shaders/phong_mdi.frag");
+
+        GLuint height_texture;
+        glCreateTextures(GL_TEXTURE_2D, 1, &height_texture);
+        glTextureStorage2D(height_texture, 1, GL_R32F, map_size, map_size);
+        glTextureSubImage2D(height_texture, 0, 0, 0, map_size, map_size, GL_RED, GL_FLOAT, heights.data());
+
+        BenchFramebuffer target(width, height);
+        const GLuint fbo = target.fbo;
+
+        GLuint query;
+        glCreateQueries(GL_TIME_ELAPSED, 1, &query);
+
+        // vykreslení (všechny dlaždice viditelné), vrací GPU čas v ms
+        auto render = [&](const glm::vec3& eye, const glm::mat4& view, int lod_levels) {
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            glViewport(0, 0, width, height);
+            glClearColor(1.0f, 0.0f, 1.0f, 1.0f);   // BENCH_HOLE_COLOR
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            mdi_shader.activate();
+            mdi_shader.setUniform("uP_m", proj);
+            mdi_shader.setUniform("uV_m", view);
+            mdi_shader.setUniform("u_view_pos", eye);
+            mdi_shader.setUniform("u_heightmap", 1);
+            mdi_shader.setUniform("u_terrain_step", 1);
+            mdi_shader.setUniform("u_lod_levels", lod_levels);
+            for (unsigned int level = 0; level < lod.levels(); ++level) {
+                mdi_shader.setUniform("u_lod_morph[" + std::to_string(level) + "]", lod.morphRange(level));
+            }
+            glBindTextureUnit(1, height_texture);
+            batch.setAllVisible(true);
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            batch.draw();
+            glEndQuery(GL_TIME_ELAPSED);
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            return ns / 1e6;
+        };
+
+        // zahřátí (ovladač dokončí kompilaci shaderu při prvním vykreslení)
+        render(glm::vec3(512.0f, 400.0f, 512.0f), glm::lookAt(glm::vec3(512.0f, 400.0f, 512.0f), glm::vec3(512.0f, 0.0f, 513.0f), glm::vec3(0.0f, 1.0f, 0.0f)), 1);
+
+        // 2. Pohledy: výběr úrovní, sešití sousedů, trojúhelníky, GPU čas a díry v obraze (pohled shora)
+        std::default_random_engine rng(11);
+        std::uniform_real_distribution<float> pos(300.0f, 724.0f);
+        std::uniform_real_distribution<float> altitude(20.0f, 120.0f);
+        std::vector<uint8_t> levels, masks;
+        size_t seam_errors = 0, hole_pixels = 0;
+        double lod_triangles = 0, full_triangles = 0, lod_ms = 0, full_ms = 0, select_us = 0;
+        const int views = 8;
+        for (int v = 0; v < views; ++v) {
+            glm::vec3 eye(pos(rng), 0.0f, pos(rng));
+            eye.y = height_at(int(eye.x), int(eye.z)) + altitude(rng);
+            // pohled šikmo dolů (63°) nebo kolmo shora - vidí blízké i vzdálené úrovně a jen terén (žádná obloha)
+            glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.0f, -2.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            if (v % 2 == 1) {
+                view = glm::lookAt(eye, eye + glm::vec3(0.01f, -1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            }
+
+            auto t0 = bench_clock::now();
+            lod.selectLevels(batch.drawBounds(), eye, levels, masks);
+            select_us += elapsed_ms(t0) * 1000.0;
+
+            size_t triangles = 0;
+            for (unsigned int t = 0; t < levels.size(); ++t) {
+                const std::vector<GLuint>& pattern = lod.pattern(levels[t], masks[t]);
+                batch.setDrawIndices(t, pattern_first[levels[t] * EDGE_MASKS + masks[t]], static_cast<GLuint>(pattern.size()));
+                triangles += pattern.size() / 3;
+            }
+            // sousedé: rozdíl nejvýš 1 úroveň a stejné vrcholy na společné hraně
+            for (unsigned int tx = 0; tx < tiles; ++tx) {
+                for (unsigned int tz = 0; tz < tiles; ++tz) {
+                    unsigned int a = tx * tiles + tz;
+                    if (tx + 1 < tiles) {
+                        unsigned int b = a + tiles;
+                        if (std::abs(levels[a] - levels[b]) > 1 || edge_vertices(levels[a], masks[a], 1) != edge_vertices(levels[b], masks[b], 0)) {
+                            seam_errors++;
+                        }
+                    }
+                    if (tz + 1 < tiles) {
+                        unsigned int b = a + 1;
+                        if (std::abs(levels[a] - levels[b]) > 1 || edge_vertices(levels[a], masks[a], 3) != edge_vertices(levels[b], masks[b], 2)) {
+                            seam_errors++;
+                        }
+                    }
+                }
+            }
+            double ms_lod = render(eye, view, static_cast<int>(lod.levels()));
+            size_t view_holes = target.countColor(BENCH_HOLE_COLOR);
+            hole_pixels += view_holes;
+
+            for (unsigned int t = 0; t < levels.size(); ++t) {
+                batch.setDrawIndices(t, pattern_first[0], static_cast<GLuint>(lod.pattern(0, 0).size()));
+            }
+            double ms_full = render(eye, view, 1);
+            size_t full = static_cast<size_t>(levels.size()) * tile_size * tile_size * 2;
+
+            lod_triangles += triangles;
+            full_triangles += full;
+            lod_ms += ms_lod;
+            full_ms += ms_full;
+            std::cout << "pohled " << v << ": " << triangles << " / " << full << " trojuhelniku, GPU LOD " << ms_lod << " ms, plne " << ms_full
+                      << " ms, der " << view_holes << std::endl;
+        }
+        std::cout << "Prumer: " << lod_triangles / views << " trojuhelniku s LOD (" << 100.0 * lod_triangles / full_triangles << " % plne mrizky), GPU "
+                  << lod_ms / views << " ms vs. " << full_ms / views << " ms, vyber urovni " << select_us / views << " us" << std::endl;
+
+        if (pattern_errors == 0 && seam_errors == 0 && hole_pixels == 0) {
+            std::cout << "Validace: OK (vzory pokryji dlazdici, sousede sdili hranove vrcholy, obraz bez der)" << std::endl;
+        } else {
+            std::cout << "Validace: CHYBA - " << pattern_errors << " chyb vzoru, " << seam_errors << " chyb napojeni, " << hole_pixels << " pixelu der" << std::endl;
+        }
+
+        glDeleteQueries(1, &query);
+        target.destroy();
+        glDeleteTextures(1, &height_texture);
+        batch.clear();
+        mdi_shader.clear();
+        for (auto& mesh : meshes) {
+            mesh.clear();
+        }
+    }
+
+    destroy_bench_context(window);
+}
+
+// --- Teselovaný terén: start a VRAM proti dlaždicím z CPU, trojúhelníky a díry v obraze ---
+static void bench_terrain_tess() {
+    GLFWwindow* window = create_bench_context();
+    if (!window) {
+        return;
+    }
+
+    {
+        const int width = 1280, height = 720;
+        const int map_size = 2048;
+        const int tile_size = 64;
+        const float edge_pixels = 8.0f;
+        const std::vector<float> heightmap = make_bench_heightmap(map_size);
+        auto height_at = [&](int x, int z) {
+            x = std::clamp(x, 0, map_size - 1);
+            z = std::clamp(z, 0, map_size - 1);
+            return heightmap[static_cast<size_t>(z) * map_size + x];
+        };
+
+        // 1. Dlaždice z CPU jako TerrainMesh::generate + App::GenHeightMapTiles + build_static_batch (vrcholy, Mesh a kopie v dávce)
+        auto t0 = bench_clock::now();
+        const unsigned int tiles = (map_size - 1 + tile_size - 1) / tile_size;
+        const std::vector<GLuint> indices = TerrainLod::buildPattern(tile_size, 0, 0);
+        StaticBatch batch;
+        size_t mesh_bytes = 0;
+        for (unsigned int tx = 0; tx < tiles; ++tx) {
+            for (unsigned int tz = 0; tz < tiles; ++tz) {
+                std::vector<vertex> vertices;
+                vertices.reserve((tile_size + 1) * (tile_size + 1));
+                for (int i = 0; i <= tile_size; ++i) {
+                    for (int j = 0; j <= tile_size; ++j) {
+                        int x = tx * tile_size + i, z = tz * tile_size + j;
+                        glm::vec3 normal = glm::normalize(glm::vec3(height_at(x - 1, z) - height_at(x + 1, z), 2.0f, height_at(x, z - 1) - height_at(x, z + 1)));
+                        vertices.push_back({ glm::vec3(x, height_at(x, z), z), normal, glm::vec2(x, z) });
+                    }
+                }
+                Mesh mesh(GL_TRIANGLES, vertices, indices, glm::vec3(0.0f), glm::vec3(0.0f));
+                batch.addDraw(batch.addMesh(mesh), glm::mat4(1.0f), 0, glm::vec4(1.0f), DRAW_TERRAIN);
+                mesh_bytes += vertices.size() * sizeof(vertex) + indices.size() * sizeof(GLuint);
+                mesh.clear();   // v App zůstává i kopie v knihovně modelů
+            }
+        }
+        batch.upload();
+        glFinish();
+        double mesh_ms = elapsed_ms(t0);
+        mesh_bytes += batch.vertexCount() * sizeof(vertex) + batch.indexCount() * sizeof(GLuint);
+        batch.clear();
+
+        // 2. Teselace - jen textura a rohy patchů
+        t0 = bench_clock::now();
+        TerrainTessellation terrain;
+        terrain.init(heightmap.data(), map_size, map_size, map_size, tile_size);
+        glFinish();
+        double tess_ms = elapsed_ms(t0);
+
+        std::cout << "Mapa " << map_size << "x" << map_size << ": dlazdice z CPU " << mesh_ms << " ms, " << mesh_bytes / (1024.0 * 1024.0)
+                  << " MB | teselace " << tess_ms << " ms, " << terrain.gpuBytes() / (1024.0 * 1024.0) << " MB (" << terrain.patchCount() << " patchu)" << std::endl;
+
+        // 3. Pohledy - trojúhelníky z teselace, GPU čas a díry (pozadí prosvítající terénem)
+        ShaderProgram shader("resources/shaders/terrain_tess.vert", "resources/shaders/terrain_tess.tesc",
+                             "resources/shaders/terrain_tess.tese", "resources/shaders/phong_mdi.frag");
+        BenchFramebuffer target(width, height);
+        GLuint query;
+        glCreateQueries(GL_TIME_ELAPSED, 1, &query);
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), float(width) / float(height), 0.1f, 3000.0f);
+
+        std::default_random_engine rng(5);
+        std::uniform_real_distribution<float> pos(400.0f, map_size - 400.0f);
+        std::uniform_real_distribution<float> altitude(20.0f, 150.0f);
+        size_t hole_pixels = 0;
+        const size_t full_triangles = static_cast<size_t>(map_size - 1) * (map_size - 1) * 2;
+        const int views = 6;
+        for (int v = 0; v < views; ++v) {
+            glm::vec3 eye(pos(rng), 0.0f, pos(rng));
+            eye.y = height_at(int(eye.x), int(eye.z)) + altitude(rng);
+            glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.0f, -2.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+            Frustum frustum = Frustum::fromMatrix(proj * view);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+            glViewport(0, 0, width, height);
+            shader.activate();
+            shader.setUniform("uP_m", proj);
+            shader.setUniform("uV_m", view);
+            shader.setUniform("u_view_pos", eye);
+
+            // dvakrát - počet trojúhelníků se čte z předchozího vykreslení
+            double gpu_ms = 0.0;
+            for (int pass = 0; pass < 2; ++pass) {
+                glClearColor(1.0f, 0.0f, 1.0f, 1.0f);   // BENCH_HOLE_COLOR
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                glBeginQuery(GL_TIME_ELAPSED, query);
+                terrain.draw(shader, frustum, glm::vec2(width, height), edge_pixels, 0);
+                glEndQuery(GL_TIME_ELAPSED);
+                GLuint64 ns = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+                gpu_ms = ns / 1e6;
+            }
+            terrain.draw(shader, frustum, glm::vec2(width, height), edge_pixels, 0);   // vyzvedne výsledek druhého průchodu
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glFinish();
+
+            size_t holes = target.countColor(BENCH_HOLE_COLOR);
+            hole_pixels += holes;
+            std::cout << "pohled " << v << ": " << terrain.visiblePatches(frustum) << "/" << terrain.patchCount() << " patchu, "
+                      << terrain.primitiveCount() << " trojuhelniku (plna mrizka " << full_triangles << "), GPU " << gpu_ms << " ms, der " << holes << std::endl;
+        }
+
+        if (hole_pixels == 0) {
+            std::cout << "Validace: OK (teselovany teren bez der)" << std::endl;
+        } else {
+            std::cout << "Validace: CHYBA - " << hole_pixels << " pixelu der" << std::endl;
+        }
+
+        glDeleteQueries(1, &query);
+        target.destroy();
+        shader.clear();
+        terrain.clear();
+    }
+
+    destroy_bench_context(window);
+}
+
+// --- Vertex pulling terénu: hloubka proti dlaždicím z vertex bufferu, VRAM a GPU čas ---
+static void bench_terrain_pull() {
+    GLFWwindow* window = create_bench_context();
+    if (!window) {
+        return;
+    }
+
+    {
+        const int width = 1280, height = 720;
+        const int map_size = 1024;
+        const int tile_size = 64;
+        const std::vector<float> heightmap = make_bench_heightmap(map_size);
+        auto height_at = [&](int x, int z) {
+            x = std::clamp(x, 0, map_size - 1);
+            z = std::clamp(z, 0, map_size - 1);
+            return heightmap[static_cast<size_t>(z) * map_size + x];
+        };
+
+        // 1. Reference - dlaždice jako App::GenHeightMapTiles v MDI dávce (plné rozlišení, bez LOD)
+        const unsigned int tiles = (map_size - 1 + tile_size - 1) / tile_size;
+        const std::vector<GLuint> indices = TerrainLod::buildPattern(tile_size, 0, 0);
+        StaticBatch batch;
+        for (unsigned int tx = 0; tx < tiles; ++tx) {
+            for (unsigned int tz = 0; tz < tiles; ++tz) {
+                std::vector<vertex> vertices;
+                vertices.reserve((tile_size + 1) * (tile_size + 1));
+                for (int i = 0; i <= tile_size; ++i) {
+                    for (int j = 0; j <= tile_size; ++j) {
+                        int x = tx * tile_size + i, z = tz * tile_size + j;
+                        glm::vec3 normal = glm::normalize(glm::vec3(height_at(x - 1, z) - height_at(x + 1, z), 2.0f, height_at(x, z - 1) - height_at(x, z + 1)));
+                        vertices.push_back({ glm::vec3(x, height_at(x, z), z), normal, glm::vec2(x, z) });
+                    }
+                }
+                Mesh mesh(GL_TRIANGLES, vertices, indices, glm::vec3(0.0f), glm::vec3(0.0f));
+                batch.addDraw(batch.addMesh(mesh), glm::mat4(1.0f), 0, glm::vec4(1.0f), DRAW_TERRAIN);
+                mesh.clear();
+            }
+        }
+        batch.upload();
+        const size_t mesh_bytes = batch.vertexCount() * sizeof(vertex) + batch.indexCount() * sizeof(GLuint);
+
+        // 2. Vertex pulling - textura výšek a indexy jedné dlaždice
+        TerrainVertexPulling terrain;
+        terrain.init(heightmap.data(), map_size, map_size, map_size, tile_size);
+        std::cout << "Mapa " << map_size << "x" << map_size << ": vertex buffer " << mesh_bytes / (1024.0 * 1024.0) << " MB | vertex pulling "
+                  << terrain.gpuBytes() / (1024.0 * 1024.0) << " MB (" << terrain.tileCount() << " dlazdic)" << std::endl;
+
+        ShaderProgram mdi_shader("resources/shaders/phong_mdi.vert", "resources/shaders/phong_mdi.frag");
+        ShaderProgram pull_shader("resources/shaders/terrain_pull.vert", "resources/shaders/phong_mdi.frag");
+        BenchFramebuffer target(width, height);
+        GLuint query;
+        glCreateQueries(GL_TIME_ELAPSED, 1, &query);
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), float(width) / float(height), 0.1f, 2000.0f);
+
+        // vykreslení jednou z cest, vrací GPU čas v ms a hloubku (+ počet pixelů pozadí)
+        std::vector<float> depth(static_cast<size_t>(width) * height);
+        auto render = [&](bool pulling, const glm::vec3& eye, const glm::mat4& view, std::vector<float>& out, size_t& background) {
+            Frustum frustum = Frustum::fromMatrix(proj * view);
+            glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+            glViewport(0, 0, width, height);
+            glClearColor(1.0f, 0.0f, 1.0f, 1.0f);   // BENCH_HOLE_COLOR
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            ShaderProgram& shader = pulling ? pull_shader : mdi_shader;
+            shader.activate();
+            shader.setUniform("uP_m", proj);
+            shader.setUniform("uV_m", view);
+            shader.setUniform("u_view_pos", eye);
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            if (pulling) {
+                terrain.draw(pull_shader, frustum, 0);
+            } else {
+                const std::vector<AABB>& bounds = batch.drawBounds();
+                for (uint32_t d = 0; d < bounds.size(); ++d) {
+                    batch.setVisible(d, frustum.intersects(bounds[d]));
+                }
+                mdi_shader.setUniform("u_heightmap", 1);   // jednotka 0 patří poli materiálů
+                mdi_shader.setUniform("u_lod_levels", 1);
+                batch.draw();
+            }
+            glEndQuery(GL_TIME_ELAPSED);
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+            glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, out.data());
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            background = target.countColor(BENCH_HOLE_COLOR);
+            return ns / 1e6;
+        };
+
+        // zahřátí obou shaderů
+        std::vector<float> depth_pull(depth.size());
+        size_t background_mesh = 0, background_pull = 0;
+        glm::vec3 warm_eye(512.0f, 400.0f, 512.0f);
+        glm::mat4 warm_view = glm::lookAt(warm_eye, glm::vec3(512.0f, 0.0f, 513.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        render(false, warm_eye, warm_view, depth, background_mesh);
+        render(true, warm_eye, warm_view, depth_pull, background_pull);
+
+        // 3. Pohledy - šikmo i k obzoru, hloubka obou cest se musí shodovat
+        std::default_random_engine rng(36);
+        std::uniform_real_distribution<float> pos(200.0f, map_size - 200.0f);
+        std::uniform_real_distribution<float> altitude(10.0f, 150.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831f);
+        size_t depth_errors = 0, coverage_errors = 0;
+        float max_diff = 0.0f;
+        double mesh_ms = 0.0, pull_ms = 0.0;
+        const int views = 8;
+        for (int v = 0; v < views; ++v) {
+            glm::vec3 eye(pos(rng), 0.0f, pos(rng));
+            eye.y = height_at(int(eye.x), int(eye.z)) + altitude(rng);
+            float a = angle(rng);
+            glm::vec3 dir(std::cos(a), (v % 2 == 0) ? -0.6f : -0.15f, std::sin(a));
+            glm::mat4 view = glm::lookAt(eye, eye + dir, glm::vec3(0.0f, 1.0f, 0.0f));
+
+            double ms_mesh = render(false, eye, view, depth, background_mesh);
+            double ms_pull = render(true, eye, view, depth_pull, background_pull);
+            mesh_ms += ms_mesh;
+            pull_ms += ms_pull;
+
+            // stejné vrcholy ve stejném pořadí -> rasterizace musí dát stejnou hloubku (tolerance na rozdíl v přesnosti shaderu)
+            size_t diff = 0;
+            for (size_t p = 0; p < depth.size(); ++p) {
+                float d = std::abs(depth[p] - depth_pull[p]);
+                max_diff = (std::max)(max_diff, d);
+                diff += (d > 1e-5f) ? 1 : 0;
+            }
+            depth_errors += diff;
+            coverage_errors += (background_mesh != background_pull) ? 1 : 0;
+            std::cout << "pohled " << v << ": " << terrain.visibleTiles() << "/" << terrain.tileCount() << " dlazdic, " << terrain.triangleCount()
+                      << " trojuhelniku, GPU vertex buffer " << ms_mesh << " ms, vertex pulling " << ms_pull << " ms, rozdilna hloubka " << diff
+                      << " px, pozadi " << background_mesh << "/" << background_pull << " px" << std::endl;
+        }
+        std::cout << "Prumer GPU: vertex buffer " << mesh_ms / views << " ms, vertex pulling " << pull_ms / views << " ms, max. rozdil hloubky " << max_diff << std::endl;
+
+        if (depth_errors == 0 && coverage_errors == 0) {
+            std::cout << "Validace: OK (hloubka vertex pullingu odpovida dlazdicim z vertex bufferu)" << std::endl;
+        } else {
+            std::cout << "Validace: CHYBA - " << depth_errors << " pixelu s rozdilnou hloubkou, " << coverage_errors << " pohledu s jinym pokrytim" << std::endl;
+        }
+
+        glDeleteQueries(1, &query);
+        target.destroy();
+        pull_shader.clear();
+        mdi_shader.clear();
+        terrain.clear();
+        batch.clear();
+    }
+
+    destroy_bench_context(window);
+}
+
+// --- Generování vrcholů terénu: čas a škálování podle počtu vláken (4096x4096, 8192x8192) ---
+static void bench_terrain_gen() {
+    const unsigned int tile_size = 64;
+    const unsigned int hardware = (std::max)(std::thread::hardware_concurrency(), 1u);
+    std::vector<unsigned int> thread_counts;
+    for (unsigned int n = 1; n < hardware; n *= 2) {
+        thread_counts.push_back(n);
+    }
+    thread_counts.push_back(hardware);
+    std::cout << "Vlaken (hardware): " << hardware << std::endl;
+
+    size_t errors = 0;
+    for (int map_size : { 4096, 8192 }) {
+        const std::vector<float> heightmap = make_bench_heightmap(map_size);
+        const TerrainTileGrid grid = TerrainMesh::layout(map_size, map_size, 1, tile_size);
+        std::vector<vertex> vertices(grid.vertexCount());   // alokace a první dotyk stránek mimo měření
+        std::cout << "Mapa " << map_size << "x" << map_size << ": " << grid.tileCount() << " dlazdic, " << vertices.size() << " vrcholu ("
+                  << vertices.size() * sizeof(vertex) / (1024.0 * 1024.0) << " MB)" << std::endl;
+
+        // kontrolní součet výstupu - musí být stejný pro každý počet vláken
+        auto checksum = [&]() {
+            double sum = 0.0;
+            for (const vertex& v : vertices) {
+                sum += v.position.y + v.position.x * 1e-3 + v.normal.x + v.normal.z * 0.5 + v.texCoords.y * 1e-4;
+            }
+            return sum;
+        };
+
+        double single_ms = 0.0, reference_sum = 0.0;
+        for (unsigned int threads : thread_counts) {
+            ThreadPool pool(threads);
+            auto t0 = bench_clock::now();
+            TerrainMesh::generate(heightmap.data(), map_size, map_size, map_size, 1, tile_size, vertices.data(), &pool);
+            double ms = elapsed_ms(t0);
+            double sum = checksum();
+            if (threads == thread_counts.front()) {
+                single_ms = ms;
+                reference_sum = sum;
+            } else if (sum != reference_sum) {
+                errors++;
+            }
+            std::cout << "  " << threads << " vlaken: " << ms << " ms, " << vertices.size() / (ms * 1000.0) << " Mvrcholu/s, zrychleni "
+                      << single_ms / ms << "x (ucinnost " << 100.0 * single_ms / ms / threads << " %)" << std::endl;
+        }
+
+        // náhodné vrcholy proti přímému výpočtu jako dřívější sériový GenHeightMap
+        auto height_at = [&](int x, int z) {
+            x = std::clamp(x, 0, map_size - 1);
+            z = std::clamp(z, 0, map_size - 1);
+            return heightmap[static_cast<size_t>(z) * map_size + x];
+        };
+        std::default_random_engine rng(37);
+        std::uniform_int_distribution<size_t> pick(0, vertices.size() - 1);
+        for (int k = 0; k < 100000; ++k) {
+            size_t index = pick(rng);
+            size_t tile = index / grid.tileVertices();
+            size_t local = index % grid.tileVertices();
+            int x = static_cast<int>((tile / grid.tiles_z) * tile_size + local / grid.samples);
+            int z = static_cast<int>((tile % grid.tiles_z) * tile_size + local % grid.samples);
+            glm::vec3 normal = glm::normalize(glm::vec3(height_at(x - 1, z) - height_at(x + 1, z), 2.0f, height_at(x, z - 1) - height_at(x, z + 1)));
+            const vertex& v = vertices[index];
+            // normála z SIMD jádra (rsqrt + Newton) se smí lišit v posledních bitech
+            if (v.position != glm::vec3(x, height_at(x, z), z) || glm::length(v.normal - normal) > 1e-5f || v.texCoords != glm::vec2(x, z)) {
+                errors++;
+            }
+        }
+    }
+
+    if (errors == 0) {
+        std::cout << "Validace: OK (vystup nezavisi na poctu vlaken, vrcholy odpovidaji seriovemu vypoctu)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " neshod" << std::endl;
+    }
+}
+
+// --- SIMD jádro vrcholů terénu: skalár vs. SSE2 vs. AVX2 na jednom vlákně, odchylka od skaláru ---
+static void bench_terrain_simd() {
+    const int map_size = 4096;
+    const unsigned int tile_size = 64;
+    const std::vector<float> heightmap = make_bench_heightmap(map_size);
+    const TerrainTileGrid grid = TerrainMesh::layout(map_size, map_size, 1, tile_size);
+    std::vector<vertex> reference(grid.vertexCount()), vertices(grid.vertexCount());
+    std::cout << "Mapa " << map_size << "x" << map_size << ", " << vertices.size() << " vrcholu, nejlepsi sada v sestaveni: "
+              << TerrainMesh::simdName(TerrainMesh::bestSimd()) << std::endl;
+
+    // nejlepší ze 3 běhů (bez ThreadPool - čisté jádro)
+    auto run = [&](TerrainSimd simd, std::vector<vertex>& out) {
+        double best = 1e30;
+        for (int rep = 0; rep < 3; ++rep) {
+            auto t0 = bench_clock::now();
+            TerrainMesh::generate(heightmap.data(), map_size, map_size, map_size, 1, tile_size, out.data(), nullptr, simd);
+            best = (std::min)(best, elapsed_ms(t0));
+        }
+        return best;
+    };
+
+    const double scalar_ms = run(TERRAIN_SIMD_SCALAR, reference);
+    std::cout << "  " << TerrainMesh::simdName(TERRAIN_SIMD_SCALAR) << ": " << scalar_ms << " ms, " << vertices.size() / (scalar_ms * 1000.0) << " Mvrcholu/s" << std::endl;
+
+    size_t errors = 0;
+    for (TerrainSimd simd : { TERRAIN_SIMD_SSE2, TERRAIN_SIMD_AVX2 }) {
+        if (!TerrainMesh::supportsSimd(simd)) {
+            std::cout << "  " << TerrainMesh::simdName(simd) << ": neni v tomto sestaveni" << std::endl;
+            continue;
+        }
+        std::fill(vertices.begin(), vertices.end(), vertex{});
+        const double ms = run(simd, vertices);
+
+        // pozice a texturové souřadnice přesně, normála s tolerancí (rsqrt + jeden krok Newtona)
+        float max_normal_error = 0.0f;
+        size_t mismatches = 0;
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const vertex& a = reference[i];
+            const vertex& b = vertices[i];
+            float normal_error = (std::max)({ std::abs(a.normal.x - b.normal.x), std::abs(a.normal.y - b.normal.y), std::abs(a.normal.z - b.normal.z) });
+            max_normal_error = (std::max)(max_normal_error, normal_error);
+            if (a.position != b.position || a.texCoords != b.texCoords || normal_error > 1e-5f) {
+                mismatches++;
+            }
+        }
+        errors += mismatches;
+        std::cout << "  " << TerrainMesh::simdName(simd) << ": " << ms << " ms, " << vertices.size() / (ms * 1000.0) << " Mvrcholu/s, zrychleni "
+                  << scalar_ms / ms << "x, max. odchylka normaly " << max_normal_error << ", neshod " << mismatches << std::endl;
+    }
+
+    if (errors == 0) {
+        std::cout << "Validace: OK (SIMD vystup odpovida skalarnimu v toleranci 1e-5)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " vrcholu mimo toleranci" << std::endl;
+    }
+}
+
+// --- Dávkové dotazy na terén: bod po bodu vs. dávka (skalár / SSE2 / AVX2), náhodné a shlukované body ---
+static void bench_terrain_query() {
+    const int map_size = 4096;
+    const size_t count = size_t(1) << 20;
+    const std::vector<float> heightmap = make_bench_heightmap(map_size);
+    const TerrainHeightField field(heightmap.data(), map_size, map_size, map_size);
+    std::cout << "Mapa " << map_size << "x" << map_size << ", " << count << " dotazu, nejlepsi sada v sestaveni: "
+              << TerrainMesh::simdName(TerrainMesh::bestSimd()) << std::endl;
+
+    // 1. Body: rovnoměrně po mapě (každý jinde - cache miss) a shluky kolem 256 míst (NPC ve skupinách),
+    //    asi 5 % bodů mimo mapu kvůli kontrole okrajů
+    std::default_random_engine rng(41);
+    std::uniform_real_distribution<float> uniform(-0.05f * map_size, 1.05f * map_size);
+    std::vector<glm::vec2> centers(256);
+    for (auto& c : centers) {
+        c = glm::vec2(uniform(rng), uniform(rng));
+    }
+    std::normal_distribution<float> spread(0.0f, 20.0f);
+    std::uniform_int_distribution<size_t> pick(0, centers.size() - 1);
+    struct Points {
+        const char* name;
+        std::vector<float> x, z;
+    };
+    std::vector<Points> sets = { { "rovnomerne", {}, {} }, { "shluky", {}, {} } };
+    for (Points& set : sets) {
+        set.x.resize(count);
+        set.z.resize(count);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        sets[0].x[i] = uniform(rng);
+        sets[0].z[i] = uniform(rng);
+        const glm::vec2& c = centers[pick(rng)];
+        sets[1].x[i] = c.x + spread(rng);
+        sets[1].z[i] = c.y + spread(rng);
+    }
+
+    // nejlepší ze 3 běhů
+    auto best_of = [](const std::function<void()>& fn) {
+        double best = 1e30;
+        for (int rep = 0; rep < 3; ++rep) {
+            auto t0 = bench_clock::now();
+            fn();
+            best = (std::min)(best, elapsed_ms(t0));
+        }
+        return best;
+    };
+    auto rate = [&](double ms) { return count / (ms * 1000.0); };
+
+    size_t errors = 0;
+    std::vector<float> ref_h(count), ref_nx(count), ref_ny(count), ref_nz(count);
+    std::vector<float> h(count), nx(count), ny(count), nz(count);
+    for (const Points& set : sets) {
+        // 2. Reference - jednotlivé dotazy jako App::getTerrainHeight / getTerrainNormal
+        const double point_h_ms = best_of([&] {
+            for (size_t i = 0; i < count; ++i) {
+                ref_h[i] = field.height(set.x[i], set.z[i]);
+            }
+        });
+        const double point_n_ms = best_of([&] {
+            for (size_t i = 0; i < count; ++i) {
+                glm::vec3 n = field.normal(set.x[i], set.z[i]);
+                ref_nx[i] = n.x;
+                ref_ny[i] = n.y;
+                ref_nz[i] = n.z;
+            }
+        });
+        std::cout << set.name << ":" << std::endl << "  po bodech: vyska " << rate(point_h_ms) << " M/s, normala " << rate(point_n_ms) << " M/s" << std::endl;
+
+        // 3. Dávky
+        for (TerrainSimd simd : { TERRAIN_SIMD_SCALAR, TERRAIN_SIMD_SSE2, TERRAIN_SIMD_AVX2 }) {
+            if (!TerrainMesh::supportsSimd(simd)) {
+                std::cout << "  davka " << TerrainMesh::simdName(simd) << ": neni v tomto sestaveni" << std::endl;
+                continue;
+            }
+            const double h_ms = best_of([&] { field.heights(set.x.data(), set.z.data(), count, h.data(), simd); });
+            const double n_ms = best_of([&] { field.normals(set.x.data(), set.z.data(), count, nx.data(), ny.data(), nz.data(), simd); });
+
+            // výška s tolerancí na FMA (hodnoty do 255), normála 1e-5
+            float max_h = 0.0f, max_n = 0.0f;
+            size_t mismatches = 0;
+            for (size_t i = 0; i < count; ++i) {
+                float dh = std::abs(h[i] - ref_h[i]);
+                float dn = (std::max)({ std::abs(nx[i] - ref_nx[i]), std::abs(ny[i] - ref_ny[i]), std::abs(nz[i] - ref_nz[i]) });
+                max_h = (std::max)(max_h, dh);
+                max_n = (std::max)(max_n, dn);
+                mismatches += (dh > 1e-4f || dn > 1e-5f) ? 1 : 0;
+            }
+            errors += mismatches;
+            std::cout << "  davka " << TerrainMesh::simdName(simd) << ": vyska " << rate(h_ms) << " M/s (" << point_h_ms / h_ms << "x), normala "
+                      << rate(n_ms) << " M/s (" << point_n_ms / n_ms << "x), max. odchylka " << max_h << " / " << max_n << ", neshod " << mismatches << std::endl;
+        }
+    }
+
+    if (errors == 0) {
+        std::cout << "Validace: OK (davky odpovidaji jednotlivym dotazum vcetne bodu mimo mapu)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " dotazu mimo toleranci" << std::endl;
+    }
+}
+
+// --- Kolize s terénem: výška na vykresleném trojúhelníku a swept sphere proti tunelování ---
+static void bench_terrain_collide() {
+    const int map_size = 1024;
+    const unsigned int tile_size = 64;
+    const std::vector<float> heightmap = make_bench_heightmap(map_size);
+    const TerrainHeightField field(heightmap.data(), map_size, map_size, map_size);
+    size_t errors = 0;
+
+    // 1. Výška a normála proti trojúhelníkům sítě z App::GenHeightMapTiles (vrcholy TerrainMesh::generate, indexy TerrainLod úrovně 0)
+    {
+        const TerrainTileGrid grid = TerrainMesh::layout(map_size, map_size, 1, tile_size);
+        std::vector<vertex> vertices(grid.vertexCount());
+        TerrainMesh::generate(heightmap.data(), map_size, map_size, map_size, 1, tile_size, vertices.data());
+        const std::vector<GLuint> indices = TerrainLod::buildPattern(tile_size, 0, 0);
+        auto at = [&](int x, int z) { return heightmap[static_cast<size_t>(z) * map_size + x]; };
+
+        std::default_random_engine rng(42);
+        std::uniform_real_distribution<float> coord(0.0f, map_size - 1.0f);
+        const int count = 200000;
+        float max_h = 0.0f, max_n = 0.0f, max_bilinear = 0.0f;
+        size_t mismatches = 0;
+        for (int i = 0; i < count; ++i) {
+            const float x = coord(rng), z = coord(rng);
+            const int gx = static_cast<int>(x), gz = static_cast<int>(z);
+            if (gx >= map_size - 1 || gz >= map_size - 1) {
+                continue;
+            }
+            const unsigned int tx = gx / tile_size, tz = gz / tile_size;
+            const vertex* tile = vertices.data() + (static_cast<size_t>(tx) * grid.tiles_z + tz) * grid.tileVertices();
+            const size_t quad = (static_cast<size_t>(gx - tx * tile_size) * tile_size + (gz - tz * tile_size)) * 6;
+            for (int t = 0; t < 2; ++t) {
+                const glm::vec3 a = tile[indices[quad + t * 3]].position;
+                const glm::vec3 b = tile[indices[quad + t * 3 + 1]].position;
+                const glm::vec3 c = tile[indices[quad + t * 3 + 2]].position;
+                // barycentrické souřadnice v rovině xz
+                const float d = (b.z - c.z) * (a.x - c.x) + (c.x - b.x) * (a.z - c.z);
+                const float wa = ((b.z - c.z) * (x - c.x) + (c.x - b.x) * (z - c.z)) / d;
+                const float wb = ((c.z - a.z) * (x - c.x) + (a.x - c.x) * (z - c.z)) / d;
+                const float wc = 1.0f - wa - wb;
+                if (wa < -1e-5f || wb < -1e-5f || wc < -1e-5f) {
+                    continue;
+                }
+                const float mesh_h = wa * a.y + wb * b.y + wc * c.y;
+                glm::vec3 mesh_n = glm::normalize(glm::cross(c - a, b - a));
+                if (mesh_n.y < 0.0f) {
+                    mesh_n = -mesh_n;
+                }
+                const float fx = x - gx, fz = z - gz;
+                const float dh = std::abs(field.height(x, z) - mesh_h);
+                // na úhlopříčce platí normála obou trojúhelníků
+                const float dn = std::abs(fx - fz) < 1e-4f ? 0.0f : glm::length(field.normal(x, z) - mesh_n);
+                max_h = (std::max)(max_h, dh);
+                max_n = (std::max)(max_n, dn);
+                mismatches += (dh > 1e-3f || dn > 1e-4f) ? 1 : 0;
+
+                // dřívější bilineární výška (pro srovnání - o tolik se hráč vznášel / propadal)
+                const float bilinear = (1 - fz) * ((1 - fx) * at(gx, gz) + fx * at(gx + 1, gz)) + fz * ((1 - fx) * at(gx, gz + 1) + fx * at(gx + 1, gz + 1));
+                max_bilinear = (std::max)(max_bilinear, std::abs(bilinear - mesh_h));
+                break;
+            }
+        }
+        errors += mismatches;
+        std::cout << "Vyska/normala proti vykreslenym trojuhelnikum (" << count << " bodu): max. odchylka " << max_h << " / " << max_n
+                  << ", neshod " << mismatches << " (bilinearni vyska az " << max_bilinear << ")" << std::endl;
+    }
+
+    // 2. Rychlé koule přes hřebeny: sweep proti referenci s jemnými kroky (0.05 r), srovnání s testem jen koncové pozice
+    {
+        const float radius = 0.5f;
+        const int shots = 2000;
+        std::default_random_engine rng(43);
+        std::uniform_real_distribution<float> coord(64.0f, map_size - 64.0f);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        std::uniform_real_distribution<float> lift(0.5f, 20.0f);
+        std::uniform_real_distribution<float> length(5.0f, 60.0f);
+        std::uniform_real_distribution<float> dive(-0.3f, 0.05f);
+        struct Shot {
+            glm::vec3 from, to;
+        };
+        std::vector<Shot> set(shots);
+        for (Shot& shot : set) {
+            // start bez dotyku (na strmém svahu se koule nad bodem může dotýkat sousední stěny)
+            do {
+                const float x = coord(rng), z = coord(rng);
+                shot.from = glm::vec3(x, field.height(x, z) + radius + lift(rng), z);
+            } while (field.overlapSphere(shot.from, radius));
+            const float a = angle(rng);
+            shot.to = shot.from + glm::normalize(glm::vec3(std::cos(a), dive(rng), std::sin(a))) * length(rng);
+        }
+
+        std::vector<TerrainHit> hits(shots);
+        std::vector<char> hit(shots);
+        auto t0 = bench_clock::now();
+        for (int i = 0; i < shots; ++i) {
+            hit[i] = field.sweepSphere(set[i].from, set[i].to, radius, hits[i]);
+        }
+        const double sweep_ms = elapsed_ms(t0);
+
+        size_t contacts = 0, naive_tunnels = 0, sweep_tunnels = 0, mismatches = 0;
+        for (int i = 0; i < shots; ++i) {
+            const glm::vec3 v = set[i].to - set[i].from;
+            const int steps = static_cast<int>(std::ceil(glm::length(v) / (0.05f * radius)));
+            float t_ref = -1.0f;
+            for (int k = 0; k <= steps; ++k) {
+                if (field.overlapSphere(set[i].from + v * (static_cast<float>(k) / steps), radius)) {
+                    t_ref = static_cast<float>(k) / steps;
+                    break;
+                }
+            }
+            if (t_ref >= 0.0f) {
+                ++contacts;
+                naive_tunnels += field.overlapSphere(set[i].to, radius) ? 0 : 1;
+                if (!hit[i]) {
+                    ++sweep_tunnels;
+                    continue;
+                }
+                // dotyk nejpozději v prvním překrývajícím kroku a nejdřív o krok dřív
+                if (hits[i].t > t_ref + 1e-4f || hits[i].t < t_ref - 1.0f / steps - 1e-4f) {
+                    ++mismatches;
+                }
+            }
+            // v místě dotyku se koule povrchu dotýká, ale neprotíná ho (kromě dotyku na startu)
+            if (hit[i] && (!field.overlapSphere(hits[i].center, radius * 1.001f) || (hits[i].t > 0.0f && field.overlapSphere(hits[i].center, radius * 0.999f)))) {
+                ++mismatches;
+            }
+        }
+        errors += sweep_tunnels + mismatches;
+        std::cout << "Koule r " << radius << ", " << shots << " pohybu 5-60 jednotek: dotyk " << contacts << ", test koncove pozice propadl "
+                  << naive_tunnels << ", sweep propadl " << sweep_tunnels << ", neshod " << mismatches << ", sweep " << sweep_ms * 1000.0 / shots
+                  << " us/dotaz" << std::endl;
+    }
+
+    if (errors == 0) {
+        std::cout << "Validace: OK (vyska a normala na vykreslenem trojuhelniku, sweep nepropadne hrebenem)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " neshod" << std::endl;
+    }
+}
+
+// --- Fyzika s pevným krokem: dráha hráče při libovolném FPS (bez okna) ---
+// Snímky procházejí stejným sledem jako App::run: vstup za snímek (process_input, skok se drží),
+// advance, kroky fyziky se zrušením skoku po kroku, vykreslovaná poloha = interpolace mezi kroky.
+static void bench_physics() {
+    // rovina jako výšková mapa (swept sphere jako ve hře): každý stisk na zemi je skok a dráhy se při různém
+    // FPS liší jen zpožděním vstupu - na kopcích by rozdíl zesílilo zastavení na strmém svahu
+    // (kolize s kopci ověřuje terrain_collide)
+    const int map_size = 1024;
+    const std::vector<float> heightmap(static_cast<size_t>(map_size) * map_size, 127.5f);
+    const TerrainHeightField field(heightmap.data(), map_size, map_size, map_size);
+    PlayerPhysics physics;
+    physics.setGround({ &field, [&](float x, float z) { return field.height(x, z); }, [&](float x, float z) { return field.normal(x, z); } });
+
+    const double step = 1.0 / 120.0;
+    const double seconds = 60.0;
+    const size_t steps = static_cast<size_t>(seconds / step + 0.5);
+    const double tap_period = 1.5;
+    const float speed = 25.25f;   // Camera::MovementSpeed
+    // skriptovaný vstup podle herního času (čas snímků bez času zahozeného po zásecích): chůze po kruhu,
+    // mezerník stisknutý jen v jednom snímku uprostřed každého úseku tap_period s (skok trvá 1 s)
+    auto move_at = [&](double t) {
+        const float a = static_cast<float>(t * 0.3);
+        return glm::vec3(std::cos(a), 0.0f, std::sin(a)) * speed;
+    };
+    PlayerState start;
+    start.position = glm::vec3(512.0f, field.height(512.0f, 512.0f) + physics.settings().height, 512.0f);
+
+    // reference = nekonečné FPS: vstup vzorkovaný na konci každého kroku, stisk v prvním kroku po něm
+    std::vector<glm::vec3> reference(steps + 1);
+    size_t reference_jumps = 0;
+    {
+        PlayerState state = start;
+        reference[0] = state.position;
+        double next_tap = tap_period / 2.0;
+        for (size_t k = 0; k < steps; ++k) {
+            const double t = (k + 1) * step;
+            PlayerInput input;
+            input.move = move_at(t);
+            if (t >= next_tap) {
+                input.jump = true;
+                next_tap += tap_period;
+            }
+            reference_jumps += physics.step(state, input, static_cast<float>(step)) ? 1 : 0;
+            reference[k + 1] = state.position;
+        }
+    }
+
+    // snímkové časy: pevná FPS a nepravidelné snímky se zásekem 250 ms
+    struct Profile {
+        const char* name;
+        std::function<double(size_t)> frame_time;
+    };
+    std::default_random_engine rng(44);
+    std::uniform_real_distribution<double> jitter(0.002, 0.040);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    const std::vector<Profile> profiles = {
+        { "60 FPS", [](size_t) { return 1.0 / 60.0; } },
+        { "30 FPS", [](size_t) { return 1.0 / 30.0; } },
+        { "144 FPS", [](size_t) { return 1.0 / 144.0; } },
+        { "1000 FPS", [](size_t) { return 1.0 / 1000.0; } },
+        { "5000 FPS", [](size_t) { return 1.0 / 5000.0; } },
+        { "nepravidelne + zaseky", [&](size_t) { return chance(rng) < 0.02 ? 0.25 : jitter(rng); } },
+    };
+
+    size_t errors = 0;
+    for (const Profile& profile : profiles) {
+        FixedTimestep clock(step, 8);
+        PlayerState state = start, previous = start;
+        PlayerInput input;
+        size_t done = 0, frames = 0, taps = 0, jump_steps = 0, jumps = 0;
+        unsigned int max_steps = 0;
+        double wall = 0.0, next_tap = tap_period / 2.0, max_frame = 0.0;
+        float path_error = 0.0f, render_error = 0.0f, render_speed = 0.0f;
+        glm::vec3 last_render = start.position;
+        auto t0 = bench_clock::now();
+        while (done < steps) {
+            const double frame_time = profile.frame_time(frames++);
+            wall += frame_time;
+            max_frame = (std::max)(max_frame, frame_time);
+
+            // process_input: pohyb přepíše každý snímek, stisk skoku se jen nastaví
+            const double t = wall - clock.dropped();
+            input.move = move_at(t);
+            if (t >= next_tap) {
+                input.jump = true;
+                next_tap += tap_period;
+                ++taps;
+            }
+
+            // App::run: kroky fyziky, skok platí jen pro první z nich
+            const unsigned int n = clock.advance(frame_time);
+            max_steps = (std::max)(max_steps, n);
+            for (unsigned int i = 0; i < n && done < steps; ++i) {
+                previous = state;
+                jump_steps += input.jump ? 1 : 0;
+                jumps += physics.step(state, input, static_cast<float>(step)) ? 1 : 0;
+                input.jump = false;
+                ++done;
+                path_error = (std::max)(path_error, glm::length(state.position - reference[done]));
+            }
+
+            // vykreslovaná poloha proti referenci interpolované ve stejném okamžiku (o krok zpět)
+            const float alpha = clock.alpha();
+            if (done > 0) {
+                const glm::vec3 render = glm::mix(previous.position, state.position, alpha);
+                const glm::vec3 expected = glm::mix(reference[done - 1], reference[done], alpha);
+                render_error = (std::max)(render_error, glm::length(render - expected));
+                // bez interpolace by kamera skákala po krocích (při 1000 FPS zdánlivě ~8x rychleji)
+                render_speed = (std::max)(render_speed, glm::length(render - last_render) / static_cast<float>(frame_time));
+                last_render = render;
+            }
+            errors += (alpha >= 0.0f && alpha <= 1.0f) ? 0 : 1;
+        }
+        const double ms = elapsed_ms(t0);
+
+        // vstup snímku se od reference opozdí nejvýš o jeden snímek (+ krok): o tolik se smí lišit chůze i okamžik skoku
+        const float lag = static_cast<float>(max_frame + step);
+        const float tolerance = (speed + physics.settings().jump_speed) * lag + 0.5f;
+        // každý stisk zpracuje právě jeden krok (neztratí se ve snímku bez kroku, neopakuje se) a hráč na zemi vyskočí
+        errors += jump_steps != taps || jumps != taps || jumps != reference_jumps ? 1 : 0;
+        errors += path_error > tolerance ? 1 : 0;
+        errors += render_error > tolerance ? 1 : 0;
+        errors += render_speed > (speed + physics.settings().jump_speed) * 1.05f ? 1 : 0;
+        errors += max_steps > clock.maxSteps() ? 1 : 0;
+        std::cout << profile.name << ": " << frames << " snimku, " << steps << " kroku, max. " << max_steps << " kroku/snimek, zahozeno "
+                  << clock.dropped() << " s, " << 1000.0 * ms / steps << " us/krok, stisku " << taps << ", zpracovano " << jump_steps
+                  << ", skoku " << jumps << " (reference " << reference_jumps << "), odchylka drahy " << path_error
+                  << " m, vykreslene polohy " << render_error << " m (tolerance " << tolerance << " m), max. rychlost kamery " << render_speed << " m/s" << std::endl;
+    }
+
+    // Pro srovnání dřívější proměnný krok (dt = čas snímku): výška skoku z roviny podle FPS
+    {
+        PlayerPhysics flat;
+        flat.setGround({ nullptr, [](float, float) { return 0.0f; }, [](float, float) { return glm::vec3(0.0f, 1.0f, 0.0f); } });
+        auto apex = [&](double dt) {
+            PlayerState state;
+            state.position = glm::vec3(0.0f, flat.settings().height, 0.0f);
+            state.on_ground = true;
+            PlayerInput input;
+            input.jump = true;
+            float top = state.position.y;
+            for (double t = 0.0; t < 2.0; t += dt) {
+                flat.step(state, input, static_cast<float>(dt));
+                input.jump = false;
+                top = (std::max)(top, state.position.y);
+            }
+            return top - flat.settings().height;
+        };
+        std::cout << "Vyska skoku - promenny krok: 30 FPS " << apex(1.0 / 30.0) << ", 144 FPS " << apex(1.0 / 144.0) << ", 1000 FPS " << apex(1.0 / 1000.0)
+                  << "; pevny krok " << 1.0 / step << " Hz: " << apex(step) << " pri kazdem FPS" << std::endl;
+    }
+
+    if (errors == 0) {
+        std::cout << "Validace: OK (kazdy stisk skoku prave v jednom kroku, draha i vykreslena poloha v toleranci reference)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " ztracenych skoku, odchylek drahy nebo chyb interpolace" << std::endl;
+    }
+}
+
+// labyrint jako App::genLabyrinth (chodby po 2 buňkách, '#' = stěna), bez rekurze - 1000x1000 by přetekl zásobník
+static std::vector<uint8_t> make_bench_maze(int size, unsigned int seed) {
+    std::vector<uint8_t> maze(static_cast<size_t>(size) * size, '#');
+    std::default_random_engine rng(seed);
+    std::vector<glm::ivec2> stack = { { 1, 1 } };
+    maze[static_cast<size_t>(size) + 1] = '.';
+    const glm::ivec2 dirs[4] = { { 0, -2 }, { 0, 2 }, { 2, 0 }, { -2, 0 } };
+    while (!stack.empty()) {
+        const glm::ivec2 c = stack.back();
+        glm::ivec2 options[4];
+        int count = 0;
+        for (const glm::ivec2& d : dirs) {
+            const glm::ivec2 n = c + d;
+            if (n.x > 0 && n.x < size - 1 && n.y > 0 && n.y < size - 1 && maze[static_cast<size_t>(n.y) * size + n.x] == '#') {
+                options[count++] = n;
+            }
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+        const glm::ivec2 n = options[std::uniform_int_distribution<int>(0, count - 1)(rng)];
+        maze[static_cast<size_t>(n.y) * size + n.x] = '.';
+        maze[static_cast<size_t>((c.y + n.y) / 2) * size + (c.x + n.x) / 2] = '.';
+        stack.push_back(n);
+    }
+    return maze;
+}
+
+// --- Stěny labyrintu: kapsle vs. AABB buněk s broadphase přímo v mřížce, 10k agentů ---
+static void bench_maze_collide() {
+    const int agents = 10000;
+    const int ticks = 600;
+    const float dt = 1.0f / 120.0f;
+    const float radius = 0.3f, capsule_height = 2.0f, speed = 5.0f;
+    size_t errors = 0;
+
+    // stejný počet agentů v malém a velkém labyrintu - cena kroku nemá záviset na velikosti
+    for (int size : { 101, 1001 }) {
+        const std::vector<uint8_t> maze = make_bench_maze(size, 45);
+        const MazeCollider walls(maze.data(), size, size, size, '#', glm::vec3(0.0f), 1.0f, -0.5f, 0.5f);
+
+        std::default_random_engine rng(46);
+        std::uniform_int_distribution<int> cell(1, size - 2);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        std::vector<glm::vec3> position(agents), velocity(agents);
+        auto heading = [&]() {
+            const float a = angle(rng);
+            return glm::vec3(std::cos(a), 0.0f, std::sin(a)) * speed;
+        };
+        for (int i = 0; i < agents; ++i) {
+            int x, z;
+            do {
+                x = cell(rng);
+                z = cell(rng);
+            } while (walls.isWall(x, z));
+            position[i] = glm::vec3(x, 0.0f, z);
+            velocity[i] = heading();
+        }
+
+        size_t contacts = 0, penetrations = 0, inside_wall = 0;
+        double collide_ms = 0.0;
+        for (int tick = 0; tick < ticks; ++tick) {
+            for (int i = 0; i < agents; ++i) {
+                position[i] += velocity[i] * dt;
+            }
+            auto t0 = bench_clock::now();
+            for (int i = 0; i < agents; ++i) {
+                contacts += walls.collideCapsule(position[i], capsule_height, radius, velocity[i]) ? 1 : 0;
+            }
+            collide_ms += elapsed_ms(t0);
+            for (int i = 0; i < agents; ++i) {
+                // kontrola: kapsle mimo stěny (tolerance na float), střed nikdy v buňce stěny
+                penetrations += walls.overlapsCapsule(position[i], capsule_height, radius, 1e-4f) ? 1 : 0;
+                const glm::ivec2 c = walls.cellAt(position[i].x, position[i].z);
+                inside_wall += walls.isWall(c.x, c.y) ? 1 : 0;
+                // zastavený u stěny (klouzání ubralo většinu rychlosti) -> nový směr
+                if (glm::dot(velocity[i], velocity[i]) < 0.25f * speed * speed) {
+                    velocity[i] = heading();
+                }
+            }
+        }
+        errors += penetrations + inside_wall;
+        std::cout << "Labyrint " << size << "x" << size << ", " << agents << " agentu, " << ticks << " kroku: " << collide_ms * 1e6 / (static_cast<double>(agents) * ticks)
+                  << " ns/agent/krok (" << collide_ms / ticks << " ms/krok), dotyku se stenou " << contacts << ", pruniku " << penetrations << ", ve stene " << inside_wall << std::endl;
+    }
+
+    if (errors == 0) {
+        std::cout << "Validace: OK (zadny agent neprosel stenou ani v ni nezustal)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " pruniku se stenou" << std::endl;
+    }
+}
+
+// --- Agenti: 100k agentů po terénu a v labyrintu, SoA krok po blocích na ThreadPool, cíl 60 Hz ---
+static void bench_agents() {
+    const int map_size = 1024;
+    const int maze_size = 501;                  // labyrint na zplacatělé oblasti jako v App
+    const float flat_height = 100.0f;
+    const size_t agents = 100000;
+    const int ticks = 300;                      // 5 s při 60 Hz
+    const float dt = 1.0f / 60.0f;
+    const double budget_ms = 1000.0 / 60.0;
+
+    std::vector<float> heightmap = make_bench_heightmap(map_size);
+    for (int z = 0; z < maze_size; ++z) {
+        std::fill_n(heightmap.begin() + static_cast<size_t>(z) * map_size, maze_size, flat_height);
+    }
+    const TerrainHeightField field(heightmap.data(), map_size, map_size, map_size);
+    const std::vector<uint8_t> maze = make_bench_maze(maze_size, 47);
+    const MazeCollider walls(maze.data(), maze_size, maze_size, maze_size, '#', glm::vec3(0.0f, flat_height, 0.0f), 1.0f, flat_height - 0.5f, flat_height + 0.5f);
+
+    // polovina agentů v chodbách labyrintu, polovina na kopcích
+    AgentSystem reference;
+    reference.setWorld(&field, &walls);
+    reference.reserve(agents);
+    std::default_random_engine rng(48);
+    std::uniform_int_distribution<int> cell(1, maze_size - 2);
+    std::uniform_real_distribution<float> hills(static_cast<float>(maze_size), static_cast<float>(map_size - 2));
+    std::uniform_real_distribution<float> anywhere(1.0f, static_cast<float>(map_size - 2));
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    while (reference.size() < agents) {
+        glm::vec3 pos;
+        if (reference.size() % 2 == 0) {
+            const int x = cell(rng), z = cell(rng);
+            if (walls.isWall(x, z)) {
+                continue;
+            }
+            pos = glm::vec3(x, 0.0f, z);
+        } else {
+            pos = glm::vec3(hills(rng), 0.0f, anywhere(rng));
+        }
+        pos.y = field.height(pos.x, pos.z) + 1.0f;  // pád na terén v prvních krocích
+        const float a = angle(rng);
+        reference.spawn(pos, glm::vec2(std::cos(a), std::sin(a)));
+    }
+
+    const unsigned int hardware = (std::max)(std::thread::hardware_concurrency(), 1u);
+    std::vector<unsigned int> thread_counts;
+    for (unsigned int n = 1; n < hardware; n *= 2) {
+        thread_counts.push_back(n);
+    }
+    thread_counts.push_back(hardware);
+    std::cout << "Vlaken (hardware): " << hardware << ", agentu " << agents << ", teren " << map_size << "x" << map_size << ", labyrint " << maze_size << "x" << maze_size << std::endl;
+
+    size_t errors = 0;
+    std::vector<float> reference_y;
+    double single_ms = 0.0;
+    for (unsigned int threads : thread_counts) {
+        ThreadPool pool(threads);
+        AgentSystem sim = reference;
+        std::vector<double> tick_ms(ticks);
+        for (int tick = 0; tick < ticks; ++tick) {
+            auto t0 = bench_clock::now();
+            sim.update(dt, &pool);
+            tick_ms[tick] = elapsed_ms(t0);
+        }
+        std::vector<double> sorted = tick_ms;
+        std::sort(sorted.begin(), sorted.end());
+        double mean = 0.0;
+        for (double ms : tick_ms) {
+            mean += ms;
+        }
+        mean /= ticks;
+        const double p99 = sorted[static_cast<size_t>(0.99 * (ticks - 1))];
+        if (threads == thread_counts.front()) {
+            single_ms = mean;
+        }
+
+        // stejný výsledek pro každý počet vláken, nikdo pod terénem ani ve stěně
+        size_t mismatches = 0, below = 0, in_wall = 0, on_ground = 0;
+        for (size_t i = 0; i < sim.size(); ++i) {
+            if (threads == thread_counts.front()) {
+                reference_y.push_back(sim.y[i]);
+            } else if (sim.y[i] != reference_y[i]) {
+                mismatches++;
+            }
+            below += sim.y[i] < field.height(sim.x[i], sim.z[i]) - 1e-3f ? 1 : 0;
+            in_wall += walls.overlapsCapsule(glm::vec3(sim.x[i], sim.y[i], sim.z[i]), sim.settings().height, sim.settings().radius, 1e-4f) ? 1 : 0;
+            on_ground += sim.grounded[i];
+        }
+        errors += mismatches + below + in_wall;
+        std::cout << "  " << threads << " vlaken: " << mean << " ms/krok (p99 " << p99 << "), " << agents / (mean * 1000.0) << " M agentu/s, zrychleni "
+                  << single_ms / mean << "x, rezerva na 60 Hz " << 100.0 * (1.0 - mean / budget_ms) << " %, na zemi " << on_ground
+                  << ", neshod " << mismatches << ", pod terenem " << below << ", ve stene " << in_wall << std::endl;
+    }
+
+    if (errors == 0) {
+        std::cout << "Validace: OK (vysledek nezavisi na poctu vlaken, agenti na terenu a mimo steny)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " chyb" << std::endl;
+    }
+}
+
+// --- Plánovač úloh: režie úlohy, krádeže práce a rozložení snímku po jádrech ---
+static void bench_jobs() {
+    const unsigned int hardware = (std::max)(std::thread::hardware_concurrency(), 1u);
+    std::cout << "Vlaken (hardware): " << hardware << std::endl;
+    size_t errors = 0;
+
+    // režie: prázdné úlohy zadané z hlavního vlákna / z úloh (vlastní fronta pracovníka) a parallelFor
+    for (unsigned int threads : { 1u, hardware }) {
+        ThreadPool pool(threads);
+        const int tasks = 1000000;
+        std::atomic<int> done{ 0 };
+
+        JobCounter flat;
+        auto t0 = bench_clock::now();
+        for (int i = 0; i < tasks; ++i) {
+            pool.submit([&done]() { done.fetch_add(1, std::memory_order_relaxed); }, &flat);
+        }
+        pool.wait(flat);
+        const double flat_ms = elapsed_ms(t0);
+
+        // 1000 rodičů po 1000 dětech - děti jdou do fronty vlákna, které rodiče zpracovává, ostatní kradou
+        JobCounter tree;
+        t0 = bench_clock::now();
+        for (int p = 0; p < 1000; ++p) {
+            pool.submit([&]() {
+                for (int c = 0; c < 999; ++c) {
+                    pool.submit([&done]() { done.fetch_add(1, std::memory_order_relaxed); }, &tree);
+                }
+                done.fetch_add(1, std::memory_order_relaxed);
+            }, &tree);
+        }
+        pool.wait(tree);
+        const double tree_ms = elapsed_ms(t0);
+
+        const int loops = 10000;
+        std::vector<float> data(4096, 1.0f);
+        t0 = bench_clock::now();
+        for (int l = 0; l < loops; ++l) {
+            pool.parallelFor(data.size(), 256, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    data[i] *= 1.0000001f;
+                }
+            });
+        }
+        const double for_ms = elapsed_ms(t0);
+
+        errors += done.load() == 2 * tasks ? 0 : 1;
+        std::cout << "  " << threads << " vlaken: prazdna uloha " << flat_ms * 1e6 / tasks << " ns (z hlavniho vlakna), "
+                  << tree_ms * 1e6 / tasks << " ns (z uloh, s kradezi), parallelFor 4096 prvku " << for_ms * 1000.0 / loops << " us" << std::endl;
+    }
+
+    // závislosti: řetěz A -> B -> C, každá fáze vidí výsledek předchozí
+    {
+        ThreadPool pool(hardware);
+        std::vector<int> stage(3 * 1000, 0);
+        JobCounter a, b, c;
+        for (int i = 0; i < 1000; ++i) {
+            pool.submit([&, i]() { stage[i] = 1; }, &a);
+        }
+        pool.submitAfter(a, [&]() {
+            pool.parallelFor(1000, 100, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    stage[1000 + i] = stage[i] + 1;
+                }
+            });
+        }, &b);
+        pool.submitAfter(b, [&]() {
+            for (int i = 0; i < 1000; ++i) {
+                stage[2000 + i] = stage[1000 + i] + 1;
+            }
+        }, &c);
+        pool.wait(c);
+        pool.wait(b);
+        pool.wait(a);
+        size_t wrong = 0;
+        for (int i = 0; i < 1000; ++i) {
+            wrong += (stage[i] == 1 && stage[1000 + i] == 2 && stage[2000 + i] == 3) ? 0 : 1;
+        }
+        errors += wrong;
+        std::cout << "Zavislosti A -> B -> C: " << (wrong == 0 ? "poradi dodrzeno" : "CHYBA") << std::endl;
+    }
+
+    // profil snímku: simulace agentů, dávkové dotazy na terén a frustum test boxů na jednom plánovači
+    {
+        ThreadPool pool(hardware);
+        const int map_size = 1024;
+        const std::vector<float> heightmap = make_bench_heightmap(map_size);
+        const TerrainHeightField field(heightmap.data(), map_size, map_size, map_size);
+
+        std::default_random_engine rng(49);
+        std::uniform_real_distribution<float> pos(1.0f, static_cast<float>(map_size - 2));
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        AgentSystem agents;
+        agents.setWorld(&field, nullptr);
+        agents.reserve(100000);
+        for (int i = 0; i < 100000; ++i) {
+            const float x = pos(rng), z = pos(rng), a = angle(rng);
+            agents.spawn(glm::vec3(x, field.height(x, z), z), glm::vec2(std::cos(a), std::sin(a)));
+        }
+        const size_t points = 1000000;
+        std::vector<float> qx(points), qz(points), qh(points);
+        for (size_t i = 0; i < points; ++i) {
+            qx[i] = pos(rng);
+            qz[i] = pos(rng);
+        }
+        std::vector<AABB> boxes(points);
+        for (size_t i = 0; i < points; ++i) {
+            const glm::vec3 c(qx[i], 128.0f, qz[i]);
+            boxes[i] = AABB{ c - glm::vec3(1.0f), c + glm::vec3(1.0f) };
+        }
+        std::vector<uint8_t> visible(points);
+        const glm::vec3 eye(map_size * 0.5f, 200.0f, map_size * 0.5f);
+        const Frustum frustum = Frustum::fromMatrix(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f)
+                                                    * glm::lookAt(eye, eye + glm::vec3(1.0f, -0.5f, 0.3f), glm::vec3(0.0f, 1.0f, 0.0f)));
+
+        const int frames = 60;
+        pool.setProfiling(true);
+        pool.resetStats();
+        auto t0 = bench_clock::now();
+        for (int f = 0; f < frames; ++f) {
+            // tři nezávislé části snímku naráz, každá se dál dělí přes parallelFor
+            JobCounter frame;
+            pool.submit([&]() { agents.update(1.0f / 60.0f, &pool); }, &frame);
+            pool.submit([&]() {
+                pool.parallelFor(points, 16384, [&](size_t begin, size_t end) {
+                    field.heights(qx.data() + begin, qz.data() + begin, end - begin, qh.data() + begin);
+                });
+            }, &frame);
+            pool.submit([&]() {
+                pool.parallelFor(points, 16384, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        visible[i] = frustum.intersects(boxes[i]) ? 1 : 0;
+                    }
+                });
+            }, &frame);
+            pool.wait(frame);
+        }
+        const double frame_ms = elapsed_ms(t0) / frames;
+        pool.setProfiling(false);
+
+        std::cout << "Profil snimku (" << frames << " snimku, " << frame_ms << " ms/snimek): agenti 100k + 1M dotazu na teren + 1M boxu proti frustu" << std::endl;
+        const std::vector<ThreadPool::ThreadStats> stats = pool.stats();
+        double busy_total = 0.0;
+        for (size_t t = 0; t < stats.size(); ++t) {
+            busy_total += stats[t].busy_ms;
+            std::cout << "  vlakno " << t << (t == 0 ? " (hlavni)" : "") << ": " << stats[t].jobs / frames << " uloh/snimek, ukradeno "
+                      << stats[t].steals / frames << ", prace " << stats[t].busy_ms / frames << " ms/snimek ("
+                      << 100.0 * stats[t].busy_ms / (frame_ms * frames) << " %)" << std::endl;
+        }
+        std::cout << "  prumerne vytizenych vlaken: " << busy_total / (frame_ms * frames) << " z " << stats.size() << std::endl;
+    }
+
+    if (errors == 0) {
+        std::cout << "Validace: OK (vsechny ulohy provedeny, zavislosti dodrzeny)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " chyb" << std::endl;
+    }
+}
+
+// --- Výšková mapa: chyba 8/16bitové kvantizace a dlaždicový formát mapovaný do paměti ---
+static void bench_heightmap() {
+    size_t errors = 0;
+
+    // 1. Přesnost: mírný svah s jemným vlněním, 8 a 16 bitů proti float (výška i normála)
+    {
+        const int size = 2048;
+        std::vector<float> truth(static_cast<size_t>(size) * size);
+        for (int z = 0; z < size; ++z) {
+            for (int x = 0; x < size; ++x) {
+                truth[static_cast<size_t>(z) * size + x] = 40.0f + 0.05f * x + 6.0f * std::sin(x * 0.004f) * std::cos(z * 0.003f);
+            }
+        }
+        auto normal_at = [&](const std::vector<float>& h, int x, int z) {
+            auto at = [&](int px, int pz) { return h[static_cast<size_t>(std::clamp(pz, 0, size - 1)) * size + std::clamp(px, 0, size - 1)]; };
+            return glm::normalize(glm::vec3(at(x - 1, z) - at(x + 1, z), 2.0f, at(x, z - 1) - at(x, z + 1)));
+        };
+        for (int bits : { 8, 16 }) {
+            // kvantizace celého rozsahu 0..255 na 2^bits úrovní (jako PNG normalizované na 0..255)
+            const float levels = static_cast<float>((1 << bits) - 1);
+            std::vector<float> quantized(truth.size());
+            for (size_t i = 0; i < truth.size(); ++i) {
+                quantized[i] = std::round(truth[i] / 255.0f * levels) / levels * 255.0f;
+            }
+            double max_error = 0.0, angle_sum = 0.0, angle_max = 0.0;
+            size_t flat = 0;
+            for (int z = 1; z < size - 1; ++z) {
+                for (int x = 1; x < size - 1; ++x) {
+                    size_t i = static_cast<size_t>(z) * size + x;
+                    max_error = (std::max)(max_error, static_cast<double>(std::abs(quantized[i] - truth[i])));
+                    float d = glm::dot(normal_at(truth, x, z), normal_at(quantized, x, z));
+                    double angle = std::acos(std::clamp(d, -1.0f, 1.0f)) * 57.29578;
+                    angle_sum += angle;
+                    angle_max = (std::max)(angle_max, angle);
+                    flat += (quantized[i] == quantized[i - 1]) ? 1 : 0;     // schody: stejná výška jako soused
+                }
+            }
+            const double inner = static_cast<double>(size - 2) * (size - 2);
+            std::cout << bits << " bitu: max. chyba vysky " << max_error << ", chyba normaly prumer " << angle_sum / inner << " st. / max " << angle_max
+                      << " st., schodu " << 100.0 * flat / inner << " % vzorku" << std::endl;
+        }
+    }
+
+    // 2. Dlaždicový soubor 8192x8192: zápis, namapování, čtení oblastí kolem kamery a přednačítání
+    {
+        const int map_size = 8192;
+        const std::vector<float> heights = make_bench_heightmap(map_size);
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "bench_heightmap.thm";
+
+        auto t0 = bench_clock::now();
+        HeightMapFile::write(path, heights.data(), map_size, map_size, map_size, 256);
+        double write_ms = elapsed_ms(t0);
+
+        HeightMapFile file;
+        t0 = bench_clock::now();
+        file.open(path);
+        double open_ms = elapsed_ms(t0);
+        std::cout << "Soubor " << map_size << "x" << map_size << " (" << std::filesystem::file_size(path) / (1024.0 * 1024.0) << " MB, "
+                  << file.tilesX() * file.tilesZ() << " dlazdic): zapis " << write_ms << " ms, namapovani " << open_ms << " ms" << std::endl;
+
+        // kamera jede po úhlopříčce, okolí 1024 vzorků se přednačte a přečte okno 512x512 (jako pro dlaždice terénu)
+        const int window = 512;
+        std::vector<float> region(static_cast<size_t>(window) * window);
+        double page_ms = 0.0, read_ms = 0.0;
+        size_t max_resident = 0;
+        const int steps = 64;
+        for (int k = 0; k < steps; ++k) {
+            glm::vec2 camera(200.0f + k * 120.0f, 300.0f + k * 110.0f);
+            t0 = bench_clock::now();
+            max_resident = (std::max)(max_resident, file.pageAround(camera, 1024.0f));
+            page_ms += elapsed_ms(t0);
+
+            int x0 = static_cast<int>(camera.x) - window / 2, z0 = static_cast<int>(camera.y) - window / 2;
+            t0 = bench_clock::now();
+            file.readRegion(x0, z0, window, window, region.data(), window);
+            read_ms += elapsed_ms(t0);
+
+            // kontrola proti zdroji (mimo mapu opakuje okraj)
+            for (int z = 0; z < window; z += 7) {
+                for (int x = 0; x < window; x += 5) {
+                    int sx = std::clamp(x0 + x, 0, map_size - 1), sz = std::clamp(z0 + z, 0, map_size - 1);
+                    if (region[static_cast<size_t>(z) * window + x] != heights[static_cast<size_t>(sz) * map_size + sx]) {
+                        errors++;
+                    }
+                }
+            }
+        }
+        std::default_random_engine rng(39);
+        std::uniform_int_distribution<int> coord(-10, map_size + 10);
+        for (int k = 0; k < 100000; ++k) {
+            int x = coord(rng), z = coord(rng);
+            if (file.sample(x, z) != heights[static_cast<size_t>(std::clamp(z, 0, map_size - 1)) * map_size + std::clamp(x, 0, map_size - 1)]) {
+                errors++;
+            }
+        }
+        std::cout << "Okno " << window << "x" << window << ": cteni " << read_ms / steps << " ms (" << window * window * sizeof(float) / (read_ms / steps * 1000.0)
+                  << " MB/s), prednacteni " << page_ms / steps << " ms, nejvic rezidentnich dlazdic " << max_resident << " / " << file.tilesX() * file.tilesZ() << std::endl;
+
+        file.close();
+        std::filesystem::remove(path);
+    }
+
+    if (errors == 0) {
+        std::cout << "Validace: OK (oblasti i vzorky z namapovaneho souboru odpovidaji zdroji)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " neshod" << std::endl;
+    }
+}
+
+// --- Streamování terénu: průlet nad mapou 4096x4096 z .thm, čas hlavního vlákna na snímek a nahrávání ---
+static void bench_terrain_stream() {
+    GLFWwindow* window = create_bench_context();
+    if (!window) {
+        return;
+    }
+
+    {
+        const int width = 1280, height = 720;
+        const int map_size = 4096;
+        const unsigned int tile_size = 64;
+        const std::vector<float> heightmap = make_bench_heightmap(map_size);
+        auto height_at = [&](int x, int z) {
+            x = std::clamp(x, 0, map_size - 1);
+            z = std::clamp(z, 0, map_size - 1);
+            return heightmap[static_cast<size_t>(z) * map_size + x];
+        };
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "bench_terrain_stream.thm";
+        HeightMapFile::write(path, heightmap.data(), map_size, map_size, map_size, 256);
+
+        HeightMapFile file;
+        file.open(path);
+        TerrainStreamer::Settings settings;
+        settings.tile_size = tile_size;
+        settings.radius = 384.0f;
+        settings.workers = 2;
+        settings.upload_budget_ms = 2.0f;
+        TerrainStreamer streamer;
+        streamer.init(file, settings, 0);
+        std::cout << "Mapa " << map_size << "x" << map_size << ", okruh " << settings.radius << ", " << streamer.stats().capacity << " slotu po "
+                  << streamer.tileBytes() / 1024 << " KB (" << streamer.gpuBytes() / (1024.0 * 1024.0) << " MB VRAM), " << settings.workers << " vlakna" << std::endl;
+
+        ShaderProgram mdi_shader("resources/shaders/phong_mdi.vert", "resources/shaders/phong_mdi.frag");
+        BenchFramebuffer target(width, height);
+        glm::mat4 proj = glm::perspective(glm::radians(60.0f), float(width) / float(height), 0.1f, 2000.0f);
+        auto render = [&](const glm::vec3& eye, const glm::mat4& view, const std::function<void()>& draw) {
+            glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+            glViewport(0, 0, width, height);
+            glClearColor(1.0f, 0.0f, 1.0f, 1.0f);   // BENCH_HOLE_COLOR
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            mdi_shader.activate();
+            mdi_shader.setUniform("uP_m", proj);
+            mdi_shader.setUniform("uV_m", view);
+            mdi_shader.setUniform("u_view_pos", eye);
+            mdi_shader.setUniform("u_heightmap", 1);
+            mdi_shader.setUniform("u_lod_levels", 1);
+            draw();
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        };
+
+        // 1. Průlet po úhlopříčce rychlostí 6 vzorků na snímek (360 / s při 60 FPS) - hlavní vlákno jen update + upload
+        const int frames = 480;
+        double frame_sum = 0.0, frame_max = 0.0;
+        size_t bytes_sum = 0, bytes_max = 0, pending_max = 0, waiting_frames = 0;
+        for (int f = 0; f < frames; ++f) {
+            glm::vec3 eye(400.0f + f * 6.0f, 0.0f, 500.0f + f * 5.0f);
+            eye.y = height_at(int(eye.x), int(eye.z)) + 40.0f;
+            glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.7f, -0.3f, 0.6f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+            auto t0 = bench_clock::now();
+            streamer.update(eye);
+            streamer.upload();
+            double ms = elapsed_ms(t0);
+            render(eye, view, [&] { streamer.draw(Frustum::fromMatrix(proj * view)); });
+            // konec snímku mimo měřený čas (jako swap) - softwarové ovladače jinak kopii do bufferu,
+            // ze kterého se ještě kreslí, serializují s rasterizací předchozího snímku
+            glFinish();
+
+            const TerrainStreamer::Stats& stats = streamer.stats();
+            frame_sum += ms;
+            frame_max = (std::max)(frame_max, ms);
+            bytes_sum += stats.uploaded_bytes;
+            bytes_max = (std::max)(bytes_max, stats.uploaded_bytes);
+            pending_max = (std::max)(pending_max, stats.pending());
+            waiting_frames += streamer.idle() ? 0 : 1;
+            if (f % 80 == 0) {
+                std::cout << "snimek " << f << ": rezidentnich " << stats.resident << ", ceka " << stats.pending() << " (fronta " << stats.queued
+                          << ", vlakna " << stats.loading << ", upload " << stats.ready << "), nahrano " << stats.uploaded_tiles << " dlazdic / "
+                          << stats.uploaded_bytes / (1024.0 * 1024.0) << " MB za " << stats.upload_ms << " ms" << std::endl;
+            }
+        }
+        glFinish();
+        const TerrainStreamer::Stats& stats = streamer.stats();
+        std::cout << "Hlavni vlakno (update + upload): prumer " << frame_sum / frames << " ms, max " << frame_max << " ms | upload prumer "
+                  << bytes_sum / (1024.0 * 1024.0) / frames << " MB/snimek, max " << bytes_max / (1024.0 * 1024.0) << " MB | nejvic cekajicich "
+                  << pending_max << ", snimku s nenactenym okolim " << waiting_frames << "/" << frames << ", vyhozeno (LRU) " << stats.evicted << std::endl;
+
+        // 2. Zastavení a dotažení okolí (vlákna pracují dál, hlavní vlákno jen nahrává)
+        glm::vec3 eye(2000.0f, 0.0f, 2100.0f);
+        eye.y = height_at(int(eye.x), int(eye.z)) + 150.0f;
+        auto t0 = bench_clock::now();
+        int settle_frames = 0;
+        do {
+            streamer.update(eye);
+            streamer.upload();
+            settle_frames++;
+            if (!streamer.idle()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        } while (!streamer.idle() && elapsed_ms(t0) < 10000.0);
+        const bool settled = streamer.idle();
+        std::cout << "Skok na novou pozici: okoli nacteno za " << elapsed_ms(t0) << " ms (" << settle_frames << " snimku)" << std::endl;
+
+        // 3. Reference - dlaždice v okruhu přímo ze zdroje, hloubka musí souhlasit se streamovanými
+        const std::vector<GLuint> indices = TerrainLod::buildPattern(tile_size, 0, 0);
+        StaticBatch batch;
+        for (int tx = 0; tx * int(tile_size) < map_size - 1; ++tx) {
+            for (int tz = 0; tz * int(tile_size) < map_size - 1; ++tz) {
+                glm::vec2 min(tx * float(tile_size), tz * float(tile_size));
+                glm::vec2 d = glm::max(glm::max(min - glm::vec2(eye.x, eye.z), glm::vec2(eye.x, eye.z) - (min + float(tile_size))), glm::vec2(0.0f));
+                if (glm::length(d) >= settings.radius) {
+                    continue;
+                }
+                std::vector<vertex> vertices;
+                vertices.reserve((tile_size + 1) * (tile_size + 1));
+                for (int i = 0; i <= int(tile_size); ++i) {
+                    for (int j = 0; j <= int(tile_size); ++j) {
+                        int x = tx * tile_size + i, z = tz * tile_size + j;
+                        glm::vec3 normal = glm::normalize(glm::vec3(height_at(x - 1, z) - height_at(x + 1, z), 2.0f, height_at(x, z - 1) - height_at(x, z + 1)));
+                        vertices.push_back({ glm::vec3(x, height_at(x, z), z), normal, glm::vec2(x, z) });
+                    }
+                }
+                Mesh mesh(GL_TRIANGLES, vertices, indices, glm::vec3(0.0f), glm::vec3(0.0f));
+                batch.addDraw(batch.addMesh(mesh), glm::mat4(1.0f), 0, glm::vec4(1.0f), DRAW_TERRAIN);
+                mesh.clear();
+            }
+        }
+        batch.upload();
+
+        glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.01f, -1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        std::vector<float> depth_stream(static_cast<size_t>(width) * height), depth_ref(depth_stream.size());
+        render(eye, view, [&] { streamer.draw(Frustum::fromMatrix(proj * view)); });
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, target.fbo);
+        glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, depth_stream.data());
+        const size_t holes = target.countColor(BENCH_HOLE_COLOR);
+        render(eye, view, [&] { batch.draw(); });
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, target.fbo);
+        glReadPixels(0, 0, width, height, GL_DEPTH_COMPONENT, GL_FLOAT, depth_ref.data());
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        size_t depth_errors = 0;
+        for (size_t p = 0; p < depth_ref.size(); ++p) {
+            depth_errors += (std::abs(depth_ref[p] - depth_stream[p]) > 1e-5f) ? 1 : 0;
+        }
+
+        if (settled && holes == 0 && depth_errors == 0 && stats.evicted > 0 && stats.resident <= stats.capacity) {
+            std::cout << "Validace: OK (okoli nacteno, hloubka odpovida dlazdicim ze zdroje, LRU vyhazuje mimo okruh)" << std::endl;
+        } else {
+            std::cout << "Validace: CHYBA - nacteno " << (settled ? "ano" : "ne") << ", der " << holes << " px, rozdilna hloubka " << depth_errors
+                      << " px, vyhozeno " << stats.evicted << std::endl;
+        }
+
+        batch.clear();
+        target.destroy();
+        mdi_shader.clear();
+        streamer.clear();
+        file.close();
+        std::filesystem::remove(path);
+    }
+
+    destroy_bench_context(window);
+}
+
+// --- Nahrávání textur: z paměti + glGenerateTextureMipmap vs. kruh staging bufferů s mip úrovněmi z CPU ---
+static void bench_texture_upload() {
+    GLFWwindow* window = create_bench_context();
+    if (!window) {
+        return;
+    }
+    const int count = 32, size = 1024;
+    const GLsizei levels = TextureUploader::levelCount(size, size);
+    std::vector<std::vector<uint8_t>> images(count, std::vector<uint8_t>(static_cast<size_t>(size) * size * 4));
+    std::mt19937 rng(49);
+    for (auto& image : images) {
+        for (size_t i = 0; i < image.size(); i += 4) {
+            const uint32_t texel = rng();
+            std::memcpy(image.data() + i, &texel, 4);
+        }
+    }
+    const double level0_mb = count * static_cast<double>(size) * size * 4 / (1024.0 * 1024.0);
+    auto make_textures = [&]() {
+        std::vector<GLuint> textures(count);
+        glCreateTextures(GL_TEXTURE_2D, count, textures.data());
+        for (GLuint texture : textures) {
+            glTextureStorage2D(texture, levels, GL_RGBA8, size, size);
+        }
+        glFinish();
+        return textures;
+    };
+    std::cout << count << " textur " << size << "x" << size << " BGRA8, " << levels << " urovni, uroven 0 celkem " << level0_mb << " MB" << std::endl;
+
+    // 1. dosavadní gen_tex: glTextureSubImage2D z paměti + glGenerateTextureMipmap na hlavním vlákně
+    std::vector<GLuint> textures = make_textures();
+    auto t0 = bench_clock::now();
+    for (int i = 0; i < count; ++i) {
+        glTextureSubImage2D(textures[i], 0, 0, 0, size, size, GL_BGRA, GL_UNSIGNED_BYTE, images[i].data());
+        glGenerateTextureMipmap(textures[i]);
+    }
+    const double direct_submit_ms = elapsed_ms(t0);
+    glFinish();
+    const double direct_ms = elapsed_ms(t0);
+    glDeleteTextures(count, textures.data());
+    std::cout << "Z pameti + glGenerateTextureMipmap: " << direct_ms << " ms (hlavni vlakno v GL volanich " << direct_submit_ms << " ms), "
+              << level0_mb / (direct_ms / 1000.0) << " MB/s urovne 0" << std::endl;
+
+    // 2. mip úrovně na CPU (průměr 2x2) - jedno vlákno vs. plánovač
+    std::vector<TextureUploader::MipChain> chains(count);
+    t0 = bench_clock::now();
+    for (int i = 0; i < count; ++i) {
+        chains[i] = TextureUploader::buildMipChain(images[i].data(), size, size, static_cast<size_t>(size) * 4);
+    }
+    const double mips_serial_ms = elapsed_ms(t0);
+    ThreadPool pool;
+    t0 = bench_clock::now();
+    pool.parallelFor(count, 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            chains[i] = TextureUploader::buildMipChain(images[i].data(), size, size, static_cast<size_t>(size) * 4);
+        }
+    });
+    const double mips_pool_ms = elapsed_ms(t0);
+    const double chain_mb = count * chains[0].bytes() / (1024.0 * 1024.0);
+    std::cout << "Mip urovne na CPU: 1 vlakno " << mips_serial_ms << " ms, " << pool.threadCount() << " vlaken " << mips_pool_ms << " ms ("
+              << chain_mb << " MB vcetne mip urovni)" << std::endl;
+
+    // 3. kruh staging bufferů, vše najednou (flush čeká na obsazené úseky)
+    TextureUploader::Settings settings;
+    TextureUploader uploader;
+    uploader.init(settings);
+    textures = make_textures();
+    for (int i = 0; i < count; ++i) {
+        uploader.enqueue(textures[i], -1, chains[i]);
+    }
+    t0 = bench_clock::now();
+    uploader.flush();
+    const double staging_submit_ms = elapsed_ms(t0);
+    glFinish();
+    const double staging_ms = elapsed_ms(t0);
+    std::cout << "Staging (" << settings.slots << " x " << settings.slot_bytes / (1024 * 1024) << " MB), vse najednou: " << staging_ms << " ms (hlavni vlakno "
+              << staging_submit_ms << " ms), " << chain_mb / (staging_ms / 1000.0) << " MB/s vcetne mip urovni, " << level0_mb / (staging_ms / 1000.0) << " MB/s urovne 0" << std::endl;
+
+    // kontrola: všechny úrovně zpět z VRAM proti mip úrovním z CPU
+    size_t errors = 0;
+    std::vector<uint8_t> readback;
+    for (int i = 0; i < count; i += 7) {
+        for (GLsizei level = 0; level < levels; ++level) {
+            const std::vector<uint8_t>& expected = chains[i].levels[level];
+            readback.assign(expected.size(), 0);
+            glGetTextureImage(textures[i], level, GL_BGRA, GL_UNSIGNED_BYTE, static_cast<GLsizei>(readback.size()), readback.data());
+            errors += readback != expected ? 1 : 0;
+        }
+    }
+    glDeleteTextures(count, textures.data());
+
+    // 4. po snímcích s rozpočtem: čas hlavního vlákna na snímek a počet snímků do nahrání všeho
+    textures = make_textures();
+    for (int i = 0; i < count; ++i) {
+        uploader.enqueue(textures[i], -1, std::move(chains[i]));
+    }
+    const size_t waits_before = uploader.stats().fence_waits;
+    int frames = 0;
+    double frame_max = 0.0, frame_sum = 0.0;
+    t0 = bench_clock::now();
+    while (uploader.pending() > 0) {
+        uploader.upload();
+        glFlush();
+        frame_max = (std::max)(frame_max, uploader.stats().upload_ms);
+        frame_sum += uploader.stats().upload_ms;
+        frames++;
+    }
+    glFinish();
+    const double frames_ms = elapsed_ms(t0);
+    std::cout << "Staging po snimcich (rozpocet " << settings.upload_budget_ms << " ms): " << frames << " snimku, upload prumer " << frame_sum / frames
+              << " ms, max " << frame_max << " ms, " << uploader.stats().fence_waits - waits_before << "x obsazeny usek, celkem " << frames_ms << " ms, "
+              << chain_mb / (frames_ms / 1000.0) << " MB/s" << std::endl;
+    glDeleteTextures(count, textures.data());
+    uploader.clear();
+
+    if (errors == 0) {
+        std::cout << "Validace: OK (vsechny urovne ve VRAM odpovidaji mip urovnim z CPU)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " rozdilnych urovni" << std::endl;
+    }
+    destroy_bench_context(window);
+}
+
+// --- Komprimované textury: PNG + mip úrovně + RGBA8 vs. hotové BC1/BC3 z DDS (VRAM, čas načtení, chyba) ---
+static void bench_texture_bc() {
+    GLFWwindow* window = create_bench_context();
+    if (!window) {
+        return;
+    }
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "pg2_bench_bc";
+    const int runs = 3;
+    size_t errors = 0;
+    TextureUploader uploader;
+    uploader.init(TextureUploader::Settings());
+
+    // textura z mip pyramidy přes staging, vrací ms do dokončení na GPU
+    auto upload = [&](const TextureUploader::MipChain& chain, GLuint& texture) {
+        auto t0 = bench_clock::now();
+        glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+        glTextureStorage2D(texture, static_cast<GLsizei>(chain.levels.size()), chain.format ? chain.format : GL_RGBA8, chain.width, chain.height);
+        uploader.enqueue(texture, -1, chain);
+        uploader.flush();
+        glFinish();
+        return elapsed_ms(t0);
+    };
+
+    // PSNR úrovně 0 po kompresi proti zdroji
+    auto psnr_level0 = [](const TextureUploader::MipChain& source, const TextureUploader::MipChain& decoded) {
+        double squared = 0.0;
+        for (size_t i = 0; i < source.levels[0].size(); ++i) {
+            const double d = static_cast<double>(source.levels[0][i]) - decoded.levels[0][i];
+            squared += d * d;
+        }
+        const double mse = squared / source.levels[0].size();
+        return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+    };
+
+    for (const char* file : { "resources/textures/box_rgb888.png", "resources/textures/tex_256.png" }) {
+        // 1. dosavadní cesta: dekódování PNG, mip úrovně na CPU, RGBA8 do VRAM (nejlepší z několika běhů)
+        double png_ms = 1e30;
+        TextureUploader::MipChain source;
+        for (int r = 0; r < runs; ++r) {
+            GLuint texture = 0;
+            auto t0 = bench_clock::now();
+            cv::Mat image = App::load_texture(file);
+            cv::Mat bgra = image;
+            if (image.channels() == 3) {
+                cv::cvtColor(image, bgra, cv::COLOR_BGR2BGRA);
+            }
+            source = TextureUploader::buildMipChain(bgra.data, bgra.cols, bgra.rows, bgra.step);
+            const double decode_ms = elapsed_ms(t0);
+            png_ms = (std::min)(png_ms, decode_ms + upload(source, texture));
+            glDeleteTextures(1, &texture);
+        }
+
+        // 2. první start: komprese do BC1/BC3 a zápis do cache
+        auto t0 = bench_clock::now();
+        const GLenum format = BcEncoder::chooseFormat(source);
+        TextureUploader::MipChain compressed = BcEncoder::compress(source, format);
+        const double encode_ms = elapsed_ms(t0);
+        const std::filesystem::path cache = dir / (std::filesystem::path(file).stem().string() + ".dds");
+        DdsFile::write(cache, { compressed });
+
+        // 3. další starty: hotové bloky z DDS rovnou do VRAM
+        double dds_ms = 1e30;
+        GLuint texture = 0;
+        for (int r = 0; r < runs; ++r) {
+            glDeleteTextures(1, &texture);
+            t0 = bench_clock::now();
+            TextureUploader::MipChain chain = std::move(DdsFile::read(cache).front());
+            const double read_ms = elapsed_ms(t0);
+            dds_ms = (std::min)(dds_ms, read_ms + upload(chain, texture));
+        }
+
+        // chyba komprese (PSNR úrovně 0 proti zdroji) a kontrola VRAM: bloky beze změny, dekódování GPU ~ CPU
+        const TextureUploader::MipChain decoded = BcEncoder::decompress(compressed);
+        const double psnr = psnr_level0(source, decoded);
+
+        std::vector<uint8_t> readback;
+        for (size_t level = 0; level < compressed.levels.size(); ++level) {
+            readback.assign(compressed.levels[level].size(), 0);
+            glGetCompressedTextureImage(texture, static_cast<GLint>(level), static_cast<GLsizei>(readback.size()), readback.data());
+            errors += readback != compressed.levels[level] ? 1 : 0;
+        }
+        readback.assign(decoded.levels[0].size(), 0);
+        glGetTextureImage(texture, 0, GL_BGRA, GL_UNSIGNED_BYTE, static_cast<GLsizei>(readback.size()), readback.data());
+        int gpu_diff = 0;
+        for (size_t i = 0; i < readback.size(); ++i) {
+            gpu_diff = (std::max)(gpu_diff, std::abs(static_cast<int>(readback[i]) - decoded.levels[0][i]));
+        }
+        errors += gpu_diff > 8 ? 1 : 0;   // interpolace palety se mezi ovladači liší o pár jednotek
+        glDeleteTextures(1, &texture);
+
+        std::cout << std::filesystem::path(file).filename().string() << " " << source.width << "x" << source.height << " -> "
+                  << (format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? "BC1" : "BC3") << ": VRAM " << source.bytes() / 1024 << " KB -> "
+                  << compressed.bytes() / 1024 << " KB (" << static_cast<double>(source.bytes()) / compressed.bytes() << "x mene)" << std::endl;
+        std::cout << "  PNG + mip urovne + RGBA8: " << png_ms << " ms, DDS + BCn: " << dds_ms << " ms (" << png_ms / dds_ms
+                  << "x rychleji), komprese pri prvnim startu " << encode_ms << " ms, PSNR " << psnr << " dB, GPU vs CPU dekodovani max " << gpu_diff << std::endl;
+    }
+
+    // změna jen odstínu při podobném jasu (osa kolmá na šedou): šachovnice červená/zelená a přechod
+    // červená -> zelená po řádcích; blok se nesmí slít do jedné barvy
+    {
+        const int size = 64;
+        std::vector<uint8_t> checker(size * size * 4), ramp(size * size * 4);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                uint8_t* c = &checker[(y * size + x) * 4];
+                const bool red = ((x + y) & 1) == 0;
+                c[0] = 0; c[1] = red ? 0 : 255; c[2] = red ? 255 : 0; c[3] = 255;
+                uint8_t* r = &ramp[(y * size + x) * 4];
+                const uint8_t t = static_cast<uint8_t>(x * 255 / (size - 1));
+                r[0] = 0; r[1] = t; r[2] = static_cast<uint8_t>(255 - t); r[3] = 255;
+            }
+        }
+        const std::pair<const char*, const std::vector<uint8_t>*> patterns[] = {
+            { "sachovnice cervena/zelena", &checker }, { "prechod cervena -> zelena", &ramp } };
+        for (const auto& [name, pixels] : patterns) {
+            const TextureUploader::MipChain hue = TextureUploader::buildMipChain(pixels->data(), size, size, size * 4);
+            const double psnr = psnr_level0(hue, BcEncoder::decompress(BcEncoder::compress(hue, GL_COMPRESSED_RGB_S3TC_DXT1_EXT)));
+            errors += psnr < 30.0 ? 1 : 0;
+            std::cout << "Odstin (" << name << ") BC1: PSNR " << psnr << " dB" << std::endl;
+        }
+    }
+
+    uploader.clear();
+    std::filesystem::remove_all(dir);
+    if (errors == 0) {
+        std::cout << "Validace: OK (bloky ve VRAM odpovidaji DDS, dekodovani GPU odpovida CPU, odstin zachovan)" << std::endl;
+    } else {
+        std::cout << "Validace: CHYBA - " << errors << " rozdilnych urovni nebo bloku se ztracenym odstinem" << std::endl;
+    }
+    destroy_bench_context(window);
+}
+
+// --- Start celé aplikace: čas do prvního snímku a do načtení všeho, blokující vs. progresivní start ---
+static void bench_startup() {
+    // první běh čte soubory ze studené cache disku, další už z teplé
+    const int runs = 3;
+    for (App::StartupMode mode : { App::STARTUP_BLOCKING, App::STARTUP_PROGRESSIVE }) {
+        const char* name = mode == App::STARTUP_BLOCKING ? "blokujici" : "progresivni";
+        double first_sum = 0.0, loaded_sum = 0.0;
+        for (int r = 0; r < runs; ++r) {
+            App::StartupMetrics metrics;
+            {
+                App app(mode);
+                app.run(true);
+                metrics = app.startup_metrics();
+            }
+            std::cout << "Start " << name << " (beh " << r + 1 << "): konstruktor " << metrics.constructor_ms << " ms, prvni snimek " << metrics.first_frame_ms
+                      << " ms, vse nacteno " << metrics.loaded_ms << " ms, " << metrics.loading_frames << " snimku se zastupci" << std::endl;
+            first_sum += metrics.first_frame_ms;
+            loaded_sum += metrics.loaded_ms;
+        }
+        std::cout << "Start " << name << " prumer: prvni snimek " << first_sum / runs << " ms, vse nacteno " << loaded_sum / runs << " ms" << std::endl;
+    }
+}
+
+int run_benchmarks(int argc, char* argv[]) {
+    const std::vector<std::pair<std::string, std::function<void()>>> benchmarks = {
+        { "bvh", bench_bvh },
+        { "mdi", bench_mdi },
+        { "gpu_cull", bench_gpu_cull },
+        { "terrain_lod", bench_terrain_lod },
+        { "terrain_tess", bench_terrain_tess },
+        { "terrain_pull", bench_terrain_pull },
+        { "terrain_gen", bench_terrain_gen },
+        { "terrain_simd", bench_terrain_simd },
+        { "heightmap", bench_heightmap },
+        { "terrain_stream", bench_terrain_stream },
+        { "terrain_query", bench_terrain_query },
+        { "terrain_collide", bench_terrain_collide },
+        { "physics", bench_physics },
+        { "maze_collide", bench_maze_collide },
+        { "agents", bench_agents },
+        { "jobs", bench_jobs },
+        { "texture_upload", bench_texture_upload },
+        { "texture_bc", bench_texture_bc },
+        { "startup", bench_startup },
+    };
+
+    std::string which = (argc > 2) ? argv[2] : "all";
+    bool found = false;
+    for (const auto& [name, fn] : benchmarks) {
+        if (which == "all" || which == name) {
+            std::cout << "=== " << name << " ===" << std::endl;
+            fn();
+            found = true;
+        }
+    }
+    if (!found) {
+        std::cerr << "Neznamy benchmark: " << which << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,7 @@
+#ifndef __bench_h__
+#define __bench_h__
+
+// benchmarky spouštěné z příkazové řádky: app --bench <nazev> | all
+int run_benchmarks(int argc, char* argv[]);
+
+#endif //__bench_h__
@@ -1,6 +1,14 @@
 #include "app.h"
+#include "bench.h"
 
 int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        return run_benchmarks(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--convert-heightmap") {
+        return App::convert_heightmap(argc, argv);
+    }
+
     App app;
     app.run();
     return 0;
@@ -0,0 +1,31 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in vec4 aInstance;  // instance: xyz = chodidla agenta, w = natočení kolem y (AgentRenderer)
+
+uniform mat4 uP_m = mat4(1.0f);
+uniform mat4 uV_m = mat4(1.0f);
+uniform float u_scale = 1.0f;
+
+out VS_OUT {
+    vec3 FragPos;
+    vec3 Normal;
+    vec2 TexCoords;
+} vs_out;
+
+void main()
+{
+    // otočení kolem y a stejnoměrné měřítko - matice instance není potřeba, normála se jen otočí
+    float c = cos(aInstance.w);
+    float s = sin(aInstance.w);
+    mat3 rot = mat3(c, 0.0, -s,
+                    0.0, 1.0, 0.0,
+                    s, 0.0, c);
+
+    vs_out.FragPos = aInstance.xyz + rot * (aPos * u_scale);
+    vs_out.Normal = rot * aNormal;
+    vs_out.TexCoords = aTexCoord;
+
+    gl_Position = uP_m * uV_m * vec4(vs_out.FragPos, 1.0f);
+}
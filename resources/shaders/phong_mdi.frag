@@ -0,0 +1,172 @@
+#version 460 core
+
+out vec4 FragColor;
+
+in VS_OUT {
+    vec3 FragPos;
+    vec3 Normal;
+    vec2 TexCoords;
+    flat float Layer;
+    flat uint Flags;
+} fs_in;
+
+struct Material {
+    sampler2DArray diffuse;  // všechny textury materiálů jako vrstvy jednoho pole
+    float shininess;
+};
+
+struct DirLight {
+    vec3 direction;
+    
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct PointLight {
+    vec3 position;
+    
+    float constant;
+    float linear;
+    float quadratic;
+	
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct SpotLight {
+    vec3 position;
+    vec3 direction;
+    float cutOff;
+    float outerCutOff;
+  
+    float constant;
+    float linear;
+    float quadratic;
+  
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+#define NR_POINT_LIGHTS 7
+
+// DrawData.flags (StaticBatch.hpp)
+#define DRAW_TERRAIN 1u
+
+// splat terénu: vrstvy Layer+0..4 = tráva, hlína, skála, led, sníh podle normalizované výšky
+const float TERRAIN_BANDS[4] = float[](0.3, 0.5, 0.8, 0.9);
+const float TERRAIN_BLEND = 0.02;
+
+uniform vec3 u_view_pos;
+uniform DirLight dirLight;
+uniform PointLight pointLights[NR_POINT_LIGHTS];
+uniform SpotLight spotLight;
+uniform Material material;
+
+// barva povrchu fragmentu
+vec3 albedo;
+
+// Function prototypes
+vec3 TerrainAlbedo();
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir);
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+
+void main()
+{    
+    // properties
+    if ((fs_in.Flags & DRAW_TERRAIN) != 0u)
+        albedo = TerrainAlbedo();
+    else
+        albedo = texture(material.diffuse, vec3(fs_in.TexCoords, fs_in.Layer)).rgb;
+    vec3 norm = normalize(fs_in.Normal);
+    vec3 viewDir = normalize(u_view_pos - fs_in.FragPos);
+    
+    // phase 1: directional lighting
+    vec3 result = CalcDirLight(dirLight, norm, viewDir);
+    // phase 2: point lights
+    for(int i = 0; i < NR_POINT_LIGHTS; i++)
+        result += CalcPointLight(pointLights[i], norm, fs_in.FragPos, viewDir);
+    // phase 3: spot light
+    result += CalcSpotLight(spotLight, norm, fs_in.FragPos, viewDir);
+    
+    FragColor = vec4(result, 1.0);
+}
+
+// míchání vrstev terénu podle výšky (plynulý přechod kolem hranice pásma)
+vec3 TerrainAlbedo()
+{
+    float h = fs_in.FragPos.y / 255.0;
+    vec3 color = texture(material.diffuse, vec3(fs_in.TexCoords, fs_in.Layer)).rgb;
+    for (int i = 0; i < 4; i++) {
+        float w = smoothstep(TERRAIN_BANDS[i] - TERRAIN_BLEND, TERRAIN_BANDS[i] + TERRAIN_BLEND, h);
+        color = mix(color, texture(material.diffuse, vec3(fs_in.TexCoords, fs_in.Layer + float(i + 1))).rgb, w);
+    }
+    return color;
+}
+
+// calculates the color when using a directional light.
+vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
+{
+    vec3 lightDir = normalize(-light.direction);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // combine results
+    vec3 ambient  = light.ambient  * albedo;
+    vec3 diffuse  = light.diffuse  * diff * albedo;
+    vec3 specular = light.specular * spec * albedo;
+    return (ambient + diffuse + specular);
+}
+
+// calculates the color when using a point light.
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // attenuation
+    float distance    = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
+    // combine results
+    vec3 ambient  = light.ambient  * albedo;
+    vec3 diffuse  = light.diffuse  * diff * albedo;
+    vec3 specular = light.specular * spec * albedo;
+    ambient  *= attenuation;
+    diffuse  *= attenuation;
+    specular *= attenuation;
+    return (ambient + diffuse + specular);
+}
+
+// calculates the color when using a spot light.
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // attenuation
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    // spotlight intensity
+    float theta = dot(lightDir, normalize(-light.direction)); 
+    float epsilon = light.cutOff - light.outerCutOff;
+    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+    // combine results
+    vec3 ambient = light.ambient * albedo;
+    vec3 diffuse = light.diffuse * diff * albedo;
+    vec3 specular = light.specular * spec * albedo;
+    ambient *= attenuation * intensity;
+    diffuse *= attenuation * intensity;
+    specular *= attenuation * intensity;
+    return (ambient + diffuse + specular);
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+layout (location = 3) in uint aDrawID;    // atribut instance, posunutý o baseInstance příkazu
+
+// data příkazu podle aDrawID (platí i po zhuštění seznamu příkazů na GPU)
+struct DrawData {
+    mat4 model;
+    vec4 diffuse_color;
+    uint texture_layer;
+    uint flags;
+    uint pad0;
+    uint pad1;
+};
+
+layout (std430, binding = 0) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
+
+// DrawData.flags (StaticBatch.hpp)
+#define DRAW_TERRAIN 1u
+
+// geomorphing terénu (TerrainLod.hpp: MAX_LEVELS)
+#define MAX_LOD_LEVELS 8
+
+uniform mat4 uP_m = mat4(1.0f);
+uniform mat4 uV_m = mat4(1.0f);
+uniform vec3 u_view_pos;
+
+uniform sampler2D u_heightmap;              // výšky terénu, texel na vzorek výškové mapy
+uniform int u_terrain_step = 1;             // vzorků výškové mapy mezi sousedními vrcholy terénu
+uniform int u_lod_levels = 1;               // 1 = bez LOD, nic se nemorfuje
+uniform vec2 u_lod_morph[MAX_LOD_LEVELS];   // pro úroveň: vodorovná vzdálenost začátku / konce přechodu na další úroveň
+
+out VS_OUT {
+    vec3 FragPos;
+    vec3 Normal;
+    vec2 TexCoords;
+    flat float Layer;
+    flat uint Flags;
+} vs_out;
+
+float TerrainHeight(ivec2 g);
+float MorphTerrainHeight(vec3 pos);
+
+void main()
+{
+    DrawData d = draws[aDrawID];
+
+    vec3 pos = aPos;
+    if ((d.flags & DRAW_TERRAIN) != 0u)
+        pos.y = MorphTerrainHeight(pos);
+
+    vs_out.FragPos = vec3(d.model * vec4(pos, 1.0));
+    vs_out.Normal = mat3(transpose(inverse(d.model))) * aNormal;
+    vs_out.TexCoords = aTexCoord;
+    vs_out.Layer = float(d.texture_layer);
+    vs_out.Flags = d.flags;
+
+    gl_Position = uP_m * uV_m * vec4(vs_out.FragPos, 1.0f);
+}
+
+float TerrainHeight(ivec2 g)
+{
+    ivec2 texel = clamp(g * u_terrain_step, ivec2(0), textureSize(u_heightmap, 0) - 1);
+    return texelFetch(u_heightmap, texel, 0).r;
+}
+
+// Vrchol, který na další hrubší úrovni zmizí, se s rostoucí vzdáleností kamery posouvá k hrubému povrchu.
+// Výsledek závisí jen na poloze vrcholu a kamery, takže vrcholy sdílené sousedními dlaždicemi
+// (libovolné úrovně) skončí ve stejné výšce a nevzniknou praskliny.
+float MorphTerrainHeight(vec3 pos)
+{
+    ivec2 g = ivec2(round(pos.xz / float(u_terrain_step)));
+    // nejhrubší úroveň, která vrchol obsahuje (rozteč její mřížky je 2^level vrcholů)
+    int level = min(findLSB(g.x | 0x10000), findLSB(g.y | 0x10000));
+    if (level >= u_lod_levels - 1)
+        return pos.y;
+
+    vec2 range = u_lod_morph[level];
+    float k = clamp((distance(pos.xz, u_view_pos.xz) - range.x) / (range.y - range.x), 0.0, 1.0);
+    if (k == 0.0)
+        return pos.y;
+
+    // výška hrubé mřížky v bodě, stejné dělení čtyřúhelníku jako v síti: (p0, p1, p2), (p0, p2, p3)
+    int s = 1 << level;
+    bool odd_x = ((g.x >> level) & 1) != 0;
+    bool odd_z = ((g.y >> level) & 1) != 0;
+    ivec2 offset = ivec2(odd_x ? s : 0, odd_z ? s : 0);  // obě liché: střed hrubého čtyřúhelníku, na jeho úhlopříčce p0-p2
+    float coarse = 0.5 * (TerrainHeight(g - offset) + TerrainHeight(g + offset));
+    return mix(pos.y, coarse, k);
+}
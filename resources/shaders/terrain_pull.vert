@@ -0,0 +1,47 @@
+#version 460 core
+// Terén bez vertex bufferu (TerrainVertexPulling): žádné atributy vrcholů. gl_VertexID je index
+// vrcholu ve sdílené mřížce dlaždice, gl_InstanceID vybere viditelnou dlaždici. Výška a normála
+// se čtou z textury výškové mapy přesně jako u vrcholů, které na CPU počítá TerrainMesh::generate.
+layout (std430, binding = 0) readonly buffer TileBuffer {
+    ivec2 tile_origins[];       // první vzorek každé viditelné dlaždice
+};
+
+out VS_OUT {
+    vec3 FragPos;
+    vec3 Normal;
+    vec2 TexCoords;
+    flat float Layer;
+    flat uint Flags;
+} vs_out;
+
+// DrawData.flags (StaticBatch.hpp)
+#define DRAW_TERRAIN 1u
+
+uniform mat4 uP_m = mat4(1.0f);
+uniform mat4 uV_m = mat4(1.0f);
+
+uniform sampler2D u_heightmap;          // R32F výšky ve světě, texel na vzorek
+uniform int u_tile_size = 64;           // čtyřúhelníků na stranu dlaždice
+uniform uint u_terrain_layer;           // první vrstva terénu v poli materiálů
+
+float Height(ivec2 g)
+{
+    return texelFetch(u_heightmap, clamp(g, ivec2(0), textureSize(u_heightmap, 0) - 1), 0).r;
+}
+
+void main()
+{
+    // index = x * (tile_size + 1) + z, stejné pořadí jako u předpočítaných dlaždic
+    int samples = u_tile_size + 1;
+    ivec2 g = tile_origins[gl_InstanceID] + ivec2(gl_VertexID / samples, gl_VertexID % samples);
+
+    vs_out.FragPos = vec3(g.x, Height(g), g.y);
+    vs_out.Normal = normalize(vec3(Height(g - ivec2(1, 0)) - Height(g + ivec2(1, 0)),
+                                   2.0,
+                                   Height(g - ivec2(0, 1)) - Height(g + ivec2(0, 1))));
+    vs_out.TexCoords = vec2(g);
+    vs_out.Layer = float(u_terrain_layer);
+    vs_out.Flags = DRAW_TERRAIN;
+
+    gl_Position = uP_m * uV_m * vec4(vs_out.FragPos, 1.0);
+}
@@ -0,0 +1,14 @@
+#version 460 core
+// Rohy záplat terénu pro teselaci (TerrainTessellation), bez výšky - tu každému vygenerovanému
+// vrcholu dá evaluation shader z textury výškové mapy.
+layout (location = 0) in vec2 aCorner;        // x, z ve světě
+layout (location = 1) in vec2 aHeightRange;   // min / max výška celé záplaty (culling)
+
+out vec2 vCorner;
+out vec2 vHeightRange;
+
+void main()
+{
+    vCorner = aCorner;
+    vHeightRange = aHeightRange;
+}
@@ -0,0 +1,149 @@
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+
+#include "AgentRenderer.hpp"
+
+void AgentRenderer::init(const Mesh& mesh, float scale) {
+    clear();
+    scale_ = scale;
+
+    // spodek modelu na y = 0, střed podstavy v počátku
+    const glm::vec3 offset(-mesh.bounds.center().x, -mesh.bounds.min.y, -mesh.bounds.center().z);
+    std::vector<vertex> vertices = mesh.vertices;
+    for (auto& v : vertices) {
+        v.position += offset;
+    }
+    local_bounds_ = AABB{ (mesh.bounds.min + offset) * scale, (mesh.bounds.max + offset) * scale };
+    // natočení kolem y - box musí pokrýt model v libovolném směru
+    const float reach = (std::max)({ std::abs(local_bounds_.min.x), std::abs(local_bounds_.max.x), std::abs(local_bounds_.min.z), std::abs(local_bounds_.max.z) }) * std::sqrt(2.0f);
+    local_bounds_.min.x = local_bounds_.min.z = -reach;
+    local_bounds_.max.x = local_bounds_.max.z = reach;
+    index_count_ = mesh.indices.size();
+
+    glCreateVertexArrays(1, &VAO);
+    glCreateBuffers(1, &VBO);
+    glNamedBufferStorage(VBO, vertices.size() * sizeof(vertex), vertices.data(), 0);
+    glCreateBuffers(1, &EBO);
+    glNamedBufferStorage(EBO, mesh.indices.size() * sizeof(GLuint), mesh.indices.data(), 0);
+
+    glVertexArrayVertexBuffer(VAO, 0, VBO, 0, sizeof(vertex));
+    glVertexArrayElementBuffer(VAO, EBO);
+
+    glEnableVertexArrayAttrib(VAO, 0);
+    glVertexArrayAttribFormat(VAO, 0, 3, GL_FLOAT, GL_FALSE, offsetof(vertex, position));
+    glVertexArrayAttribBinding(VAO, 0, 0);
+    glEnableVertexArrayAttrib(VAO, 1);
+    glVertexArrayAttribFormat(VAO, 1, 3, GL_FLOAT, GL_FALSE, offsetof(vertex, normal));
+    glVertexArrayAttribBinding(VAO, 1, 0);
+    glEnableVertexArrayAttrib(VAO, 2);
+    glVertexArrayAttribFormat(VAO, 2, 2, GL_FLOAT, GL_FALSE, offsetof(vertex, texCoords));
+    glVertexArrayAttribBinding(VAO, 2, 0);
+
+    // instance (pozice + natočení), buffer se připojí v update()
+    glEnableVertexArrayAttrib(VAO, 3);
+    glVertexArrayAttribFormat(VAO, 3, 4, GL_FLOAT, GL_FALSE, 0);
+    glVertexArrayAttribBinding(VAO, 3, 1);
+    glVertexArrayBindingDivisor(VAO, 1, 1);
+}
+
+void AgentRenderer::update(const AgentSystem& agents, const Frustum& frustum, ThreadPool* pool) {
+    const size_t count = agents.size();
+    const size_t chunks = (count + AgentSystem::CHUNK - 1) / AgentSystem::CHUNK;
+    agent_visible_.assign(count, 0);
+    chunk_count_.assign(chunks, 0);
+    chunk_offset_.assign(chunks, 0);
+    if (count == 0 || VAO == 0) {
+        instance_count_ = 0;
+        return;
+    }
+    auto for_chunks = [&](const std::function<void(size_t, size_t)>& fn) {
+        if (pool) {
+            pool->parallelFor(count, AgentSystem::CHUNK, fn);
+        } else {
+            fn(0, count);
+        }
+    };
+
+    // 1. box každého agenta bloku proti frustu
+    for_chunks([&](size_t begin, size_t end) {
+        for (size_t c = begin / AgentSystem::CHUNK; c * AgentSystem::CHUNK < end; ++c) {
+            const size_t first = c * AgentSystem::CHUNK, last = (std::min)(first + AgentSystem::CHUNK, count);
+            size_t visible = 0;
+            for (size_t i = first; i < last; ++i) {
+                const glm::vec3 position(agents.x[i], agents.y[i], agents.z[i]);
+                if (frustum.intersects(AABB{ position + local_bounds_.min, position + local_bounds_.max })) {
+                    agent_visible_[i] = 1;
+                    visible++;
+                }
+            }
+            chunk_count_[c] = visible;
+        }
+    });
+
+    // 2. kam který blok zapíše své viditelné agenty
+    instance_count_ = 0;
+    for (size_t c = 0; c < chunks; ++c) {
+        chunk_offset_[c] = instance_count_;
+        instance_count_ += chunk_count_[c];
+    }
+    instances_.resize(instance_count_);
+
+    // 3. instance viditelných agentů (natočení po směru chůze)
+    for_chunks([&](size_t begin, size_t end) {
+        for (size_t c = begin / AgentSystem::CHUNK; c * AgentSystem::CHUNK < end; ++c) {
+            if (chunk_count_[c] == 0) {
+                continue;
+            }
+            const size_t first = c * AgentSystem::CHUNK, last = (std::min)(first + AgentSystem::CHUNK, count);
+            glm::vec4* out = instances_.data() + chunk_offset_[c];
+            for (size_t i = first; i < last; ++i) {
+                if (agent_visible_[i]) {
+                    *out++ = glm::vec4(agents.x[i], agents.y[i], agents.z[i], std::atan2(agents.vx[i], agents.vz[i]));
+                }
+            }
+        }
+    });
+
+    if (instance_count_ == 0) {
+        return;
+    }
+    if (instance_count_ > capacity_) {
+        // buffer roste po dvojnásobcích, nový se musí znovu připojit k VAO
+        capacity_ = (std::max)(instance_count_, capacity_ * 2);
+        glDeleteBuffers(1, &instance_buffer);
+        glCreateBuffers(1, &instance_buffer);
+        glNamedBufferStorage(instance_buffer, capacity_ * sizeof(glm::vec4), nullptr, GL_DYNAMIC_STORAGE_BIT);
+        glVertexArrayVertexBuffer(VAO, 1, instance_buffer, 0, sizeof(glm::vec4));
+    }
+    glNamedBufferSubData(instance_buffer, 0, instance_count_ * sizeof(glm::vec4), instances_.data());
+}
+
+void AgentRenderer::draw(ShaderProgram& shader, GLuint texture) const {
+    if (instance_count_ == 0 || VAO == 0) {
+        return;
+    }
+    shader.activate();
+    shader.setUniform("u_scale", scale_);
+    glBindTextureUnit(0, texture);
+
+    glBindVertexArray(VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(index_count_), GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(instance_count_));
+    glBindVertexArray(0);
+}
+
+void AgentRenderer::clear() {
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glDeleteBuffers(1, &instance_buffer);
+    glDeleteVertexArrays(1, &VAO);
+    VAO = VBO = EBO = instance_buffer = 0;
+
+    instances_.clear();
+    agent_visible_.clear();
+    chunk_count_.clear();
+    chunk_offset_.clear();
+    instance_count_ = 0;
+    capacity_ = 0;
+    index_count_ = 0;
+}
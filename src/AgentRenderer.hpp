@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+#include "Mesh.hpp"
+#include "ShaderProgram.hpp"
+#include "AgentSystem.hpp"
+#include "ThreadPool.hpp"
+
+// Vykreslení agentů (AgentSystem) jedním instancovaným voláním nad jedním meshem (králíček).
+// Instance = vec4 (x, y, z, natočení) v instancovaném atributu 3, matici skládá vertex shader
+// (agent.vert). Mesh se při init posune tak, aby spodek ležel na y = 0 a osa v počátku -
+// pozice agenta je spodek těla. Culling po agentech (box modelu v pozici agenta) v úlohách po blocích
+// AgentSystem::CHUNK (blok jsou indexy, ne oblast - box celého bloku by nevyřadil skoro nic).
+class AgentRenderer {
+public:
+    // kopie geometrie meshe do vlastního VAO, scale = velikost modelu
+    void init(const Mesh& mesh, float scale);
+
+    // instance viditelných agentů z aktuálního stavu (paralelně po blocích)
+    void update(const AgentSystem& agents, const Frustum& frustum, ThreadPool* pool = nullptr);
+
+    // vykreslení (matice a světla nastaví volající, textura na jednotce 0)
+    void draw(ShaderProgram& shader, GLuint texture) const;
+
+    size_t instanceCount() const { return instance_count_; }
+
+    void clear();
+
+private:
+    std::vector<glm::vec4> instances_;
+    std::vector<uint8_t> agent_visible_;
+    std::vector<size_t> chunk_count_;   // viditelných agentů bloku
+    std::vector<size_t> chunk_offset_;  // první instance bloku v instances_
+    size_t instance_count_ = 0;
+    size_t capacity_ = 0;
+    size_t index_count_ = 0;
+    AABB local_bounds_;
+    float scale_ = 1.0f;
+
+    GLuint VAO{ 0 }, VBO{ 0 }, EBO{ 0 };
+    GLuint instance_buffer{ 0 };
+};
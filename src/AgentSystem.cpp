@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cmath>
+
+#include "AgentSystem.hpp"
+
+uint32_t AgentSystem::spawn(const glm::vec3& position, const glm::vec2& direction) {
+    const float length = glm::length(direction);
+    const glm::vec2 velocity = length > 0.0f ? direction / length * settings_.speed : glm::vec2(settings_.speed, 0.0f);
+    x.push_back(position.x);
+    y.push_back(position.y);
+    z.push_back(position.z);
+    vx.push_back(velocity.x);
+    vy.push_back(0.0f);
+    vz.push_back(velocity.y);
+    grounded.push_back(0);
+    return static_cast<uint32_t>(x.size() - 1);
+}
+
+void AgentSystem::reserve(size_t count) {
+    for (auto* v : { &x, &y, &z, &vx, &vy, &vz }) {
+        v->reserve(count);
+    }
+    grounded.reserve(count);
+}
+
+void AgentSystem::clear() {
+    for (auto* v : { &x, &y, &z, &vx, &vy, &vz }) {
+        v->clear();
+    }
+    grounded.clear();
+}
+
+void AgentSystem::update(float dt, ThreadPool* pool) {
+    if (pool) {
+        pool->parallelFor(size(), CHUNK, [this, dt](size_t begin, size_t end) { updateRange(begin, end, dt); });
+    } else {
+        updateRange(0, size(), dt);
+    }
+}
+
+void AgentSystem::updateRange(size_t begin, size_t end, float dt) {
+    const float min_speed2 = 0.25f * settings_.speed * settings_.speed;
+    float ground[BLOCK];
+
+    for (size_t b = begin; b < end; b += BLOCK) {
+        const size_t n = (std::min)(BLOCK, end - b);
+
+        // Gravitace a pohyb (jen pole, žádné větvení kromě příznaku na zemi)
+        for (size_t i = b; i < b + n; ++i) {
+            vy[i] = grounded[i] ? 0.0f : vy[i] + settings_.gravity * dt;
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            z[i] += vz[i] * dt;
+        }
+
+        // Stěny labyrintu - vytlačení a klouzání, zastavený agent se otočí o 90 stupňů
+        if (walls_) {
+            for (size_t i = b; i < b + n; ++i) {
+                glm::vec3 bottom(x[i], y[i], z[i]);
+                glm::vec3 velocity(vx[i], vy[i], vz[i]);
+                if (!walls_->collideCapsule(bottom, settings_.height, settings_.radius, velocity)) {
+                    continue;
+                }
+                x[i] = bottom.x;
+                y[i] = bottom.y;
+                z[i] = bottom.z;
+                vy[i] = velocity.y;
+                const float speed2 = velocity.x * velocity.x + velocity.z * velocity.z;
+                if (speed2 < min_speed2) {
+                    // strana podle indexu - sousední agenti se v chodbě rozejdou
+                    const float turn = (i & 1) ? 1.0f : -1.0f;
+                    const float old_x = vx[i];
+                    vx[i] = -vz[i] * turn;
+                    vz[i] = old_x * turn;
+                } else {
+                    // podél stěny dál plnou rychlostí
+                    const float scale = settings_.speed / std::sqrt(speed2);
+                    vx[i] = velocity.x * scale;
+                    vz[i] = velocity.z * scale;
+                }
+            }
+        }
+
+        // Výška terénu pod celým blokem jedním dávkovým dotazem
+        if (terrain_ && terrain_->valid()) {
+            terrain_->heights(x.data() + b, z.data() + b, n, ground);
+        } else {
+            std::fill(ground, ground + n, 0.0f);
+        }
+
+        // Přistání / stání na terénu (stojící agent sleduje terén i z kopce)
+        for (size_t i = 0; i < n; ++i) {
+            const size_t a = b + i;
+            if (y[a] <= ground[i] || (grounded[a] && y[a] - ground[i] <= settings_.step_down)) {
+                y[a] = ground[i];
+                vy[a] = 0.0f;
+                grounded[a] = 1;
+            } else {
+                grounded[a] = 0;
+            }
+        }
+    }
+}
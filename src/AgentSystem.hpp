@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include "TerrainHeightField.hpp"
+#include "MazeCollider.hpp"
+#include "ThreadPool.hpp"
+
+// Mnoho jednoduchých agentů (NPC) po terénu a v labyrintu. Stav je SoA - pozice, rychlost a příznak
+// na zemi jako samostatná pole, takže krok čte jen to, co potřebuje, a dotazy na výšku terénu jdou
+// dávkově (TerrainHeightField::heights). Krok je rozdělený na bloky po CHUNK agentech, každý blok
+// je úloha pro ThreadPool a zapisuje jen své agenty - výsledek nezávisí na počtu vláken.
+// Krok: gravitace, pohyb, kapsle vs. stěny (MazeCollider), výška terénu pod agentem a přistání.
+// Agent chodí rovně stálou rychlostí, když ho stěna zastaví, otočí se.
+class AgentSystem {
+public:
+    static constexpr size_t CHUNK = 1024;   // agentů na úlohu
+    static constexpr size_t BLOCK = 256;    // agentů na jednu dávku dotazů na terén (pole na zásobníku)
+
+    struct Settings {
+        float gravity = -20.0f;
+        float height = 1.0f;        // výška kapsle těla
+        float radius = 0.3f;        // poloměr (do půl buňky labyrintu)
+        float speed = 2.0f;         // vodorovná rychlost chůze
+        float step_down = 0.3f;     // o kolik může terén pod stojícím agentem klesnout, aniž by začal padat
+    };
+
+    AgentSystem() = default;
+    explicit AgentSystem(const Settings& settings) : settings_(settings) {}
+
+    // terén (nullptr = rovina y = 0) a stěny (nullptr = žádné), musí platit po celou dobu
+    void setWorld(const TerrainHeightField* terrain, const MazeCollider* walls) {
+        terrain_ = terrain;
+        walls_ = walls;
+    }
+    const Settings& settings() const { return settings_; }
+
+    // nový agent na pozici (spodek těla) s vodorovným směrem chůze, vrací index
+    uint32_t spawn(const glm::vec3& position, const glm::vec2& direction);
+    void reserve(size_t count);
+    void clear();
+    size_t size() const { return x.size(); }
+
+    // jeden krok délky dt, pool = nullptr -> na volajícím vlákně
+    void update(float dt, ThreadPool* pool = nullptr);
+    // krok agentů [begin, end) - úloha jednoho bloku
+    void updateRange(size_t begin, size_t end, float dt);
+
+    // SoA stav (indexy = agenti)
+    std::vector<float> x, y, z;         // spodek těla
+    std::vector<float> vx, vy, vz;
+    std::vector<uint8_t> grounded;
+
+private:
+    Settings settings_;
+    const TerrainHeightField* terrain_ = nullptr;
+    const MazeCollider* walls_ = nullptr;
+};
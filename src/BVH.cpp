@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+#include "BVH.hpp"
+
+// zásobník průchodu stromem: při prohledávání do hloubky je na něm nejvýše depth + 1 uzlů,
+// do 64 úrovní stačí pole na zásobníku vlákna, nevyvážený (hlubší) strom si vezme místo z haldy
+template <typename T>
+struct TraversalStack {
+    T local[64];
+    std::vector<T> heap;
+    T* data;
+
+    explicit TraversalStack(uint32_t depth) : data(local) {
+        if (depth + 1 > 64) {
+            heap.resize(depth + 1);
+            data = heap.data();
+        }
+    }
+};
+
+// povrch boxu (pro SAH)
+static float surface_area(const glm::vec3& min, const glm::vec3& max) {
+    glm::vec3 d = max - min;
+    if (d.x < 0.0f || d.y < 0.0f || d.z < 0.0f) return 0.0f;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+// poloha boxu vůči rovině: -1 venku, 0 protíná, 1 celý uvnitř
+static int classify_plane(const glm::vec4& p, const glm::vec3& min, const glm::vec3& max) {
+    glm::vec3 c = (min + max) * 0.5f;
+    glm::vec3 e = (max - min) * 0.5f;
+    float d = p.x * c.x + p.y * c.y + p.z * c.z + p.w;
+    float r = std::fabs(p.x) * e.x + std::fabs(p.y) * e.y + std::fabs(p.z) * e.z;
+    if (d + r < 0.0f) return -1;
+    if (d - r >= 0.0f) return 1;
+    return 0;
+}
+
+// průsečík paprsku s boxem (slab test), vrací vzdálenost vstupu nebo max_t při minutí
+static float ray_box(const glm::vec3& origin, const glm::vec3& inv_dir, const glm::vec3& min, const glm::vec3& max, float max_t) {
+    float tx1 = (min.x - origin.x) * inv_dir.x, tx2 = (max.x - origin.x) * inv_dir.x;
+    float tmin = (std::min)(tx1, tx2), tmax = (std::max)(tx1, tx2);
+    float ty1 = (min.y - origin.y) * inv_dir.y, ty2 = (max.y - origin.y) * inv_dir.y;
+    tmin = (std::max)(tmin, (std::min)(ty1, ty2)); tmax = (std::min)(tmax, (std::max)(ty1, ty2));
+    float tz1 = (min.z - origin.z) * inv_dir.z, tz2 = (max.z - origin.z) * inv_dir.z;
+    tmin = (std::max)(tmin, (std::min)(tz1, tz2)); tmax = (std::min)(tmax, (std::max)(tz1, tz2));
+    if (tmax >= tmin && tmax >= 0.0f && tmin < max_t) {
+        return (std::max)(tmin, 0.0f);
+    }
+    return max_t;
+}
+
+static bool boxes_overlap(const glm::vec3& amin, const glm::vec3& amax, const glm::vec3& bmin, const glm::vec3& bmax) {
+    return amin.x <= bmax.x && amax.x >= bmin.x &&
+           amin.y <= bmax.y && amax.y >= bmin.y &&
+           amin.z <= bmax.z && amax.z >= bmin.z;
+}
+
+void BVH::clear() {
+    nodes_.clear();
+    items_.clear();
+    item_boxes_.clear();
+    depth_ = 0;
+}
+
+void BVH::build(const std::vector<AABB>& boxes) {
+    clear();
+    if (boxes.empty()) {
+        return;
+    }
+
+    items_.resize(boxes.size());
+    std::iota(items_.begin(), items_.end(), 0u);
+    item_boxes_ = boxes;
+
+    std::vector<glm::vec3> centroids(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        centroids[i] = boxes[i].center();
+    }
+
+    // binární strom má nejvýše 2N - 1 uzlů
+    nodes_.reserve(boxes.size() * 2);
+    nodes_.push_back(BVHNode{});
+    subdivide(0, 0, static_cast<uint32_t>(boxes.size()), 0, centroids);
+    nodes_.shrink_to_fit();
+}
+
+void BVH::subdivide(uint32_t node_idx, uint32_t first, uint32_t count, uint32_t depth, std::vector<glm::vec3>& centroids) {
+    depth_ = (std::max)(depth_, depth);
+
+    // bounding box uzlu a jeho centroidů
+    AABB bounds, centroid_bounds;
+    for (uint32_t i = first; i < first + count; ++i) {
+        bounds.expand(item_boxes_[i]);
+        centroid_bounds.expand(centroids[i]);
+    }
+    nodes_[node_idx].min = bounds.min;
+    nodes_[node_idx].max = bounds.max;
+
+    auto make_leaf = [&]() {
+        nodes_[node_idx].left_first = first;
+        nodes_[node_idx].count = count;
+    };
+
+    if (count <= 2) {
+        make_leaf();
+        return;
+    }
+
+    // hledání nejlepšího řezu přes biny (SAH)
+    struct Bin {
+        AABB box;
+        uint32_t count = 0;
+    };
+
+    float best_cost = std::numeric_limits<float>::max();
+    int best_axis = -1;
+    int best_split = 0;
+
+    // řez se hledá jen na nejdelší ose centroidů (3x levnější stavba, kvalita téměř stejná)
+    glm::vec3 centroid_extent = centroid_bounds.max - centroid_bounds.min;
+    int longest_axis = 0;
+    if (centroid_extent.y > centroid_extent[longest_axis]) longest_axis = 1;
+    if (centroid_extent.z > centroid_extent[longest_axis]) longest_axis = 2;
+
+    if (centroid_extent[longest_axis] > 1e-6f) {
+        const int axis = longest_axis;
+        float lo = centroid_bounds.min[axis];
+        float scale = SAH_BINS / centroid_extent[axis];
+
+        Bin bins[SAH_BINS];
+        for (uint32_t i = first; i < first + count; ++i) {
+            int b = (std::min)(SAH_BINS - 1, static_cast<int>((centroids[i][axis] - lo) * scale));
+            bins[b].count++;
+            bins[b].box.expand(item_boxes_[i]);
+        }
+
+        // zleva doprava a zprava doleva kumulované plochy a počty
+        float left_area[SAH_BINS - 1], right_area[SAH_BINS - 1];
+        uint32_t left_count[SAH_BINS - 1], right_count[SAH_BINS - 1];
+        AABB left_box, right_box;
+        uint32_t left_sum = 0, right_sum = 0;
+        for (int i = 0; i < SAH_BINS - 1; ++i) {
+            left_sum += bins[i].count;
+            left_count[i] = left_sum;
+            left_box.expand(bins[i].box);
+            left_area[i] = surface_area(left_box.min, left_box.max);
+
+            right_sum += bins[SAH_BINS - 1 - i].count;
+            right_count[SAH_BINS - 2 - i] = right_sum;
+            right_box.expand(bins[SAH_BINS - 1 - i].box);
+            right_area[SAH_BINS - 2 - i] = surface_area(right_box.min, right_box.max);
+        }
+
+        for (int i = 0; i < SAH_BINS - 1; ++i) {
+            if (left_count[i] == 0 || right_count[i] == 0) {
+                continue;
+            }
+            float cost = left_count[i] * left_area[i] + right_count[i] * right_area[i];
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_axis = axis;
+                best_split = i;
+            }
+        }
+    }
+
+    // cena průchodu uzlem odpovídá zhruba jednomu testu položky
+    float node_area = surface_area(bounds.min, bounds.max);
+    best_cost += SAH_TRAVERSAL_COST * node_area;
+    float leaf_cost = count * node_area;
+    if (best_axis < 0 || (best_cost >= leaf_cost && count <= MAX_LEAF_SIZE)) {
+        if (best_axis < 0 && count > MAX_LEAF_SIZE) {
+            // všechny centroidy v jednom bodě -> rozdělení napůl
+            best_axis = 0;
+        } else {
+            make_leaf();
+            return;
+        }
+    }
+
+    // rozdělení položek podle zvoleného binu (in-place)
+    uint32_t mid = first;
+    if (centroid_bounds.max[best_axis] - centroid_bounds.min[best_axis] > 1e-6f) {
+        float lo = centroid_bounds.min[best_axis];
+        float scale = SAH_BINS / (centroid_bounds.max[best_axis] - lo);
+        uint32_t i = first;
+        uint32_t j = first + count;
+        while (i < j) {
+            int b = (std::min)(SAH_BINS - 1, static_cast<int>((centroids[i][best_axis] - lo) * scale));
+            if (b <= best_split) {
+                ++i;
+            } else {
+                --j;
+                std::swap(items_[i], items_[j]);
+                std::swap(item_boxes_[i], item_boxes_[j]);
+                std::swap(centroids[i], centroids[j]);
+            }
+        }
+        mid = i;
+    }
+    if (mid == first || mid == first + count) {
+        mid = first + count / 2;
+    }
+
+    // potomci se alokují vedle sebe
+    uint32_t left_idx = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(BVHNode{});
+    nodes_.push_back(BVHNode{});
+    nodes_[node_idx].left_first = left_idx;
+    nodes_[node_idx].count = 0;
+
+    subdivide(left_idx, first, mid - first, depth + 1, centroids);
+    subdivide(left_idx + 1, mid, first + count - mid, depth + 1, centroids);
+}
+
+size_t BVH::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const {
+    if (nodes_.empty()) {
+        return 0;
+    }
+
+    // zásobník uzlů spolu s maskou rovin, které je ještě potřeba testovat
+    struct Entry {
+        uint32_t node;
+        uint32_t mask;
+    };
+    TraversalStack<Entry> traversal(depth_);
+    Entry* stack = traversal.data;
+    int sp = 0;
+    stack[sp++] = { 0, 0x3F };
+    size_t tested = 0;
+
+    while (sp > 0) {
+        Entry e = stack[--sp];
+        const BVHNode& node = nodes_[e.node];
+
+        uint32_t mask = e.mask;
+        bool outside = false;
+        if (mask != 0) {
+            tested++;
+            for (int k = 0; k < 6; ++k) {
+                if (!(mask & (1u << k))) continue;
+                int c = classify_plane(frustum.planes[k], node.min, node.max);
+                if (c < 0) {
+                    outside = true;
+                    break;
+                }
+                if (c > 0) {
+                    mask &= ~(1u << k); // uvnitř roviny -> potomci ji už netestují
+                }
+            }
+        }
+        if (outside) {
+            continue;
+        }
+
+        if (node.isLeaf()) {
+            for (uint32_t i = node.left_first; i < node.left_first + node.count; ++i) {
+                if (mask == 0) {
+                    out.push_back(items_[i]);
+                    continue;
+                }
+                tested++;
+                if (frustum.intersects(item_boxes_[i])) {
+                    out.push_back(items_[i]);
+                }
+            }
+        } else {
+            stack[sp++] = { node.left_first, mask };
+            stack[sp++] = { node.left_first + 1, mask };
+        }
+    }
+    return tested;
+}
+
+bool BVH::raycast(const glm::vec3& origin, const glm::vec3& dir, float max_t, uint32_t& hit_item, float& hit_t) const {
+    if (nodes_.empty()) {
+        return false;
+    }
+
+    glm::vec3 inv_dir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+    float best_t = max_t;
+    bool hit = false;
+
+    TraversalStack<uint32_t> traversal(depth_);
+    uint32_t* stack = traversal.data;
+    int sp = 0;
+    if (ray_box(origin, inv_dir, nodes_[0].min, nodes_[0].max, best_t) < best_t) {
+        stack[sp++] = 0;
+    }
+
+    while (sp > 0) {
+        const BVHNode& node = nodes_[stack[--sp]];
+
+        if (node.isLeaf()) {
+            for (uint32_t i = node.left_first; i < node.left_first + node.count; ++i) {
+                float t = ray_box(origin, inv_dir, item_boxes_[i].min, item_boxes_[i].max, best_t);
+                if (t < best_t) {
+                    best_t = t;
+                    hit_item = items_[i];
+                    hit = true;
+                }
+            }
+            continue;
+        }
+
+        // bližší potomek se zpracuje první
+        uint32_t a = node.left_first, b = node.left_first + 1;
+        float ta = ray_box(origin, inv_dir, nodes_[a].min, nodes_[a].max, best_t);
+        float tb = ray_box(origin, inv_dir, nodes_[b].min, nodes_[b].max, best_t);
+        if (ta > tb) {
+            std::swap(a, b);
+            std::swap(ta, tb);
+        }
+        if (tb < best_t) stack[sp++] = b;
+        if (ta < best_t) stack[sp++] = a;
+    }
+
+    if (hit) {
+        hit_t = best_t;
+    }
+    return hit;
+}
+
+void BVH::queryOverlap(const AABB& box, std::vector<uint32_t>& out) const {
+    if (nodes_.empty()) {
+        return;
+    }
+
+    TraversalStack<uint32_t> traversal(depth_);
+    uint32_t* stack = traversal.data;
+    int sp = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0) {
+        const BVHNode& node = nodes_[stack[--sp]];
+        if (!boxes_overlap(node.min, node.max, box.min, box.max)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            for (uint32_t i = node.left_first; i < node.left_first + node.count; ++i) {
+                if (boxes_overlap(item_boxes_[i].min, item_boxes_[i].max, box.min, box.max)) {
+                    out.push_back(items_[i]);
+                }
+            }
+        } else {
+            stack[sp++] = node.left_first;
+            stack[sp++] = node.left_first + 1;
+        }
+    }
+}
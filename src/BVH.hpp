@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+
+// uzel BVH - 32 bajtů, děti vnitřního uzlu leží v poli hned za sebou
+struct BVHNode {
+    glm::vec3 min;
+    uint32_t left_first; // list: index první položky, vnitřní uzel: index levého potomka
+    glm::vec3 max;
+    uint32_t count;      // počet položek v listu (0 => vnitřní uzel)
+
+    bool isLeaf() const { return count > 0; }
+};
+
+// statická BVH nad bounding boxy objektů (SAH stavba, zploštělé pole uzlů)
+class BVH {
+public:
+    // postaví hierarchii, položky jsou identifikovány indexem v poli boxes
+    void build(const std::vector<AABB>& boxes);
+    void clear();
+
+    bool empty() const { return nodes_.empty(); }
+    size_t nodeCount() const { return nodes_.size(); }
+    size_t itemCount() const { return items_.size(); }
+
+    // přidá do out indexy položek, které protínají frustum; vrací počet testovaných boxů
+    size_t queryFrustum(const Frustum& frustum, std::vector<uint32_t>& out) const;
+
+    // nejbližší položka zasažená paprskem (test proti boxům položek)
+    bool raycast(const glm::vec3& origin, const glm::vec3& dir, float max_t, uint32_t& hit_item, float& hit_t) const;
+
+    // přidá do out indexy položek, jejichž box se překrývá s daným boxem
+    void queryOverlap(const AABB& box, std::vector<uint32_t>& out) const;
+
+private:
+    static constexpr int SAH_BINS = 16;
+    static constexpr uint32_t MAX_LEAF_SIZE = 8;
+    static constexpr float SAH_TRAVERSAL_COST = 1.0f;
+
+    void subdivide(uint32_t node_idx, uint32_t first, uint32_t count, uint32_t depth, std::vector<glm::vec3>& centroids);
+
+    std::vector<BVHNode> nodes_;
+    std::vector<uint32_t> items_;     // indexy položek v pořadí listů
+    std::vector<AABB> item_boxes_;    // boxy položek ve stejném pořadí jako items_
+    uint32_t depth_ = 0;              // největší hloubka listu (kořen = 0), určuje velikost zásobníku průchodu
+};
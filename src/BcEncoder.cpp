@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "BcEncoder.hpp"
+
+namespace {
+
+uint16_t pack565(const float rgb[3]) {
+    const int r = static_cast<int>(std::lround(std::clamp(rgb[0], 0.0f, 255.0f) * 31.0f / 255.0f));
+    const int g = static_cast<int>(std::lround(std::clamp(rgb[1], 0.0f, 255.0f) * 63.0f / 255.0f));
+    const int b = static_cast<int>(std::lround(std::clamp(rgb[2], 0.0f, 255.0f) * 31.0f / 255.0f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+void unpack565(uint16_t c, int rgb[3]) {
+    const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+// paleta bloku barev, four = 4barevný režim (BC3 vždy, BC1 při c0 > c1), alpha[3] = 0 v 3barevném režimu BC1
+void colorPalette(uint16_t c0, uint16_t c1, bool four, int palette[4][3], uint8_t alpha[4]) {
+    unpack565(c0, palette[0]);
+    unpack565(c1, palette[1]);
+    for (int c = 0; c < 3; ++c) {
+        if (four) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    alpha[0] = alpha[1] = alpha[2] = 255;
+    alpha[3] = four ? 255 : 0;
+}
+
+// barevná část bloku (8 bajtů), vždy ve 4barevném režimu (c0 > c1, nebo c0 == c1 a všechny indexy 0)
+void encodeColor(const uint8_t bgra[64], uint8_t out[8]) {
+    // průměr a kovariance RGB
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 16; ++i) {
+        mean[0] += bgra[i * 4 + 2];
+        mean[1] += bgra[i * 4 + 1];
+        mean[2] += bgra[i * 4 + 0];
+    }
+    for (float& m : mean) {
+        m /= 16.0f;
+    }
+    float cov[6] = {};   // rr, rg, rb, gg, gb, bb
+    for (int i = 0; i < 16; ++i) {
+        const float r = bgra[i * 4 + 2] - mean[0], g = bgra[i * 4 + 1] - mean[1], b = bgra[i * 4 + 0] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    // hlavní osa mocninnou metodou (pár iterací stačí, jde jen o směr); start ze sloupce kovariance
+    // s největším rozptylem - pevný start (1,1,1) je kolmý na změny odstínu při stejném jasu
+    // (např. červená/zelená) a iterace by v něm uvízla
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    if (cov[0] + cov[3] + cov[5] > 1e-3f) {   // jinak jednobarevný blok, osa nehraje roli
+        if (cov[0] >= cov[3] && cov[0] >= cov[5]) {
+            axis[0] = cov[0]; axis[1] = cov[1]; axis[2] = cov[2];
+        } else if (cov[3] >= cov[5]) {
+            axis[0] = cov[1]; axis[1] = cov[3]; axis[2] = cov[4];
+        } else {
+            axis[0] = cov[2]; axis[1] = cov[4]; axis[2] = cov[5];
+        }
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+            const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+            const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+            const float length = (std::max)({ std::fabs(x), std::fabs(y), std::fabs(z) });
+            if (length < 1e-6f) {
+                break;   // degenerovaná kovariance, ponechá se poslední odhad
+            }
+            axis[0] = x / length;
+            axis[1] = y / length;
+            axis[2] = z / length;
+        }
+    }
+    const float norm = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    for (float& a : axis) {
+        a /= norm;
+    }
+
+    // koncové body = krajní průměty barev bloku na osu
+    float t_min = 0.0f, t_max = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        const float t = (bgra[i * 4 + 2] - mean[0]) * axis[0] + (bgra[i * 4 + 1] - mean[1]) * axis[1] + (bgra[i * 4 + 0] - mean[2]) * axis[2];
+        t_min = (std::min)(t_min, t);
+        t_max = (std::max)(t_max, t);
+    }
+    float end0[3], end1[3];
+    for (int c = 0; c < 3; ++c) {
+        end0[c] = mean[c] + axis[c] * t_max;
+        end1[c] = mean[c] + axis[c] * t_min;
+    }
+    uint16_t c0 = pack565(end0), c1 = pack565(end1);
+    if (c0 < c1) {
+        std::swap(c0, c1);
+    }
+
+    int palette[4][3];
+    uint8_t alpha[4];
+    colorPalette(c0, c1, true, palette, alpha);
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, best_error = INT32_MAX;
+            for (int p = 0; p < 4; ++p) {
+                const int dr = bgra[i * 4 + 2] - palette[p][0], dg = bgra[i * 4 + 1] - palette[p][1], db = bgra[i * 4 + 0] - palette[p][2];
+                const int error = dr * dr + dg * dg + db * db;
+                if (error < best_error) {
+                    best_error = error;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint32_t>(best) << (i * 2);
+        }
+    }
+
+    out[0] = static_cast<uint8_t>(c0 & 0xFF);
+    out[1] = static_cast<uint8_t>(c0 >> 8);
+    out[2] = static_cast<uint8_t>(c1 & 0xFF);
+    out[3] = static_cast<uint8_t>(c1 >> 8);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+void decodeColor(const uint8_t in[8], bool bc1, uint8_t bgra[64]) {
+    const uint16_t c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+    const uint16_t c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+    uint32_t indices;
+    std::memcpy(&indices, in + 4, 4);
+
+    int palette[4][3];
+    uint8_t alpha[4];
+    colorPalette(c0, c1, !bc1 || c0 > c1, palette, alpha);
+    for (int i = 0; i < 16; ++i) {
+        const int p = (indices >> (i * 2)) & 3;
+        bgra[i * 4 + 0] = static_cast<uint8_t>(palette[p][2]);
+        bgra[i * 4 + 1] = static_cast<uint8_t>(palette[p][1]);
+        bgra[i * 4 + 2] = static_cast<uint8_t>(palette[p][0]);
+        bgra[i * 4 + 3] = alpha[p];
+    }
+}
+
+void alphaPalette(uint8_t a0, uint8_t a1, int palette[8]) {
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (int i = 2; i < 8; ++i) {
+            palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+        }
+    } else {
+        for (int i = 2; i < 6; ++i) {
+            palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+// alfa část bloku BC3 (8 bajtů): a0 = max > a1 = min, 3bitové indexy do 8 hodnot
+void encodeAlpha(const uint8_t bgra[64], uint8_t out[8]) {
+    uint8_t a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        a0 = (std::max)(a0, bgra[i * 4 + 3]);
+        a1 = (std::min)(a1, bgra[i * 4 + 3]);
+    }
+    uint64_t indices = 0;
+    if (a0 != a1) {
+        int palette[8];
+        alphaPalette(a0, a1, palette);
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, best_error = INT32_MAX;
+            for (int p = 0; p < 8; ++p) {
+                const int error = std::abs(bgra[i * 4 + 3] - palette[p]);
+                if (error < best_error) {
+                    best_error = error;
+                    best = p;
+                }
+            }
+            indices |= static_cast<uint64_t>(best) << (i * 3);
+        }
+    }
+    out[0] = a0;
+    out[1] = a1;
+    for (int i = 0; i < 6; ++i) {
+        out[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+    }
+}
+
+void decodeAlpha(const uint8_t in[8], uint8_t bgra[64]) {
+    int palette[8];
+    alphaPalette(in[0], in[1], palette);
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i) {
+        indices |= static_cast<uint64_t>(in[2 + i]) << (i * 8);
+    }
+    for (int i = 0; i < 16; ++i) {
+        bgra[i * 4 + 3] = static_cast<uint8_t>(palette[(indices >> (i * 3)) & 7]);
+    }
+}
+
+} // namespace
+
+void BcEncoder::encodeBlockBC1(const uint8_t bgra[64], uint8_t out[8]) {
+    encodeColor(bgra, out);
+}
+
+void BcEncoder::encodeBlockBC3(const uint8_t bgra[64], uint8_t out[16]) {
+    encodeAlpha(bgra, out);
+    encodeColor(bgra, out + 8);
+}
+
+void BcEncoder::decodeBlockBC1(const uint8_t in[8], uint8_t bgra[64]) {
+    decodeColor(in, true, bgra);
+}
+
+void BcEncoder::decodeBlockBC3(const uint8_t in[16], uint8_t bgra[64]) {
+    decodeColor(in + 8, false, bgra);
+    decodeAlpha(in, bgra);
+}
+
+GLenum BcEncoder::chooseFormat(const TextureUploader::MipChain& bgra) {
+    if (!bgra.levels.empty()) {
+        const std::vector<uint8_t>& level = bgra.levels[0];
+        for (size_t i = 3; i < level.size(); i += 4) {
+            if (level[i] != 255) {
+                return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            }
+        }
+    }
+    return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+}
+
+TextureUploader::MipChain BcEncoder::compress(const TextureUploader::MipChain& bgra, GLenum format) {
+    if (bgra.format != 0) {
+        throw std::runtime_error("Komprese BCn potrebuje BGRA8 vstup");
+    }
+    const bool bc1 = format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    if (!bc1 && format != GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) {
+        throw std::runtime_error("Nepodporovany format komprese: " + std::to_string(format));
+    }
+    const size_t block_bytes = TextureUploader::blockBytes(format);
+
+    TextureUploader::MipChain out;
+    out.width = bgra.width;
+    out.height = bgra.height;
+    out.format = format;
+    out.levels.resize(bgra.levels.size());
+    for (size_t level = 0; level < bgra.levels.size(); ++level) {
+        const int w = (std::max)(bgra.width >> level, 1), h = (std::max)(bgra.height >> level, 1);
+        const int blocks_x = (w + 3) / 4, blocks_y = (h + 3) / 4;
+        const uint8_t* src = bgra.levels[level].data();
+        std::vector<uint8_t>& dst = out.levels[level];
+        dst.resize(static_cast<size_t>(blocks_x) * blocks_y * block_bytes);
+
+        uint8_t block[64];
+        for (int by = 0; by < blocks_y; ++by) {
+            for (int bx = 0; bx < blocks_x; ++bx) {
+                // texely bloku, mimo úroveň (2x2, 1x1) se opakuje okraj
+                for (int y = 0; y < 4; ++y) {
+                    const int sy = (std::min)(by * 4 + y, h - 1);
+                    for (int x = 0; x < 4; ++x) {
+                        const int sx = (std::min)(bx * 4 + x, w - 1);
+                        std::memcpy(block + (y * 4 + x) * 4, src + (static_cast<size_t>(sy) * w + sx) * 4, 4);
+                    }
+                }
+                uint8_t* target = dst.data() + (static_cast<size_t>(by) * blocks_x + bx) * block_bytes;
+                if (bc1) {
+                    encodeBlockBC1(block, target);
+                } else {
+                    encodeBlockBC3(block, target);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+TextureUploader::MipChain BcEncoder::decompress(const TextureUploader::MipChain& compressed) {
+    const bool bc1 = compressed.format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || compressed.format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    if (!bc1 && compressed.format != GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) {
+        throw std::runtime_error("Nepodporovany format dekomprese: " + std::to_string(compressed.format));
+    }
+    const size_t block_bytes = TextureUploader::blockBytes(compressed.format);
+
+    TextureUploader::MipChain out;
+    out.width = compressed.width;
+    out.height = compressed.height;
+    out.levels.resize(compressed.levels.size());
+    for (size_t level = 0; level < compressed.levels.size(); ++level) {
+        const int w = (std::max)(compressed.width >> level, 1), h = (std::max)(compressed.height >> level, 1);
+        const int blocks_x = (w + 3) / 4, blocks_y = (h + 3) / 4;
+        std::vector<uint8_t>& dst = out.levels[level];
+        dst.resize(static_cast<size_t>(w) * h * 4);
+
+        uint8_t block[64];
+        for (int by = 0; by < blocks_y; ++by) {
+            for (int bx = 0; bx < blocks_x; ++bx) {
+                const uint8_t* source = compressed.levels[level].data() + (static_cast<size_t>(by) * blocks_x + bx) * block_bytes;
+                if (bc1) {
+                    decodeBlockBC1(source, block);
+                } else {
+                    decodeBlockBC3(source, block);
+                }
+                for (int y = 0; y < 4 && by * 4 + y < h; ++y) {
+                    for (int x = 0; x < 4 && bx * 4 + x < w; ++x) {
+                        std::memcpy(dst.data() + (static_cast<size_t>(by * 4 + y) * w + bx * 4 + x) * 4, block + (y * 4 + x) * 4, 4);
+                    }
+                }
+            }
+        }
+    }
+    return out;
+}
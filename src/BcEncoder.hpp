@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+#include "TextureUploader.hpp"
+
+// Komprese textur do BC1 (DXT1, RGB 4 bity/texel) a BC3 (DXT5, RGBA 8 bitů/texel) na CPU.
+// Blok 4x4: koncové barvy z hlavní osy barev bloku (mocninná metoda nad kovariancí), indexy nejbližší
+// barvou palety. Rychlé a deterministické, kvalitou pod offline kompresory - stačí na první start,
+// výsledek se uloží do cache (DdsFile) a další starty už jen čtou hotové bloky.
+// BC7 se nekomprimuje, jen načítá z hotových souborů (offline nástroje).
+class BcEncoder {
+public:
+    // BC1, když je celá úroveň 0 neprůhledná (alfa 255), jinak BC3
+    static GLenum chooseFormat(const TextureUploader::MipChain& bgra);
+
+    // všechny úrovně BGRA8 do format (GL_COMPRESSED_RGB_S3TC_DXT1_EXT / GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+    static TextureUploader::MipChain compress(const TextureUploader::MipChain& bgra, GLenum format);
+    // zpět na BGRA8 (kontrola chyby komprese, benchmark)
+    static TextureUploader::MipChain decompress(const TextureUploader::MipChain& compressed);
+
+    // jeden blok, bgra = 16 texelů po řádcích
+    static void encodeBlockBC1(const uint8_t bgra[64], uint8_t out[8]);
+    static void encodeBlockBC3(const uint8_t bgra[64], uint8_t out[16]);
+    static void decodeBlockBC1(const uint8_t in[8], uint8_t bgra[64]);
+    static void decodeBlockBC3(const uint8_t in[16], uint8_t bgra[64]);
+};
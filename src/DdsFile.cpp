@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "DdsFile.hpp"
+
+namespace {
+
+// DDS_HEADER (124 B) jako pole uint32, indexy polí podle specifikace DirectX
+enum : size_t {
+    H_SIZE = 0, H_FLAGS = 1, H_HEIGHT = 2, H_WIDTH = 3, H_LINEAR_SIZE = 4, H_DEPTH = 5, H_MIP_COUNT = 6,
+    H_PF_SIZE = 18, H_PF_FLAGS = 19, H_PF_FOURCC = 20, H_CAPS = 26, H_CAPS2 = 27,
+    HEADER_WORDS = 31
+};
+// DDS_HEADER_DXT10 (20 B)
+enum : size_t {
+    D_FORMAT = 0, D_DIMENSION = 1, D_MISC = 2, D_ARRAY_SIZE = 3, D_MISC2 = 4,
+    DX10_WORDS = 5
+};
+
+constexpr uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000;
+constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+constexpr uint32_t DDPF_ALPHAPIXELS = 0x1, DDPF_FOURCC = 0x4;
+constexpr uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200, DDSCAPS2_VOLUME = 0x200000;
+constexpr uint32_t DIMENSION_TEXTURE2D = 3;
+constexpr uint32_t ALPHA_MODE_MASK = 0x7, ALPHA_MODE_STRAIGHT = 1, ALPHA_MODE_OPAQUE = 3;   // miscFlags2 (DX10)
+constexpr uint32_t DXGI_BC1_UNORM = 71, DXGI_BC3_UNORM = 77, DXGI_BC7_UNORM = 98;
+
+constexpr uint32_t fourCC(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+constexpr uint32_t FOURCC_DXT1 = fourCC('D', 'X', 'T', '1');
+constexpr uint32_t FOURCC_DXT5 = fourCC('D', 'X', 'T', '5');
+constexpr uint32_t FOURCC_DX10 = fourCC('D', 'X', '1', '0');
+
+GLenum formatFromDxgi(uint32_t dxgi) {
+    switch (dxgi) {
+    case DXGI_BC1_UNORM: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    case DXGI_BC3_UNORM: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case DXGI_BC7_UNORM: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    default: return 0;
+    }
+}
+
+uint32_t dxgiFromFormat(GLenum format) {
+    switch (format) {
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT: return DXGI_BC1_UNORM;
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT: return DXGI_BC3_UNORM;
+    case GL_COMPRESSED_RGBA_BPTC_UNORM: return DXGI_BC7_UNORM;
+    default: return 0;
+    }
+}
+
+size_t levelBytes(GLenum format, int width, int height, size_t level) {
+    const size_t w = (std::max)(width >> level, 1), h = (std::max)(height >> level, 1);
+    return (w + 3) / 4 * ((h + 3) / 4) * TextureUploader::blockBytes(format);
+}
+
+} // namespace
+
+void DdsFile::write(const std::filesystem::path& path, const std::vector<TextureUploader::MipChain>& layers) {
+    if (layers.empty() || layers[0].levels.empty()) {
+        throw std::runtime_error("Prazdna textura pro DDS: " + path.string());
+    }
+    const TextureUploader::MipChain& first = layers[0];
+    const uint32_t dxgi = dxgiFromFormat(first.format);
+    if (dxgi == 0) {
+        throw std::runtime_error("Nepodporovany format DDS: " + path.string());
+    }
+    for (const auto& layer : layers) {
+        if (layer.width != first.width || layer.height != first.height || layer.format != first.format || layer.levels.size() != first.levels.size()) {
+            throw std::runtime_error("Vrstvy DDS se lisi rozmerem nebo formatem: " + path.string());
+        }
+        for (size_t level = 0; level < layer.levels.size(); ++level) {
+            if (layer.levels[level].size() != levelBytes(layer.format, layer.width, layer.height, level)) {
+                throw std::runtime_error("Neplatna velikost urovne DDS: " + path.string());
+            }
+        }
+    }
+
+    uint32_t header[HEADER_WORDS] = {};
+    header[H_SIZE] = HEADER_WORDS * 4;
+    header[H_FLAGS] = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header[H_HEIGHT] = static_cast<uint32_t>(first.height);
+    header[H_WIDTH] = static_cast<uint32_t>(first.width);
+    header[H_LINEAR_SIZE] = static_cast<uint32_t>(first.levels[0].size());
+    header[H_MIP_COUNT] = static_cast<uint32_t>(first.levels.size());
+    header[H_PF_SIZE] = 32;
+    // BC1 bez alfy (GL_COMPRESSED_RGB_S3TC_DXT1_EXT) vs. s průhledností 1 bit - čtení vrátí stejný formát
+    const bool alpha = first.format != GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    header[H_PF_FLAGS] = DDPF_FOURCC | (alpha ? DDPF_ALPHAPIXELS : 0);
+    header[H_CAPS] = DDSCAPS_TEXTURE | (first.levels.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+    // starší nástroje znají jen FourCC, DX10 jen tam, kde je potřeba (pole, BC7)
+    const bool dx10 = layers.size() > 1 || dxgi == DXGI_BC7_UNORM;
+    header[H_PF_FOURCC] = dx10 ? FOURCC_DX10 : (dxgi == DXGI_BC1_UNORM ? FOURCC_DXT1 : FOURCC_DXT5);
+
+    // přes dočasný soubor - přerušený zápis nenechá v cache poloviční soubor, vlastní jméno pro každý zápis
+    // (souběžné zápisy stejné cache si nepřepisují rozepsaný soubor)
+    static std::atomic<unsigned int> temp_counter{ 0 };
+    std::filesystem::create_directories(path.parent_path());
+    std::filesystem::path temp = path;
+    temp += ".tmp" + std::to_string(temp_counter.fetch_add(1));
+    {
+        std::ofstream out(temp, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Nelze zapsat DDS: " + path.string());
+        }
+        const uint32_t magic = MAGIC;
+        out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        if (dx10) {
+            uint32_t extension[DX10_WORDS] = {};
+            extension[D_FORMAT] = dxgi;
+            extension[D_DIMENSION] = DIMENSION_TEXTURE2D;
+            extension[D_ARRAY_SIZE] = static_cast<uint32_t>(layers.size());
+            extension[D_MISC2] = alpha ? ALPHA_MODE_STRAIGHT : ALPHA_MODE_OPAQUE;
+            out.write(reinterpret_cast<const char*>(extension), sizeof(extension));
+        }
+        for (const auto& layer : layers) {
+            for (const auto& level : layer.levels) {
+                out.write(reinterpret_cast<const char*>(level.data()), level.size());
+            }
+        }
+        if (!out) {
+            out.close();
+            std::filesystem::remove(temp);
+            throw std::runtime_error("Chyba zapisu DDS: " + path.string());
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error) {
+        std::filesystem::remove(temp, error);
+        throw std::runtime_error("Nelze prejmenovat DDS: " + path.string());
+    }
+}
+
+std::vector<TextureUploader::MipChain> DdsFile::read(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Nelze otevrit DDS: " + path.string());
+    }
+
+    uint32_t magic = 0;
+    uint32_t header[HEADER_WORDS] = {};
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || magic != MAGIC || header[H_SIZE] != HEADER_WORDS * 4 || header[H_WIDTH] == 0 || header[H_HEIGHT] == 0) {
+        throw std::runtime_error("Neplatna hlavicka DDS: " + path.string());
+    }
+    if ((header[H_PF_FLAGS] & DDPF_FOURCC) == 0 || (header[H_CAPS2] & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) != 0) {
+        throw std::runtime_error("DDS neni komprimovana 2D textura: " + path.string());
+    }
+
+    GLenum format = 0;
+    uint32_t array_size = 1;
+    if (header[H_PF_FOURCC] == FOURCC_DX10) {
+        uint32_t extension[DX10_WORDS] = {};
+        in.read(reinterpret_cast<char*>(extension), sizeof(extension));
+        if (!in || extension[D_DIMENSION] != DIMENSION_TEXTURE2D) {
+            throw std::runtime_error("DDS neni komprimovana 2D textura: " + path.string());
+        }
+        format = formatFromDxgi(extension[D_FORMAT]);
+        array_size = (std::max)(extension[D_ARRAY_SIZE], 1u);
+        // neznámý režim alfy (cizí nástroje) zůstává RGBA - zachová průhlednost 1 bit
+        if (format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT && (extension[D_MISC2] & ALPHA_MODE_MASK) == ALPHA_MODE_OPAQUE) {
+            format = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        }
+    } else if (header[H_PF_FOURCC] == FOURCC_DXT1) {
+        format = (header[H_PF_FLAGS] & DDPF_ALPHAPIXELS) ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    } else if (header[H_PF_FOURCC] == FOURCC_DXT5) {
+        format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    }
+    if (format == 0) {
+        throw std::runtime_error("Nepodporovany format DDS (jen BC1/BC3/BC7): " + path.string());
+    }
+
+    const int width = static_cast<int>(header[H_WIDTH]), height = static_cast<int>(header[H_HEIGHT]);
+    const size_t levels = (header[H_FLAGS] & DDSD_MIPMAPCOUNT) && header[H_MIP_COUNT] > 0 ? header[H_MIP_COUNT] : 1;
+    if (levels > static_cast<size_t>(TextureUploader::levelCount(width, height))) {
+        throw std::runtime_error("Neplatny pocet mip urovni DDS: " + path.string());
+    }
+
+    std::vector<TextureUploader::MipChain> layers(array_size);
+    for (auto& layer : layers) {
+        layer.width = width;
+        layer.height = height;
+        layer.format = format;
+        layer.levels.resize(levels);
+        for (size_t level = 0; level < levels; ++level) {
+            layer.levels[level].resize(levelBytes(format, width, height, level));
+            in.read(reinterpret_cast<char*>(layer.levels[level].data()), layer.levels[level].size());
+        }
+    }
+    if (!in) {
+        throw std::runtime_error("Zkraceny soubor DDS: " + path.string());
+    }
+    return layers;
+}
+
+bool DdsFile::isFresh(const std::filesystem::path& cache, const std::vector<std::filesystem::path>& sources) {
+    std::error_code error;
+    const auto cache_time = std::filesystem::last_write_time(cache, error);
+    if (error) {
+        return false;
+    }
+    for (const auto& source : sources) {
+        const auto source_time = std::filesystem::last_write_time(source, error);
+        if (error || source_time > cache_time) {
+            return false;
+        }
+    }
+    return true;
+}
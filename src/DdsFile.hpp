@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#include "TextureUploader.hpp"
+
+// Komprimované textury v souborech DDS: BC1 / BC3 (FourCC "DXT1" / "DXT5") a BC1 / BC3 / BC7
+// s rozšířenou hlavičkou "DX10" (i pole vrstev). Data jsou po vrstvách, uvnitř vrstvy všechny mip úrovně
+// od plného rozlišení, bloky 4x4 po řádcích - přesně tak, jak je chce glCompressedTextureSubImage,
+// takže se po načtení nic nepřepočítává. Nekomprimované DDS, cubemapy a 3D textury se nečtou.
+// BC1 bez alfy se pozná podle DDPF_ALPHAPIXELS (u DX10 podle režimu alfy), read() vrátí formát z write().
+class DdsFile {
+public:
+    static constexpr uint32_t MAGIC = 0x20534444;   // "DDS "
+
+    // vrstvy (stejný rozměr, formát a počet úrovní), jedna vrstva = legacy hlavička, víc nebo BC7 = DX10
+    static void write(const std::filesystem::path& path, const std::vector<TextureUploader::MipChain>& layers);
+    // vrstvy souboru (std::runtime_error při chybě nebo nepodporovaném formátu)
+    static std::vector<TextureUploader::MipChain> read(const std::filesystem::path& path);
+
+    // cache je platná, když existuje a není starší než žádný ze zdrojů
+    static bool isFresh(const std::filesystem::path& cache, const std::vector<std::filesystem::path>& sources);
+};
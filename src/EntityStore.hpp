@@ -0,0 +1,127 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+// handle entity - index do řídkého pole + generace (zneplatní se po zrušení entity)
+struct EntityHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const EntityHandle& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const EntityHandle& o) const { return !(*this == o); }
+};
+
+// příznaky určující, jak se entita vykresluje a aktualizuje
+enum EntityFlags : uint32_t {
+    ENTITY_TRANSPARENT = 1u << 0,   // kreslí se v průhledném průchodu (seřazeně)
+    ENTITY_DYNAMIC     = 1u << 1,   // mění transformaci -> mimo statickou BVH
+    ENTITY_TERRAIN     = 1u << 2,   // terén (výšková mapa)
+    ENTITY_WALL        = 1u << 3,   // stěna labyrintu
+    ENTITY_HIDDEN      = 1u << 4,   // nevykreslovat
+};
+
+// materiál entity
+struct EntityMaterial {
+    GLuint texture = 0;
+    glm::vec4 diffuse_color{ 1.0f };
+};
+
+// husté úložiště entit (structure of arrays), adresované generačními handly
+class EntityStore {
+public:
+    // husté pole - index i patří jedné entitě ve všech polích
+    std::vector<glm::mat4> transforms;
+    std::vector<uint32_t> meshes;            // index sdíleného modelu (geometrie)
+    std::vector<EntityMaterial> materials;
+    std::vector<uint32_t> flags;
+
+    EntityHandle create(uint32_t mesh, const glm::mat4& transform, const EntityMaterial& material, uint32_t entity_flags) {
+        uint32_t slot;
+        if (!free_slots_.empty()) {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(sparse_.size());
+            sparse_.push_back(UINT32_MAX);
+            generations_.push_back(0);
+        }
+
+        uint32_t dense = static_cast<uint32_t>(transforms.size());
+        transforms.push_back(transform);
+        meshes.push_back(mesh);
+        materials.push_back(material);
+        flags.push_back(entity_flags);
+        dense_to_slot_.push_back(slot);
+        sparse_[slot] = dense;
+
+        return EntityHandle{ slot, generations_[slot] };
+    }
+
+    // zrušení entity - poslední entita se přesune na uvolněné místo (pole zůstávají hustá)
+    void destroy(EntityHandle h) {
+        if (!alive(h)) {
+            return;
+        }
+        uint32_t dense = sparse_[h.index];
+        uint32_t last = static_cast<uint32_t>(transforms.size()) - 1;
+        if (dense != last) {
+            transforms[dense] = transforms[last];
+            meshes[dense] = meshes[last];
+            materials[dense] = materials[last];
+            flags[dense] = flags[last];
+            dense_to_slot_[dense] = dense_to_slot_[last];
+            sparse_[dense_to_slot_[dense]] = dense;
+        }
+        transforms.pop_back();
+        meshes.pop_back();
+        materials.pop_back();
+        flags.pop_back();
+        dense_to_slot_.pop_back();
+
+        sparse_[h.index] = UINT32_MAX;
+        generations_[h.index]++;
+        free_slots_.push_back(h.index);
+    }
+
+    bool alive(EntityHandle h) const {
+        return h.index < sparse_.size() && generations_[h.index] == h.generation && sparse_[h.index] != UINT32_MAX;
+    }
+
+    // index do hustých polí (platí do dalšího destroy)
+    uint32_t indexOf(EntityHandle h) const { return sparse_[h.index]; }
+    EntityHandle handleAt(uint32_t dense) const { return EntityHandle{ dense_to_slot_[dense], generations_[dense_to_slot_[dense]] }; }
+
+    glm::mat4& transform(EntityHandle h) { return transforms[indexOf(h)]; }
+    EntityMaterial& material(EntityHandle h) { return materials[indexOf(h)]; }
+
+    size_t size() const { return transforms.size(); }
+
+    void reserve(size_t n) {
+        transforms.reserve(n);
+        meshes.reserve(n);
+        materials.reserve(n);
+        flags.reserve(n);
+        dense_to_slot_.reserve(n);
+    }
+
+    void clear() {
+        transforms.clear();
+        meshes.clear();
+        materials.clear();
+        flags.clear();
+        dense_to_slot_.clear();
+        sparse_.clear();
+        generations_.clear();
+        free_slots_.clear();
+    }
+
+private:
+    std::vector<uint32_t> sparse_;         // slot handlu -> hustý index
+    std::vector<uint32_t> generations_;    // generace slotu
+    std::vector<uint32_t> dense_to_slot_;  // hustý index -> slot handlu
+    std::vector<uint32_t> free_slots_;
+};
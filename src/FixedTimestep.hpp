@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+// Pevný krok simulace. Čas snímků se sčítá a simulace běží po celých krocích, takže výsledek nezávisí
+// na snímkové frekvenci a cena fyziky za snímek je omezená. Zbytek (alpha) slouží k interpolaci
+// vykreslovaného stavu mezi posledními dvěma kroky. Po záseku proběhne nejvýš max_steps kroků a zbylý
+// čas se zahodí - hra se na chvíli zpomalí, místo aby simulace nestíhala čím dál víc.
+class FixedTimestep {
+public:
+    explicit FixedTimestep(double step = 1.0 / 120.0, unsigned int max_steps = 8)
+        : step_(step), max_steps_((std::max)(max_steps, 1u)) {}
+
+    // přičte čas snímku (s), vrací počet kroků, které se mají teď provést
+    unsigned int advance(double frame_time) {
+        accumulator_ += (std::max)(frame_time, 0.0);
+        unsigned int steps = 0;
+        while (accumulator_ >= step_ && steps < max_steps_) {
+            accumulator_ -= step_;
+            ++steps;
+        }
+        if (accumulator_ >= step_) {
+            const double rest = std::fmod(accumulator_, step_);
+            dropped_ += accumulator_ - rest;
+            accumulator_ = rest;
+        }
+        return steps;
+    }
+
+    double step() const { return step_; }
+    unsigned int maxSteps() const { return max_steps_; }
+    // poloha mezi předchozím (0) a posledním (1) krokem pro vykreslení
+    float alpha() const { return static_cast<float>(accumulator_ / step_); }
+    // čas zahozený po zásecích (s)
+    double dropped() const { return dropped_; }
+
+private:
+    double step_;
+    unsigned int max_steps_;
+    double accumulator_ = 0.0;
+    double dropped_ = 0.0;
+};
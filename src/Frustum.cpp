@@ -0,0 +1,120 @@
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define FRUSTUM_USE_SSE 1
+#include <emmintrin.h>
+#endif
+
+#include "Frustum.hpp"
+
+Frustum Frustum::fromMatrix(const glm::mat4& vp) {
+    Frustum f;
+
+    // řádky matice (glm je column-major)
+    glm::vec4 row0(vp[0][0], vp[1][0], vp[2][0], vp[3][0]);
+    glm::vec4 row1(vp[0][1], vp[1][1], vp[2][1], vp[3][1]);
+    glm::vec4 row2(vp[0][2], vp[1][2], vp[2][2], vp[3][2]);
+    glm::vec4 row3(vp[0][3], vp[1][3], vp[2][3], vp[3][3]);
+
+    f.planes[0] = row3 + row0; // levá
+    f.planes[1] = row3 - row0; // pravá
+    f.planes[2] = row3 + row1; // dolní
+    f.planes[3] = row3 - row1; // horní
+    f.planes[4] = row3 + row2; // blízká
+    f.planes[5] = row3 - row2; // vzdálená
+
+    for (auto& p : f.planes) {
+        float len = glm::length(glm::vec3(p));
+        if (len > 0.0f) {
+            p = p / len;
+        }
+    }
+    return f;
+}
+
+bool Frustum::intersects(const AABB& box) const {
+    glm::vec3 c = box.center();
+    glm::vec3 e = box.extent();
+    for (const auto& p : planes) {
+        float d = p.x * c.x + p.y * c.y + p.z * c.z + p.w;
+        float r = std::fabs(p.x) * e.x + std::fabs(p.y) * e.y + std::fabs(p.z) * e.z;
+        if (d + r < 0.0f) {
+            return false; // celý box leží za rovinou
+        }
+    }
+    return true;
+}
+
+void CullingBatch::clear() {
+    count_ = 0;
+    cx_.clear(); cy_.clear(); cz_.clear();
+    ex_.clear(); ey_.clear(); ez_.clear();
+}
+
+void CullingBatch::reserve(size_t n) {
+    cx_.reserve(n); cy_.reserve(n); cz_.reserve(n);
+    ex_.reserve(n); ey_.reserve(n); ez_.reserve(n);
+    visible_.reserve(n);
+}
+
+uint32_t CullingBatch::add(const AABB& box) {
+    glm::vec3 c = box.center();
+    glm::vec3 e = box.extent();
+    cx_.push_back(c.x); cy_.push_back(c.y); cz_.push_back(c.z);
+    ex_.push_back(e.x); ey_.push_back(e.y); ez_.push_back(e.z);
+    return static_cast<uint32_t>(count_++);
+}
+
+size_t CullingBatch::cull(const Frustum& frustum) {
+    visible_.resize(count_);
+    size_t i = 0;
+    size_t visible_count = 0;
+
+#ifdef FRUSTUM_USE_SSE
+    // roviny rozložené do registrů: normála, |normála| a vzdálenost
+    __m128 pnx[6], pny[6], pnz[6], pax[6], pay[6], paz[6], pw[6];
+    for (int k = 0; k < 6; ++k) {
+        const glm::vec4& p = frustum.planes[k];
+        pnx[k] = _mm_set1_ps(p.x);  pny[k] = _mm_set1_ps(p.y);  pnz[k] = _mm_set1_ps(p.z);
+        pax[k] = _mm_set1_ps(std::fabs(p.x)); pay[k] = _mm_set1_ps(std::fabs(p.y)); paz[k] = _mm_set1_ps(std::fabs(p.z));
+        pw[k] = _mm_set1_ps(p.w);
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i + 4 <= count_; i += 4) {
+        __m128 cx = _mm_loadu_ps(&cx_[i]), cy = _mm_loadu_ps(&cy_[i]), cz = _mm_loadu_ps(&cz_[i]);
+        __m128 ex = _mm_loadu_ps(&ex_[i]), ey = _mm_loadu_ps(&ey_[i]), ez = _mm_loadu_ps(&ez_[i]);
+
+        __m128 outside = _mm_setzero_ps();
+        for (int k = 0; k < 6; ++k) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pnx[k], cx), _mm_mul_ps(pny[k], cy)), _mm_add_ps(_mm_mul_ps(pnz[k], cz), pw[k]));
+            __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pax[k], ex), _mm_mul_ps(pay[k], ey)), _mm_mul_ps(paz[k], ez));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), zero));
+        }
+
+        int mask = _mm_movemask_ps(outside);
+        for (int j = 0; j < 4; ++j) {
+            uint8_t vis = (mask & (1 << j)) ? 0 : 1;
+            visible_[i + j] = vis;
+            visible_count += vis;
+        }
+    }
+#endif
+
+    // zbytek (nebo celá dávka bez SSE)
+    for (; i < count_; ++i) {
+        bool vis = true;
+        for (const auto& p : frustum.planes) {
+            float d = p.x * cx_[i] + p.y * cy_[i] + p.z * cz_[i] + p.w;
+            float r = std::fabs(p.x) * ex_[i] + std::fabs(p.y) * ey_[i] + std::fabs(p.z) * ez_[i];
+            if (d + r < 0.0f) {
+                vis = false;
+                break;
+            }
+        }
+        visible_[i] = vis ? 1 : 0;
+        visible_count += vis ? 1 : 0;
+    }
+
+    return visible_count;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+// osově zarovnaný bounding box (AABB)
+struct AABB {
+    glm::vec3 min{ std::numeric_limits<float>::max() };
+    glm::vec3 max{ -std::numeric_limits<float>::max() };
+
+    bool valid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+    glm::vec3 extent() const { return (max - min) * 0.5f; }
+
+    // rozšíření o bod / jiný box
+    void expand(const glm::vec3& p) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+    void expand(const AABB& b) {
+        min = glm::min(min, b.min);
+        max = glm::max(max, b.max);
+    }
+
+    // box po transformaci maticí modelu (Arvo - střed a absolutní hodnota 3x3 části)
+    AABB transformed(const glm::mat4& m) const {
+        if (!valid()) return *this;
+        glm::vec3 c = glm::vec3(m * glm::vec4(center(), 1.0f));
+        glm::vec3 e = extent();
+        glm::vec3 new_e(
+            glm::abs(m[0][0]) * e.x + glm::abs(m[1][0]) * e.y + glm::abs(m[2][0]) * e.z,
+            glm::abs(m[0][1]) * e.x + glm::abs(m[1][1]) * e.y + glm::abs(m[2][1]) * e.z,
+            glm::abs(m[0][2]) * e.x + glm::abs(m[1][2]) * e.y + glm::abs(m[2][2]) * e.z);
+        return AABB{ c - new_e, c + new_e };
+    }
+};
+
+// pohledový jehlan - 6 rovin (nx, ny, nz, d), normály míří dovnitř
+struct Frustum {
+    glm::vec4 planes[6];
+
+    // extrakce rovin z matice projection * view (Gribb & Hartmann)
+    static Frustum fromMatrix(const glm::mat4& vp);
+
+    // test jednoho boxu (skalárně)
+    bool intersects(const AABB& box) const;
+};
+
+// dávkový culling - boxy uložené jako SoA (střed + polovina rozměru), testuje se po 4 (SSE)
+class CullingBatch {
+public:
+    void clear();
+    void reserve(size_t n);
+    uint32_t add(const AABB& box); // vrací index kandidáta
+    size_t size() const { return count_; }
+
+    // otestuje všechny kandidáty proti frustu, vrací počet viditelných
+    size_t cull(const Frustum& frustum);
+    bool isVisible(uint32_t i) const { return visible_[i] != 0; }
+
+private:
+    size_t count_ = 0;
+    std::vector<float> cx_, cy_, cz_;
+    std::vector<float> ex_, ey_, ez_;
+    std::vector<uint8_t> visible_;
+};
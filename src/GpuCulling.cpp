@@ -0,0 +1,224 @@
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "GpuCulling.hpp"
+
+void GpuCulling::init(size_t max_draws) {
+    cull_program = ShaderProgram("resources/shaders/cull.comp");
+    hiz_program = ShaderProgram("resources/shaders/hiz.comp");
+
+    max_draws_ = (std::max)(max_draws, size_t(1));
+    indirect_count = GLEW_ARB_indirect_parameters;
+
+    glCreateBuffers(1, &output_commands);
+    glNamedBufferStorage(output_commands, max_draws_ * sizeof(DrawElementsIndirectCommand), nullptr, 0);
+    glCreateBuffers(1, &counter_buffer);
+    glNamedBufferStorage(counter_buffer, sizeof(GLuint), nullptr, 0);
+    glCreateBuffers(1, &visibility_buffer);
+    glNamedBufferStorage(visibility_buffer, max_draws_ * sizeof(GLuint), nullptr, 0);
+}
+
+void GpuCulling::resize(int width, int height) {
+    glDeleteFramebuffers(1, &depth_fbo);
+    glDeleteTextures(1, &depth_texture);
+    glDeleteTextures(1, &hiz_texture);
+
+    width_ = width;
+    height_ = height;
+    hiz_levels = 1 + static_cast<int>(std::floor(std::log2((std::max)(width, height))));
+    hiz_valid = false;
+
+    // 1. Kopie hloubky (stejný formát jako výchozí framebuffer, jinak blit selže)
+    glCreateTextures(GL_TEXTURE_2D, 1, &depth_texture);
+    glTextureStorage2D(depth_texture, 1, GL_DEPTH24_STENCIL8, width, height);
+    glTextureParameteri(depth_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(depth_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(depth_texture, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_DEPTH_COMPONENT);
+
+    glCreateFramebuffers(1, &depth_fbo);
+    glNamedFramebufferTexture(depth_fbo, GL_DEPTH_STENCIL_ATTACHMENT, depth_texture, 0);
+
+    // 2. Pyramida (max hloubka), všechny úrovně až do 1x1
+    glCreateTextures(GL_TEXTURE_2D, 1, &hiz_texture);
+    glTextureStorage2D(hiz_texture, hiz_levels, GL_R32F, width, height);
+    glTextureParameteri(hiz_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTextureParameteri(hiz_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(hiz_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(hiz_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void GpuCulling::captureDepth(GLuint framebuffer, int width, int height, const glm::mat4& view_proj) {
+    if (width <= 0 || height <= 0) {
+        return; // minimalizované okno
+    }
+    if (width != width_ || height != height_) {
+        resize(width, height);
+    }
+
+    glBlitNamedFramebuffer(framebuffer, depth_fbo, 0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+    hiz_program.activate();
+
+    // úroveň 0 = kopie hloubky
+    hiz_program.setUniform("u_from_depth", 1);
+    glBindTextureUnit(0, depth_texture);
+    glBindImageTexture(0, hiz_texture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+    glBindImageTexture(1, hiz_texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    glDispatchCompute((width + 7) / 8, (height + 7) / 8, 1);
+
+    // další úrovně = max z předchozí
+    hiz_program.setUniform("u_from_depth", 0);
+    for (int level = 1; level < hiz_levels; ++level) {
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        int w = (std::max)(width >> level, 1);
+        int h = (std::max)(height >> level, 1);
+        glBindImageTexture(0, hiz_texture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+        glBindImageTexture(1, hiz_texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        glDispatchCompute((w + 7) / 8, (h + 7) / 8, 1);
+    }
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+    hiz_view_proj = view_proj;
+    hiz_valid = true;
+}
+
+void GpuCulling::cull(const StaticBatch& batch, const Frustum& frustum, bool occlusion) {
+    const size_t n = batch.drawCount();
+    last_draw_count = n;
+    if (n == 0) {
+        return;
+    }
+    if (n > max_draws_) {
+        throw std::runtime_error("GPU culling: davka ma vic vykresleni nez " + std::to_string(max_draws_));
+    }
+
+    const GLuint zero = 0;
+    glClearNamedBufferData(counter_buffer, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    if (!indirect_count) {
+        // kreslí se všech n příkazů, nepřepsané musí mít count 0
+        glClearNamedBufferData(output_commands, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    }
+
+    cull_program.activate();
+    for (int i = 0; i < 6; ++i) {
+        cull_program.setUniform("u_planes[" + std::to_string(i) + "]", frustum.planes[i]);
+    }
+    cull_program.setUniform("u_draw_count", static_cast<GLuint>(n));
+
+    bool use_hiz = occlusion && hiz_valid;
+    cull_program.setUniform("u_occlusion", use_hiz ? 1 : 0);
+    if (use_hiz) {
+        cull_program.setUniform("u_hiz_view_proj", hiz_view_proj);
+        cull_program.setUniform("u_hiz_size", glm::vec2(width_, height_));
+        cull_program.setUniform("u_hiz_levels", hiz_levels);
+        glBindTextureUnit(0, hiz_texture);
+    }
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, batch.boundsBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, batch.commandTemplateBuffer());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, output_commands);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, counter_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, visibility_buffer);
+
+    glDispatchCompute(static_cast<GLuint>((n + 63) / 64), 1, 1);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+void GpuCulling::draw(const StaticBatch& batch) const {
+    batch.drawIndirect(output_commands, indirect_count ? counter_buffer : 0);
+}
+
+uint32_t GpuCulling::readVisibleCount() const {
+    GLuint count = 0;
+    glGetNamedBufferSubData(counter_buffer, 0, sizeof(GLuint), &count);
+    return count;
+}
+
+std::vector<uint32_t> GpuCulling::readVisibility() const {
+    std::vector<uint32_t> visibility(last_draw_count);
+    if (!visibility.empty()) {
+        glGetNamedBufferSubData(visibility_buffer, 0, visibility.size() * sizeof(GLuint), visibility.data());
+    }
+    return visibility;
+}
+
+HiZReadback GpuCulling::readHiZ() const {
+    HiZReadback hiz;
+    if (!hiz_valid) {
+        return hiz;
+    }
+    hiz.width = width_;
+    hiz.height = height_;
+    hiz.view_proj = hiz_view_proj;
+    hiz.levels.resize(hiz_levels);
+    for (int level = 0; level < hiz_levels; ++level) {
+        int w = (std::max)(width_ >> level, 1);
+        int h = (std::max)(height_ >> level, 1);
+        hiz.levels[level].resize(static_cast<size_t>(w) * h);
+        glGetTextureImage(hiz_texture, level, GL_RED, GL_FLOAT, static_cast<GLsizei>(hiz.levels[level].size() * sizeof(float)), hiz.levels[level].data());
+    }
+    return hiz;
+}
+
+bool GpuCulling::isVisibleReference(const AABB& box, const Frustum& frustum, const HiZReadback* hiz) {
+    if (!frustum.intersects(box)) {
+        return false;
+    }
+    if (hiz == nullptr || hiz->levels.empty()) {
+        return true;
+    }
+
+    // 1. Obdélník a nejbližší hloubka boxu na obrazovce (stejně jako cull.comp)
+    glm::vec2 uv_min(1.0f), uv_max(0.0f);
+    float z_min = 1.0f;
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 corner((i & 1) ? box.max.x : box.min.x, (i & 2) ? box.max.y : box.min.y, (i & 4) ? box.max.z : box.min.z);
+        glm::vec4 clip = hiz->view_proj * glm::vec4(corner, 1.0f);
+        if (clip.w <= 0.0f) {
+            return true; // box protíná blízkou rovinu
+        }
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        glm::vec2 uv = glm::vec2(ndc) * 0.5f + 0.5f;
+        uv_min = glm::min(uv_min, uv);
+        uv_max = glm::max(uv_max, uv);
+        z_min = (std::min)(z_min, ndc.z * 0.5f + 0.5f);
+    }
+    uv_min = glm::clamp(uv_min, glm::vec2(0.0f), glm::vec2(1.0f));
+    uv_max = glm::clamp(uv_max, glm::vec2(0.0f), glm::vec2(1.0f));
+
+    // 2. Úroveň, kde obdélník pokryje nejvýš 2x2 texely
+    glm::vec2 size = (uv_max - uv_min) * glm::vec2(hiz->width, hiz->height);
+    int level = static_cast<int>(std::ceil(std::log2((std::max)((std::max)(size.x, size.y), 1.0f))));
+    level = std::clamp(level, 0, static_cast<int>(hiz->levels.size()) - 1);
+
+    int w = (std::max)(hiz->width >> level, 1);
+    int h = (std::max)(hiz->height >> level, 1);
+    int x0 = std::clamp(static_cast<int>(uv_min.x * w), 0, w - 1);
+    int y0 = std::clamp(static_cast<int>(uv_min.y * h), 0, h - 1);
+    int x1 = std::clamp(static_cast<int>(uv_max.x * w), 0, w - 1);
+    int y1 = std::clamp(static_cast<int>(uv_max.y * h), 0, h - 1);
+
+    // 3. Box je zakrytý, pokud je celý za nejvzdálenější hloubkou v obdélníku
+    const std::vector<float>& d = hiz->levels[level];
+    float depth = (std::max)((std::max)(d[y0 * w + x0], d[y0 * w + x1]), (std::max)(d[y1 * w + x0], d[y1 * w + x1]));
+    return z_min <= depth;
+}
+
+void GpuCulling::clear() {
+    cull_program.clear();
+    hiz_program.clear();
+
+    glDeleteBuffers(1, &output_commands);
+    glDeleteBuffers(1, &counter_buffer);
+    glDeleteBuffers(1, &visibility_buffer);
+    glDeleteFramebuffers(1, &depth_fbo);
+    glDeleteTextures(1, &depth_texture);
+    glDeleteTextures(1, &hiz_texture);
+    output_commands = counter_buffer = visibility_buffer = depth_fbo = depth_texture = hiz_texture = 0;
+
+    width_ = height_ = 0;
+    hiz_levels = 0;
+    hiz_valid = false;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+#include "ShaderProgram.hpp"
+#include "StaticBatch.hpp"
+
+// Hi-Z pyramida stažená do RAM (CPU reference cullingu)
+struct HiZReadback {
+    int width = 0;
+    int height = 0;
+    std::vector<std::vector<float>> levels;   // levels[l][y * w_l + x], w_l = max(width >> l, 1)
+    glm::mat4 view_proj{ 1.0f };              // view-projection, se kterou vznikla hloubka
+};
+
+// GPU culling statické dávky: compute shader otestuje každé vykreslení proti frustu
+// a Hi-Z pyramidě z minulého snímku a viditelné příkazy zkompaktuje do indirect bufferu
+class GpuCulling {
+public:
+    // kompilace compute shaderů, buffery pro max_draws vykreslení
+    void init(size_t max_draws);
+
+    // kopie hloubky z framebufferu (0 = výchozí) a stavba Hi-Z pyramidy pro příští snímek
+    void captureDepth(GLuint framebuffer, int width, int height, const glm::mat4& view_proj);
+
+    // culling všech vykreslení dávky, occlusion = test proti Hi-Z (jen pokud už pyramida existuje)
+    void cull(const StaticBatch& batch, const Frustum& frustum, bool occlusion);
+
+    // vykreslení zkompaktovaných příkazů
+    void draw(const StaticBatch& batch) const;
+
+    // počet viditelných vykreslení posledního cullingu (čte z GPU, synchronizuje)
+    uint32_t readVisibleCount() const;
+    // viditelnost každého vykreslení posledního cullingu (čte z GPU, synchronizuje)
+    std::vector<uint32_t> readVisibility() const;
+    // Hi-Z pyramida (čte z GPU, synchronizuje)
+    HiZReadback readHiZ() const;
+
+    // stejný test jako cull.comp, na CPU (validace)
+    static bool isVisibleReference(const AABB& box, const Frustum& frustum, const HiZReadback* hiz);
+
+    bool hasHiZ() const { return hiz_valid; }
+    bool usesIndirectCount() const { return indirect_count; }
+
+    void clear();
+
+private:
+    void resize(int width, int height);
+
+    ShaderProgram cull_program;
+    ShaderProgram hiz_program;
+
+    size_t max_draws_ = 0;
+    size_t last_draw_count = 0;
+    bool indirect_count = false;       // ARB_indirect_parameters - počet příkazů čte GPU
+
+    GLuint output_commands{ 0 };
+    GLuint counter_buffer{ 0 };
+    GLuint visibility_buffer{ 0 };
+
+    // kopie hloubky a pyramida
+    int width_ = 0, height_ = 0;
+    int hiz_levels = 0;
+    bool hiz_valid = false;
+    glm::mat4 hiz_view_proj{ 1.0f };
+    GLuint depth_fbo{ 0 };
+    GLuint depth_texture{ 0 };
+    GLuint hiz_texture{ 0 };
+};
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "HeightMapFile.hpp"
+
+void HeightMapFile::write(const std::filesystem::path& path, const float* heights, int width, int height, size_t row_stride, int tile_size) {
+    if (width <= 0 || height <= 0 || tile_size <= 0) {
+        throw std::runtime_error("Neplatny rozmer vyskove mapy: " + path.string());
+    }
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Nelze zapsat vyskovou mapu: " + path.string());
+    }
+
+    Header header{ MAGIC, static_cast<uint32_t>(width), static_cast<uint32_t>(height), static_cast<uint32_t>(tile_size), {} };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // po dlaždicích - chybějící vzorky za okrajem opakují okraj
+    std::vector<float> tile(static_cast<size_t>(tile_size) * tile_size);
+    for (int z0 = 0; z0 < height; z0 += tile_size) {
+        for (int x0 = 0; x0 < width; x0 += tile_size) {
+            for (int z = 0; z < tile_size; ++z) {
+                const float* row = heights + (std::min)(z0 + z, height - 1) * row_stride;
+                for (int x = 0; x < tile_size; ++x) {
+                    tile[static_cast<size_t>(z) * tile_size + x] = row[(std::min)(x0 + x, width - 1)];
+                }
+            }
+            out.write(reinterpret_cast<const char*>(tile.data()), tile.size() * sizeof(float));
+        }
+    }
+    if (!out) {
+        throw std::runtime_error("Chyba zapisu vyskove mapy: " + path.string());
+    }
+}
+
+void HeightMapFile::open(const std::filesystem::path& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Nelze otevrit vyskovou mapu: " + path.string());
+    }
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file, &file_size);
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Nelze namapovat vyskovou mapu: " + path.string());
+    }
+    file_ = file;
+    mapping_ = mapping;
+    size_ = static_cast<size_t>(file_size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Nelze otevrit vyskovou mapu: " + path.string());
+    }
+    struct stat st;
+    fstat(fd, &st);
+    void* view = (st.st_size > 0) ? mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error("Nelze namapovat vyskovou mapu: " + path.string());
+    }
+    madvise(view, st.st_size, MADV_RANDOM);
+    fd_ = fd;
+    size_ = static_cast<size_t>(st.st_size);
+#endif
+    data_ = static_cast<const uint8_t*>(view);
+
+    // kontrola hlavičky a velikosti
+    if (size_ >= sizeof(Header)) {
+        header_ = *reinterpret_cast<const Header*>(data_);
+    }
+    if (size_ < sizeof(Header) || header_.magic != MAGIC || header_.width == 0 || header_.height == 0 || header_.tile_size == 0) {
+        close();
+        throw std::runtime_error("Neplatna hlavicka vyskove mapy: " + path.string());
+    }
+    tiles_x_ = static_cast<int>((header_.width + header_.tile_size - 1) / header_.tile_size);
+    tiles_z_ = static_cast<int>((header_.height + header_.tile_size - 1) / header_.tile_size);
+    const size_t expected = sizeof(Header) + static_cast<size_t>(tiles_x_) * tiles_z_ * header_.tile_size * header_.tile_size * sizeof(float);
+    if (size_ < expected) {
+        close();
+        throw std::runtime_error("Zkraceny soubor vyskove mapy: " + path.string());
+    }
+    resident_.assign(static_cast<size_t>(tiles_x_) * tiles_z_, 0);
+    resident_count_ = 0;
+}
+
+void HeightMapFile::close() {
+    if (data_) {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(static_cast<HANDLE>(mapping_));
+        CloseHandle(static_cast<HANDLE>(file_));
+        file_ = mapping_ = nullptr;
+#else
+        munmap(const_cast<uint8_t*>(data_), size_);
+        ::close(fd_);
+        fd_ = -1;
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    header_ = Header{};
+    tiles_x_ = tiles_z_ = 0;
+    resident_.clear();
+    resident_count_ = 0;
+}
+
+const float* HeightMapFile::tile(int tile_x, int tile_z) const {
+    const size_t tile_floats = static_cast<size_t>(header_.tile_size) * header_.tile_size;
+    return reinterpret_cast<const float*>(data_ + sizeof(Header)) + (static_cast<size_t>(tile_z) * tiles_x_ + tile_x) * tile_floats;
+}
+
+float HeightMapFile::sample(int x, int z) const {
+    x = std::clamp(x, 0, width() - 1);
+    z = std::clamp(z, 0, height() - 1);
+    const int t = tileSize();
+    return tile(x / t, z / t)[(z % t) * t + (x % t)];
+}
+
+void HeightMapFile::readRegion(int x0, int z0, int w, int h, float* out, size_t out_stride) const {
+    const int t = tileSize();
+    for (int z = 0; z < h; ++z) {
+        const int sz = std::clamp(z0 + z, 0, height() - 1);
+        float* row = out + static_cast<size_t>(z) * out_stride;
+        int x = 0;
+        while (x < w) {
+            const int sx = std::clamp(x0 + x, 0, width() - 1);
+            // souvislý úsek řádku uvnitř jedné dlaždice (mimo mapu po jednom vzorku)
+            const int run = (x0 + x >= 0 && x0 + x < width()) ? (std::min)({ w - x, t - sx % t, width() - sx }) : 1;
+            std::copy_n(tile(sx / t, sz / t) + (sz % t) * t + (sx % t), run, row + x);
+            x += run;
+        }
+    }
+}
+
+size_t HeightMapFile::pageAround(const glm::vec2& center, float radius) {
+    const float t = static_cast<float>(tileSize());
+    for (int tz = 0; tz < tiles_z_; ++tz) {
+        for (int tx = 0; tx < tiles_x_; ++tx) {
+            // vzdálenost středu od obdélníku dlaždice
+            glm::vec2 lo(tx * t, tz * t);
+            glm::vec2 d = glm::max(glm::max(lo - center, center - (lo + glm::vec2(t))), glm::vec2(0.0f));
+            const bool needed = glm::dot(d, d) <= radius * radius;
+            uint8_t& state = resident_[static_cast<size_t>(tz) * tiles_x_ + tx];
+            if (needed != (state != 0)) {
+                adviseTile(tx, tz, needed);
+                state = needed ? 1 : 0;
+                if (needed) {
+                    resident_count_++;
+                } else {
+                    resident_count_--;
+                }
+            }
+        }
+    }
+    return resident_count_;
+}
+
+void HeightMapFile::adviseTile(int tile_x, int tile_z, bool needed) {
+    const size_t bytes = static_cast<size_t>(header_.tile_size) * header_.tile_size * sizeof(float);
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(tile(tile_x, tile_z));
+
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const uintptr_t page = info.dwPageSize;
+#else
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+#endif
+    // rada platí po celých stránkách uvnitř dlaždice
+    uintptr_t first = (reinterpret_cast<uintptr_t>(begin) + page - 1) & ~(page - 1);
+    uintptr_t last = (reinterpret_cast<uintptr_t>(begin) + bytes) & ~(page - 1);
+    if (last <= first) {
+        return;
+    }
+    void* address = reinterpret_cast<void*>(first);
+    const size_t length = last - first;
+
+#ifdef _WIN32
+    if (needed) {
+        WIN32_MEMORY_RANGE_ENTRY range{ address, length };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    } else {
+        // odemčení nezamčených stránek je vyřadí z pracovní sady (data zůstanou v souboru)
+        VirtualUnlock(address, length);
+    }
+#else
+    madvise(address, length, needed ? MADV_WILLNEED : MADV_DONTNEED);
+#endif
+}
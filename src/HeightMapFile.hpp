@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+#include <glm/glm.hpp>
+
+// Dlaždicová výšková mapa v plné přesnosti (float32), mapovaná do paměti.
+// Soubor (.thm): hlavička (Header), pak dlaždice tile_size x tile_size vzorků, dlaždice t = tile_z * tiles_x + tile_x,
+// uvnitř dlaždice řádky podle z (x souvisle). Dlaždice na okraji jsou doplněné opakováním okraje mapy.
+// Celý soubor se jen mapuje (nečte) - stránky načítá systém až při přístupu, takže mapa může být větší
+// než RAM. pageAround() navíc přednačte dlaždice kolem kamery a vzdálené uvolní z pracovní sady.
+class HeightMapFile {
+public:
+    static constexpr uint32_t MAGIC = 0x314D4854;   // "THM1"
+
+    struct Header {
+        uint32_t magic;
+        uint32_t width;         // vzorků v x
+        uint32_t height;        // vzorků v z
+        uint32_t tile_size;     // vzorků na stranu dlaždice
+        uint32_t reserved[4];
+    };
+
+    HeightMapFile() = default;
+    ~HeightMapFile() { close(); }
+    HeightMapFile(const HeightMapFile&) = delete;
+    HeightMapFile& operator=(const HeightMapFile&) = delete;
+
+    // zápis mapy (row_stride v prvcích) do dlaždicového formátu
+    static void write(const std::filesystem::path& path, const float* heights, int width, int height, size_t row_stride, int tile_size = 256);
+
+    // namapování souboru (std::runtime_error při chybě)
+    void open(const std::filesystem::path& path);
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+
+    int width() const { return header_.width; }
+    int height() const { return header_.height; }
+    int tileSize() const { return header_.tile_size; }
+    int tilesX() const { return tiles_x_; }
+    int tilesZ() const { return tiles_z_; }
+
+    // vzorky dlaždice (tile_size * tile_size, řádek = z)
+    const float* tile(int tile_x, int tile_z) const;
+    float sample(int x, int z) const;
+
+    // obdélník vzorků [x0, x0 + w) x [z0, z0 + h) do out (řádek = z, out_stride v prvcích), mimo mapu opakuje okraj
+    void readRegion(int x0, int z0, int w, int h, float* out, size_t out_stride) const;
+
+    // přednačtení dlaždic v okolí bodu (xz ve vzorcích) a uvolnění vzdálenějších, vrací počet rezidentních dlaždic
+    size_t pageAround(const glm::vec2& center, float radius);
+    size_t residentTiles() const { return resident_count_; }
+
+private:
+    void adviseTile(int tile_x, int tile_z, bool needed);
+
+    Header header_{};
+    int tiles_x_ = 0, tiles_z_ = 0;
+    const uint8_t* data_ = nullptr;     // celé namapování (hlavička + dlaždice)
+    size_t size_ = 0;
+    std::vector<uint8_t> resident_;     // dlaždice přednačtené pageAround
+    size_t resident_count_ = 0;
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
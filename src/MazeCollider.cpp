@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cmath>
+
+#include "MazeCollider.hpp"
+
+namespace {
+
+// Vektor od nejbližšího bodu boxu k nejbližšímu bodu svislé úsečky (x, y0..y1, z). Úsečka je svislá,
+// takže stačí vybrat výšku: v překryvu výšek je vzdálenost čistě vodorovná, jinak rozhoduje bližší konec.
+glm::vec3 separation(const glm::vec3& p0, float y1, const AABB& box) {
+    float y;
+    if (y1 < box.min.y) {
+        y = y1;
+    } else if (p0.y > box.max.y) {
+        y = p0.y;
+    } else {
+        y = (std::max)(p0.y, box.min.y);
+    }
+    const glm::vec3 p(p0.x, y, p0.z);
+    return p - glm::clamp(p, box.min, box.max);
+}
+
+} // namespace
+
+AABB MazeCollider::cellBounds(int x, int z) const {
+    const float half = 0.5f * cell_size_;
+    const glm::vec3 center = origin_ + glm::vec3(x * cell_size_, 0.0f, z * cell_size_);
+    AABB box;
+    box.min = glm::vec3(center.x - half, y_min_, center.z - half);
+    box.max = glm::vec3(center.x + half, y_max_, center.z + half);
+    return box;
+}
+
+glm::ivec2 MazeCollider::cellAt(float x, float z) const {
+    return glm::ivec2(static_cast<int>(std::floor((x - origin_.x) / cell_size_ + 0.5f)),
+                      static_cast<int>(std::floor((z - origin_.z) / cell_size_ + 0.5f)));
+}
+
+bool MazeCollider::collideCapsule(glm::vec3& bottom, float capsule_height, float radius, glm::vec3& velocity) const {
+    if (!valid()) {
+        return false;
+    }
+    bool touched = false;
+    // dva průchody - vytlačení z jedné buňky může v rohu zatlačit do sousední
+    for (int pass = 0; pass < 2; ++pass) {
+        // buňky, do kterých zasahuje kruh kapsle (poloměr do půl buňky -> nejvýš 2x2)
+        const glm::ivec2 lo = cellAt(bottom.x - radius, bottom.z - radius);
+        const glm::ivec2 hi = cellAt(bottom.x + radius, bottom.z + radius);
+        bool moved = false;
+        for (int z = lo.y; z <= hi.y; ++z) {
+            for (int x = lo.x; x <= hi.x; ++x) {
+                if (!isWall(x, z)) {
+                    continue;
+                }
+                const AABB box = cellBounds(x, z);
+                // osa kapsle = úsečka středů koulí
+                const glm::vec3 p0 = bottom + glm::vec3(0.0f, radius, 0.0f);
+                const float y1 = bottom.y + capsule_height - radius;
+                const glm::vec3 d = separation(p0, y1, box);
+                const float dist2 = glm::dot(d, d);
+                if (dist2 >= radius * radius) {
+                    continue;
+                }
+
+                glm::vec3 normal;
+                float depth;
+                if (dist2 > 1e-12f) {
+                    const float dist = std::sqrt(dist2);
+                    normal = d / dist;
+                    depth = radius - dist;
+                } else {
+                    // osa uvnitř boxu: ven nejkratší vodorovnou cestou
+                    const float to_min_x = p0.x - box.min.x, to_max_x = box.max.x - p0.x;
+                    const float to_min_z = p0.z - box.min.z, to_max_z = box.max.z - p0.z;
+                    const float best = (std::min)({ to_min_x, to_max_x, to_min_z, to_max_z });
+                    normal = best == to_min_x ? glm::vec3(-1, 0, 0) : best == to_max_x ? glm::vec3(1, 0, 0)
+                           : best == to_min_z ? glm::vec3(0, 0, -1) : glm::vec3(0, 0, 1);
+                    depth = best + radius;
+                }
+                bottom += normal * depth;
+                const float into = glm::dot(velocity, normal);
+                if (into < 0.0f) {
+                    velocity -= into * normal;
+                }
+                touched = true;
+                moved = true;
+            }
+        }
+        if (!moved) {
+            break;
+        }
+    }
+    return touched;
+}
+
+bool MazeCollider::overlapsCapsule(const glm::vec3& bottom, float capsule_height, float radius, float tolerance) const {
+    if (!valid()) {
+        return false;
+    }
+    const glm::ivec2 lo = cellAt(bottom.x - radius, bottom.z - radius);
+    const glm::ivec2 hi = cellAt(bottom.x + radius, bottom.z + radius);
+    const float limit = radius - tolerance;
+    for (int z = lo.y; z <= hi.y; ++z) {
+        for (int x = lo.x; x <= hi.x; ++x) {
+            if (!isWall(x, z)) {
+                continue;
+            }
+            const glm::vec3 d = separation(bottom + glm::vec3(0.0f, radius, 0.0f), bottom.y + capsule_height - radius, cellBounds(x, z));
+            if (glm::dot(d, d) < limit * limit) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
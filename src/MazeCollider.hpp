@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+
+// Kolize svislé kapsle (hráč, NPC) se stěnami labyrintu. Broadphase je přímý pohled do mřížky buněk
+// (maze_map) pod kapslí - nejvýš 2x2 buňky pro poloměr do půl buňky, takže cena nezávisí na velikosti
+// labyrintu. Narrowphase je kapsle vs. AABB buňky: kapsle se vytlačí po nejkratší vzdálenosti
+// a rychlost do stěny se odebere (zbytek klouže podél stěny). Pohyb za krok má být menší než
+// poloměr, jinak může kapsle stěnou projít.
+class MazeCollider {
+public:
+    MazeCollider() = default;
+    // cells = 1 bajt na buňku (řádek = z, row_stride v bajtech), wall = hodnota stěny. Buňka (x, z) má střed
+    // origin + (x, 0, z) * cell_size a stěna sahá ve výšce od y_min do y_max. Mapa musí platit po celou dobu.
+    MazeCollider(const uint8_t* cells, int width, int height, size_t row_stride, uint8_t wall,
+                 const glm::vec3& origin, float cell_size, float y_min, float y_max)
+        : cells_(cells), width_(width), height_(height), row_stride_(row_stride), wall_(wall),
+          origin_(origin), cell_size_(cell_size), y_min_(y_min), y_max_(y_max) {}
+
+    bool valid() const { return cells_ != nullptr; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // mimo mapu stěna není
+    bool isWall(int x, int z) const {
+        return x >= 0 && z >= 0 && x < width_ && z < height_ && cells_[static_cast<size_t>(z) * row_stride_ + x] == wall_;
+    }
+    AABB cellBounds(int x, int z) const;
+    // buňka pod bodem (x, z světa)
+    glm::ivec2 cellAt(float x, float z) const;
+
+    // Kapsle od bottom (spodek) do bottom + capsule_height, poloměr radius <= cell_size / 2.
+    // Vytlačí ji ze stěn a odebere rychlost do nich, true = dotyk se stěnou.
+    bool collideCapsule(glm::vec3& bottom, float capsule_height, float radius, glm::vec3& velocity) const;
+    // kapsle protíná stěnu hlouběji než tolerance (kontrola)
+    bool overlapsCapsule(const glm::vec3& bottom, float capsule_height, float radius, float tolerance = 0.0f) const;
+
+private:
+    const uint8_t* cells_ = nullptr;
+    int width_ = 0, height_ = 0;
+    size_t row_stride_ = 0;
+    uint8_t wall_ = 0;
+    glm::vec3 origin_{ 0.0f };
+    float cell_size_ = 1.0f;
+    float y_min_ = 0.0f, y_max_ = 0.0f;
+};
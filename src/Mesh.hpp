@@ -11,6 +11,7 @@
 
 #include "assets.hpp"
 #include "ShaderProgram.hpp"
+#include "Frustum.hpp"
         
 // tda pro Mesh
 class Mesh {
@@ -29,6 +30,8 @@ public:
     glm::vec4 diffuse_material{1.0f};   // (hlavn barva)
     glm::vec4 specular_material{1.0f};  // (barva lesku)
     float reflectivity{1.0f};           // odleskovost
+
+    AABB bounds;                        // bounding box v loklnch souadnicch (pro culling)
     
     // indexovan vykreslen (vkldn do VRAM)
 	Mesh(GLenum primitive_type, std::vector<vertex> const & vertices, std::vector<GLuint> const & indices, glm::vec3 const & origin, glm::vec3 const & orientation, GLuint const texture_id = 0):
@@ -39,6 +42,11 @@ public:
         orientation(orientation),
         texture_id(texture_id)
     {
+        // 0. Vpoet bounding boxu z vrchol
+        for (const auto& v : this->vertices) {
+            bounds.expand(v.position);
+        }
+
         // 1. Vytvoen VAO (Vertex Array Object)
         glCreateVertexArrays(1, &VAO);
 
@@ -87,6 +95,9 @@ public:
         glBindVertexArray(0);   // odpojen
     }
 
+    // VAO meshe (pro azen a vykreslovn pes RenderQueue)
+    GLuint getVAO() const { return VAO; }
+
     // uvolnn prostedk
 	void clear(void) {
         texture_id = 0;
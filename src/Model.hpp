@@ -27,29 +27,44 @@ public:
 
     // naten meshes
     Model(const std::filesystem::path & filename) {
-        name = filename.stem().string();
+        std::vector<vertex> vertices;
+        std::vector<GLuint> indices;
+        if (!parse(filename, vertices, indices)) {
+            std::cerr << "Failed to load model: " << filename << std::endl;
+            name = filename.stem().string();
+            return;
+        }
+        *this = Model(filename.stem().string(), vertices, indices);
+    }
 
+    // model z u natench dat (vytvo GL buffery - jen vlkno s kontextem)
+    Model(const std::string& model_name, const std::vector<vertex>& vertices, const std::vector<GLuint>& indices) {
+        name = model_name;
+        meshes.emplace_back(GL_TRIANGLES, vertices, indices, glm::vec3(0.0f), glm::vec3(0.0f));
+    }
+
+    // CPU st naten OBJ bez GL (sm bet na pracovnm vlkn)
+    static bool parse(const std::filesystem::path & filename, std::vector<vertex>& vertices, std::vector<GLuint>& indices) {
         std::vector<glm::vec3> positions;
         std::vector<glm::vec2> uvs;
         std::vector<glm::vec3> normals;
-        
+
         // naten OBJ
         if (!loadOBJ(filename.string().c_str(), positions, uvs, normals)) {
-            std::cerr << "Failed to load model: " << filename << std::endl;
-            return;
+            return false;
         }
 
-        std::vector<vertex> vertices;
+        vertices.clear();
+        vertices.reserve(positions.size());
         for (size_t i = 0; i < positions.size(); ++i) {
             vertices.push_back({positions[i], normals[i], uvs[i]});
         }
 
-        std::vector<GLuint> indices;
+        indices.resize(positions.size());
         for (size_t i = 0; i < positions.size(); ++i) {
-            indices.push_back(static_cast<GLuint>(i));
+            indices[i] = static_cast<GLuint>(i);
         }
-
-        meshes.emplace_back(GL_TRIANGLES, vertices, indices, glm::vec3(0.0f), glm::vec3(0.0f));
+        return true;
     }
 
     // update position etc. based on running time
@@ -64,6 +79,13 @@ public:
         }
     }
 
+    // vykreslen s ciz matic (sdlen geometrie vce entit)
+    void draw(ShaderProgram& shader, const glm::mat4& matrix) const {
+        for (auto const& mesh : meshes) {
+            mesh.draw(shader, matrix);
+        }
+    }
+
     void setTexture(GLuint texture_id) {
         for (auto& mesh : meshes) {
             mesh.texture_id = texture_id;
@@ -96,4 +118,18 @@ public:
 	const glm::mat4& getMatrix() const {
 		return model_matrix;
 	}
+
+	// bounding box vech mesh v loklnch souadnicch
+	AABB getLocalBounds() const {
+		AABB box;
+		for (auto const& mesh : meshes) {
+			box.expand(mesh.bounds);
+		}
+		return box;
+	}
+
+	// bounding box po transformaci matic modelu
+	AABB getWorldBounds() const {
+		return getLocalBounds().transformed(model_matrix);
+	}
 };
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "PlayerPhysics.hpp"
+
+bool PlayerPhysics::step(PlayerState& state, const PlayerInput& input, float dt) const {
+    // Terén pod hráčem ještě není (streamování po teleportu) - stojí, dokud se nenačte
+    if (ground_.ready && !ground_.ready(state.position.x, state.position.z)) {
+        state.velocity = glm::vec3(0.0f);
+        return false;
+    }
+    const PlayerState start = state;
+
+    // Vodorovná rychlost ze vstupu - na příliš strmém svahu jen složka po svahu
+    glm::vec3 move_velocity = input.move;
+    if (state.on_ground && glm::dot(move_velocity, move_velocity) > 0.0f && ground_.normal) {
+        const glm::vec3 ahead = state.position + move_velocity * dt;
+        const glm::vec3 normal = ground_.normal(ahead.x, ahead.z);
+        if (normal.y < settings_.max_slope_y) {
+            move_velocity -= glm::dot(move_velocity, normal) * normal;
+        }
+    }
+    state.velocity.x = move_velocity.x;
+    state.velocity.z = move_velocity.z;
+
+    // Skákání
+    bool jumped = false;
+    if (input.jump && state.on_ground) {
+        state.velocity.y = settings_.jump_speed;
+        state.on_ground = false;
+        jumped = true;
+    }
+
+    // Gravitace pracuje i na zemi: pohyb pak skončí dotykem se zemí a hráč zůstane on_ground
+    // (bez ní krok po zemi povrchu nedosáhl a on_ground se po krocích střídal - skok šel jen v každém druhém)
+    state.velocity.y += settings_.gravity * dt;
+
+    // Aktualizace pozice podle rychlosti - tělo je koule tažená po dráze, rychlý pohyb neproletí hřebenem
+    const bool grounded = move(state, state.velocity * dt);
+
+    // Stěny labyrintu - vytlačení kapsle a klouzání podél stěny
+    if (walls_) {
+        glm::vec3 feet = state.position - glm::vec3(0.0f, settings_.height, 0.0f);
+        if (walls_->collideCapsule(feet, settings_.height, settings_.radius, state.velocity)) {
+            state.position = feet + glm::vec3(0.0f, settings_.height, 0.0f);
+        }
+    }
+
+    // Cíl kroku leží na nenačteném terénu - hráč zůstane na místě
+    if (ground_.ready && !ground_.ready(state.position.x, state.position.z)) {
+        state = start;
+        state.velocity = glm::vec3(0.0f);
+        return false;
+    }
+
+    // Kontrola kolize se zemí (pojistka; bez field jediná kontrola)
+    const float terrain_height = ground_.height ? ground_.height(state.position.x, state.position.z) : 0.0f;
+    if (state.position.y < terrain_height + settings_.height) {
+        state.position.y = terrain_height + settings_.height;
+        state.velocity.y = 0.0f;
+        state.on_ground = true;
+    } else {
+        state.on_ground = grounded;
+    }
+    return jumped;
+}
+
+// Swept sphere najde první dotyk i uprostřed kroku, zbytek pohybu klouže po tečné rovině (nejvýš 3 odrazy).
+bool PlayerPhysics::move(PlayerState& state, glm::vec3 motion) const {
+    if (!ground_.field || !ground_.field->valid()) {
+        state.position += motion;
+        return false;
+    }
+    const float skin = 1e-3f;                 // odstup od povrchu, další krok tak nezačíná v dotyku
+    const glm::vec3 body_offset(0.0f, settings_.height - settings_.radius, 0.0f);
+    glm::vec3 center = state.position - body_offset;
+    bool grounded = false;
+    for (int i = 0; i < 3 && glm::dot(motion, motion) > 1e-10f; ++i) {
+        TerrainHit hit;
+        if (!ground_.field->sweepSphere(center, center + motion, settings_.radius, hit)) {
+            center += motion;
+            break;
+        }
+        center = hit.center + hit.normal * skin;
+        if (hit.normal.y >= settings_.max_slope_y && motion.y < 0.0f) {
+            grounded = true;
+            state.velocity.y = 0.0f;
+        }
+        glm::vec3 rest = motion * (1.0f - hit.t);
+        motion = rest - glm::dot(rest, hit.normal) * hit.normal;
+    }
+    state.position = center + body_offset;
+    return grounded;
+}
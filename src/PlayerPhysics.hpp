@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+
+#include <glm/glm.hpp>
+
+#include "TerrainHeightField.hpp"
+#include "MazeCollider.hpp"
+
+// vstup hráče pro jeden krok simulace
+struct PlayerInput {
+    glm::vec3 move{ 0.0f };     // požadovaná vodorovná rychlost
+    bool jump = false;
+};
+
+// stav hráče po kroku simulace (position = oči / kamera)
+struct PlayerState {
+    glm::vec3 position{ 0.0f };
+    glm::vec3 velocity{ 0.0f };
+    bool on_ground = false;
+};
+
+// Pohyb hráče po terénu pro jeden pevný krok (FixedTimestep): chůze s omezením sklonu, skok,
+// gravitace, kolize těla (koule pod očima) s terénem přes swept sphere a kapsle těla se stěnami labyrintu. Výsledek závisí jen na
+// stavu, vstupu a délce kroku, takže stejný sled vstupů dá stejnou dráhu při libovolném FPS.
+class PlayerPhysics {
+public:
+    struct Settings {
+        float gravity = -20.0f;         // -20 se mi líbí nejvíc
+        float height = 2.0f;            // výška očí nad zemí
+        float radius = 0.3f;            // poloměr těla (chodby labyrintu jsou široké 1)
+        float jump_speed = 10.0f;
+        float max_slope_y = 0.7f;       // chůze po svazích do ~45 stupňů (y složka normály)
+    };
+
+    // Terén: field pro swept sphere (neplatný = jen výška pod hráčem, např. při streamování),
+    // height / normal pro chůzi a pojistku proti propadnutí, ready = terén v bodě už je k dispozici
+    // (prázdné = vždy; jinak hráč na nenačteném terénu stojí)
+    struct Ground {
+        const TerrainHeightField* field = nullptr;
+        std::function<float(float, float)> height;
+        std::function<glm::vec3(float, float)> normal;
+        std::function<bool(float, float)> ready;
+    };
+
+    PlayerPhysics() = default;
+    explicit PlayerPhysics(const Settings& settings) : settings_(settings) {}
+
+    void setGround(Ground ground) { ground_ = std::move(ground); }
+    // stěny labyrintu (nullptr = žádné), tělo = kapsle od chodidel po oči
+    void setWalls(const MazeCollider* walls) { walls_ = walls; }
+    const Settings& settings() const { return settings_; }
+
+    // jeden krok délky dt, vrací true, když hráč v tomto kroku vyskočil
+    bool step(PlayerState& state, const PlayerInput& input, float dt) const;
+
+private:
+    // posun o motion s kolizí těla, true = dopad na schůdný povrch
+    bool move(PlayerState& state, glm::vec3 motion) const;
+
+    Settings settings_;
+    Ground ground_;
+    const MazeCollider* walls_ = nullptr;
+};
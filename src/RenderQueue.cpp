@@ -0,0 +1,120 @@
+#include <algorithm>
+
+#include "RenderQueue.hpp"
+
+void RenderQueue::clear() {
+    items_.clear();
+    entries_.clear();
+}
+
+void RenderQueue::reserve(size_t n) {
+    items_.reserve(n);
+    entries_.reserve(n);
+    scratch_.reserve(n);
+}
+
+void RenderQueue::push(RenderPass pass, const DrawItem& item, float depth) {
+    const uint64_t depth_bits = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * 16777215.0f); // 24 bitů
+    const uint64_t shader_bits = item.shader->getID() & 0x3F;
+    const uint64_t texture_bits = item.texture & 0xFFFF;
+    const uint64_t mesh_bits = item.mesh->getVAO() & 0xFFFF;
+
+    uint64_t key = static_cast<uint64_t>(pass & 0x3) << 62;
+    if (pass == PASS_TRANSPARENT) {
+        // odzadu dopředu: vzdálenější objekty mají menší klíč
+        key |= (0xFFFFFFull - depth_bits) << 38;
+        key |= shader_bits << 32;
+        key |= texture_bits << 16;
+        key |= mesh_bits;
+    } else {
+        // seskupení podle stavu, uvnitř skupiny odpředu dozadu (early-z)
+        key |= shader_bits << 56;
+        key |= texture_bits << 40;
+        key |= mesh_bits << 24;
+        key |= depth_bits;
+    }
+
+    entries_.push_back({ key, static_cast<uint32_t>(items_.size()) });
+    items_.push_back(item);
+}
+
+void RenderQueue::sort() {
+    const size_t n = entries_.size();
+    scratch_.resize(n);
+
+    // LSD radix sort po bajtech, průchody se stejným bajtem u všech klíčů se přeskočí
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t histogram[256] = {};
+        for (const auto& e : entries_) {
+            histogram[(e.key >> shift) & 0xFF]++;
+        }
+        if (n == 0 || histogram[(entries_[0].key >> shift) & 0xFF] == n) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto& h : histogram) {
+            size_t count = h;
+            h = offset;
+            offset += count;
+        }
+        for (const auto& e : entries_) {
+            scratch_[histogram[(e.key >> shift) & 0xFF]++] = e;
+        }
+        entries_.swap(scratch_);
+    }
+}
+
+void RenderQueue::submit() {
+    stats_ = Stats{};
+
+    const ShaderProgram* current_shader = nullptr;
+    GLuint current_texture = 0;
+    GLuint current_vao = 0;
+    uint32_t current_pass = UINT32_MAX;
+
+    for (const auto& e : entries_) {
+        const DrawItem& item = items_[e.index];
+        const uint32_t pass = static_cast<uint32_t>(e.key >> 62);
+
+        // přechod do průhledného průchodu - bez zápisu do hloubky
+        if (pass != current_pass) {
+            glDepthMask(pass == PASS_TRANSPARENT ? GL_FALSE : GL_TRUE);
+            current_pass = pass;
+            stats_.naive_state_changes++; // program se dřív aktivoval jednou za průchod
+        }
+
+        if (item.shader != current_shader) {
+            item.shader->activate();
+            current_shader = item.shader;
+            stats_.state_changes++;
+        }
+        if (item.texture != 0 && item.texture != current_texture) {
+            glBindTextureUnit(0, item.texture);
+            current_texture = item.texture;
+            stats_.state_changes++;
+        }
+        GLuint vao = item.mesh->getVAO();
+        if (vao != current_vao) {
+            glBindVertexArray(vao);
+            current_vao = vao;
+            stats_.state_changes++;
+        }
+
+        item.shader->setUniform("uM_m", item.model_matrix);
+        if (pass == PASS_TRANSPARENT) {
+            item.shader->setUniform("u_diffuse_color", item.diffuse_color);
+        }
+        glDrawElements(item.mesh->primitive_type, (GLsizei)item.mesh->indices.size(), GL_UNSIGNED_INT, (void*)0);
+
+        // Mesh::draw() dělá pro každý objekt bind textury, bind VAO a unbind VAO
+        stats_.naive_state_changes += (item.texture != 0 ? 1 : 0) + 2;
+        stats_.draws++;
+    }
+
+    if (current_vao != 0) {
+        glBindVertexArray(0);
+        stats_.state_changes++;
+    }
+    glDepthMask(GL_TRUE);
+}
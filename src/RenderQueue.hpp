@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "ShaderProgram.hpp"
+#include "Mesh.hpp"
+
+// průchody vykreslování (nejvyšší bity klíče)
+enum RenderPass : uint32_t {
+    PASS_OPAQUE = 0,
+    PASS_TRANSPARENT = 1,
+};
+
+// jedno vykreslení ve frontě
+struct DrawItem {
+    ShaderProgram* shader;
+    const Mesh* mesh;
+    GLuint texture;
+    glm::mat4 model_matrix;
+    glm::vec4 diffuse_color;
+};
+
+// fronta vykreslování řazená 64bitovým klíčem
+// klíč: pass (2b) | shader (6b) | textura (16b) | mesh (16b) | hloubka (24b)
+// průhledný průchod má hloubku (obrácenou, odzadu dopředu) hned za pass, aby šlo o korektní blending
+class RenderQueue {
+public:
+    // počty změn stavu za snímek
+    struct Stats {
+        size_t draws = 0;
+        size_t naive_state_changes = 0;  // kolik by jich bylo při kreslení každého objektu zvlášť
+        size_t state_changes = 0;        // skutečně provedené glUseProgram/glBindTextureUnit/glBindVertexArray
+    };
+
+    void clear();
+    void reserve(size_t n);
+
+    // přidání položky, depth = vzdálenost od kamery normalizovaná do 0..1
+    void push(RenderPass pass, const DrawItem& item, float depth);
+
+    // radix sort podle klíčů
+    void sort();
+
+    // vykreslení se přeskočením redundantních změn stavu
+    void submit();
+
+    const Stats& stats() const { return stats_; }
+    size_t size() const { return items_.size(); }
+
+private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    std::vector<DrawItem> items_;
+    std::vector<SortEntry> entries_;
+    std::vector<SortEntry> scratch_;
+    Stats stats_;
+};
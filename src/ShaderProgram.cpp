@@ -19,6 +19,27 @@ ShaderProgram::ShaderProgram(const std::filesystem::path& VS_file, const std::fi
     ID = link_shader(shader_ids);
 }
 
+ShaderProgram::ShaderProgram(const std::filesystem::path& VS_file, const std::filesystem::path& TCS_file, const std::filesystem::path& TES_file, const std::filesystem::path& FS_file) {
+	std::vector<GLuint> shader_ids;
+
+    // tessellation control + evaluation between vertex and fragment stage
+	shader_ids.push_back(compile_shader(VS_file, GL_VERTEX_SHADER));
+	shader_ids.push_back(compile_shader(TCS_file, GL_TESS_CONTROL_SHADER));
+	shader_ids.push_back(compile_shader(TES_file, GL_TESS_EVALUATION_SHADER));
+	shader_ids.push_back(compile_shader(FS_file, GL_FRAGMENT_SHADER));
+
+    ID = link_shader(shader_ids);
+}
+
+ShaderProgram::ShaderProgram(const std::filesystem::path& CS_file) {
+	std::vector<GLuint> shader_ids;
+
+    // single compute stage
+	shader_ids.push_back(compile_shader(CS_file, GL_COMPUTE_SHADER));
+
+    ID = link_shader(shader_ids);
+}
+
 void ShaderProgram::setUniform(const std::string& name, const float val) {
 	auto loc = glGetUniformLocation(ID, name.c_str());
 	if (loc == -1) {
@@ -37,6 +58,24 @@ void ShaderProgram::setUniform(const std::string& name, const int val) {
 	glUniform1i(loc, val);
 }
 
+void ShaderProgram::setUniform(const std::string& name, const GLuint val) {
+    auto loc = glGetUniformLocation(ID, name.c_str());
+	if (loc == -1) {
+		std::cerr << "no uniform with name:" << name << '\n';
+		return;
+	}
+	glUniform1ui(loc, val);
+}
+
+void ShaderProgram::setUniform(const std::string& name, const glm::vec2 val) {
+    auto loc = glGetUniformLocation(ID, name.c_str());
+	if (loc == -1) {
+		std::cerr << "no uniform with name:" << name << '\n';
+		return;
+	}
+	glUniform2fv(loc, 1, glm::value_ptr(val));
+}
+
 void ShaderProgram::setUniform(const std::string& name, const glm::vec3 val) {
     auto loc = glGetUniformLocation(ID, name.c_str());
 	if (loc == -1) {
@@ -12,9 +12,12 @@ public:
 	// you can add more constructors for pipeline with GS, TS etc.
 	ShaderProgram(void) = default; //does nothing
 	ShaderProgram(const std::filesystem::path & VS_file, const std::filesystem::path & FS_file);
+	explicit ShaderProgram(const std::filesystem::path & CS_file); // compute shader only
+	ShaderProgram(const std::filesystem::path & VS_file, const std::filesystem::path & TCS_file, const std::filesystem::path & TES_file, const std::filesystem::path & FS_file); // with tessellation
 
 	void activate(void) const { glUseProgram(ID); };    // activate shader
 	void deactivate(void) const { glUseProgram(0); };   // deactivate current shader program (i.e. activate shader no. 0)
+	GLuint getID(void) const { return ID; };            // program handle (used for sorting draws)
 
 	void clear(void) { 	//deallocate shader program
 		deactivate();
@@ -26,6 +29,8 @@ public:
     // https://docs.gl/gl4/glUniform
     void setUniform(const std::string & name, const float val);
     void setUniform(const std::string & name, const int val);
+    void setUniform(const std::string & name, const GLuint val);
+    void setUniform(const std::string & name, const glm::vec2 val);
     void setUniform(const std::string & name, const glm::vec3 val);  
     void setUniform(const std::string & name, const glm::vec4 val);
     void setUniform(const std::string & name, const glm::mat3 val);   
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Časová osa startu: etapy (načtení modelu, dekódování textury, ...) s časem začátku a konce od
+// vytvoření osy a vláknem, na kterém běžely. Zápis je thread-safe, etapy se zapisují z pracovních
+// vláken i z hlavního. print() vypíše etapy podle začátku s pruhem na společné ose.
+class StartupTimeline {
+public:
+    using clock = std::chrono::steady_clock;
+
+    struct Stage {
+        std::string name;
+        double start_ms = 0.0;
+        double end_ms = 0.0;
+        std::thread::id thread;
+    };
+
+    // měří etapu od vytvoření do zničení
+    class Scope {
+    public:
+        Scope(StartupTimeline& timeline, std::string name) : timeline_(timeline), name_(std::move(name)), start_(timeline.now()) {}
+        ~Scope() { timeline_.add(std::move(name_), start_, timeline_.now()); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StartupTimeline& timeline_;
+        std::string name_;
+        double start_;
+    };
+
+    StartupTimeline() : origin_(clock::now()) {}
+
+    // ms od vytvoření osy
+    double now() const { return std::chrono::duration<double, std::milli>(clock::now() - origin_).count(); }
+    clock::time_point origin() const { return origin_; }
+
+    void add(std::string name, double start_ms, double end_ms) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stages_.push_back({ std::move(name), start_ms, end_ms, std::this_thread::get_id() });
+    }
+
+    std::vector<Stage> stages() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stages_;
+    }
+
+    // součet délek etap (čas, který by start trval sériově)
+    double serialMs() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double sum = 0.0;
+        for (const Stage& s : stages_) {
+            sum += s.end_ms - s.start_ms;
+        }
+        return sum;
+    }
+
+    void print(std::ostream& out, double total_ms, int width = 50) const {
+        std::vector<Stage> sorted = stages();
+        std::sort(sorted.begin(), sorted.end(), [](const Stage& a, const Stage& b) { return a.start_ms < b.start_ms; });
+
+        // vlákna očíslovaná v pořadí prvního výskytu, hlavní (volající) = 0
+        std::vector<std::thread::id> threads = { std::this_thread::get_id() };
+        size_t name_width = 0;
+        for (const Stage& s : sorted) {
+            if (std::find(threads.begin(), threads.end(), s.thread) == threads.end()) {
+                threads.push_back(s.thread);
+            }
+            name_width = (std::max)(name_width, s.name.size());
+        }
+
+        const double scale = total_ms > 0.0 ? width / total_ms : 0.0;
+        out << "Start (" << std::fixed << std::setprecision(1) << total_ms << " ms, etapy soucet " << serialMs() << " ms):" << std::endl;
+        for (const Stage& s : sorted) {
+            const size_t thread = std::find(threads.begin(), threads.end(), s.thread) - threads.begin();
+            const int from = static_cast<int>(s.start_ms * scale);
+            const int to = (std::max)(static_cast<int>(s.end_ms * scale), from + 1);
+            std::ostringstream bar;
+            bar << std::string(from, ' ') << std::string(to - from, '#');
+            out << "  " << std::left << std::setw(static_cast<int>(name_width)) << s.name << std::right << " v" << thread << " "
+                << std::setw(8) << s.start_ms << " - " << std::setw(8) << s.end_ms << " ms |" << std::left << std::setw(width + 1) << bar.str() << std::right << "|" << std::endl;
+        }
+        out << std::defaultfloat << std::setprecision(6);
+    }
+
+private:
+    clock::time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<Stage> stages_;
+};
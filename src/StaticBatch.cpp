@@ -0,0 +1,208 @@
+#include <algorithm>
+
+#include "StaticBatch.hpp"
+
+uint32_t StaticBatch::addMesh(const Mesh& mesh) {
+    MeshRange range;
+    range.first_index = static_cast<GLuint>(indices_.size());
+    range.count = static_cast<GLuint>(mesh.indices.size());
+    range.base_vertex = static_cast<GLint>(vertices_.size());
+    range.bounds = mesh.bounds;
+
+    vertices_.insert(vertices_.end(), mesh.vertices.begin(), mesh.vertices.end());
+
+    // stejné indexy (např. plné dlaždice terénu) se uloží jen jednou, liší se jen base_vertex
+    bool shared = false;
+    for (const auto& other : ranges_) {
+        if (other.count == range.count && std::equal(mesh.indices.begin(), mesh.indices.end(), indices_.begin() + other.first_index)) {
+            range.first_index = other.first_index;
+            shared = true;
+            break;
+        }
+    }
+    if (!shared) {
+        indices_.insert(indices_.end(), mesh.indices.begin(), mesh.indices.end());
+    }
+
+    ranges_.push_back(range);
+    return static_cast<uint32_t>(ranges_.size() - 1);
+}
+
+uint32_t StaticBatch::addDraw(uint32_t mesh_range, const glm::mat4& model_matrix, GLuint texture_layer, const glm::vec4& diffuse_color, GLuint flags) {
+    const MeshRange& range = ranges_[mesh_range];
+    uint32_t draw_id = static_cast<uint32_t>(commands_.size());
+
+    commands_.push_back({ range.count, 1, range.first_index, range.base_vertex, draw_id });
+
+    DrawData data{};
+    data.model_matrix = model_matrix;
+    data.diffuse_color = diffuse_color;
+    data.texture_layer = texture_layer;
+    data.flags = flags;
+    draw_data_.push_back(data);
+    bounds_.push_back(range.bounds.transformed(model_matrix));
+
+    return draw_id;
+}
+
+GLuint StaticBatch::addIndices(const std::vector<GLuint>& indices) {
+    GLuint first_index = static_cast<GLuint>(indices_.size());
+    indices_.insert(indices_.end(), indices.begin(), indices.end());
+    return first_index;
+}
+
+void StaticBatch::upload() {
+    if (commands_.empty()) {
+        return;
+    }
+
+    // 1. Sdílený vertex a index buffer
+    glCreateVertexArrays(1, &VAO);
+    glCreateBuffers(1, &VBO);
+    glNamedBufferStorage(VBO, vertices_.size() * sizeof(vertex), vertices_.data(), 0);
+    glCreateBuffers(1, &EBO);
+    glNamedBufferStorage(EBO, indices_.size() * sizeof(GLuint), indices_.data(), 0);
+
+    // 2. Formát vrcholů stejný jako v Mesh
+    glVertexArrayVertexBuffer(VAO, 0, VBO, 0, sizeof(vertex));
+    glVertexArrayElementBuffer(VAO, EBO);
+
+    glEnableVertexArrayAttrib(VAO, 0);
+    glVertexArrayAttribFormat(VAO, 0, 3, GL_FLOAT, GL_FALSE, offsetof(vertex, position));
+    glVertexArrayAttribBinding(VAO, 0, 0);
+
+    glEnableVertexArrayAttrib(VAO, 1);
+    glVertexArrayAttribFormat(VAO, 1, 3, GL_FLOAT, GL_FALSE, offsetof(vertex, normal));
+    glVertexArrayAttribBinding(VAO, 1, 0);
+
+    glEnableVertexArrayAttrib(VAO, 2);
+    glVertexArrayAttribFormat(VAO, 2, 2, GL_FLOAT, GL_FALSE, offsetof(vertex, texCoords));
+    glVertexArrayAttribBinding(VAO, 2, 0);
+
+    // 3. Index vykreslení jako instancovaný atribut - base_instance příkazu ho posune na správný draw
+    //    (na rozdíl od gl_DrawID platí i po kompakci příkazů na GPU)
+    std::vector<GLuint> draw_ids(commands_.size());
+    for (GLuint i = 0; i < draw_ids.size(); ++i) {
+        draw_ids[i] = i;
+    }
+    glCreateBuffers(1, &draw_id_buffer);
+    glNamedBufferStorage(draw_id_buffer, draw_ids.size() * sizeof(GLuint), draw_ids.data(), 0);
+    glVertexArrayVertexBuffer(VAO, 1, draw_id_buffer, 0, sizeof(GLuint));
+    glVertexArrayBindingDivisor(VAO, 1, 1);
+
+    glEnableVertexArrayAttrib(VAO, 3);
+    glVertexArrayAttribIFormat(VAO, 3, 1, GL_UNSIGNED_INT, 0);
+    glVertexArrayAttribBinding(VAO, 3, 1);
+
+    // 4. Data vykreslení (SSBO) a příkazy (indirect buffer, přepisuje se každý snímek)
+    glCreateBuffers(1, &draw_data_ssbo);
+    glNamedBufferStorage(draw_data_ssbo, draw_data_.size() * sizeof(DrawData), draw_data_.data(), 0);
+
+    glCreateBuffers(1, &indirect_buffer);
+    glNamedBufferStorage(indirect_buffer, commands_.size() * sizeof(DrawElementsIndirectCommand), commands_.data(), GL_DYNAMIC_STORAGE_BIT);
+
+    // 5. Vstupy GPU cullingu - bounding boxy a šablona všech příkazů
+    std::vector<glm::vec4> bounds_data;
+    bounds_data.reserve(bounds_.size() * 2);
+    for (const auto& b : bounds_) {
+        bounds_data.push_back(glm::vec4(b.min, 0.0f));
+        bounds_data.push_back(glm::vec4(b.max, 0.0f));
+    }
+    glCreateBuffers(1, &bounds_ssbo);
+    glNamedBufferStorage(bounds_ssbo, bounds_data.size() * sizeof(glm::vec4), bounds_data.data(), 0);
+
+    glCreateBuffers(1, &command_template);
+    glNamedBufferStorage(command_template, commands_.size() * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_STORAGE_BIT);
+    template_dirty_ = true;
+    flushCommands();
+}
+
+void StaticBatch::setDrawIndices(uint32_t draw, GLuint first_index, GLuint count) {
+    DrawElementsIndirectCommand& cmd = commands_[draw];
+    if (cmd.first_index != first_index || cmd.count != count) {
+        cmd.first_index = first_index;
+        cmd.count = count;
+        template_dirty_ = true;
+    }
+}
+
+void StaticBatch::flushCommands() {
+    if (!template_dirty_ || command_template == 0) {
+        return;
+    }
+
+    std::vector<DrawElementsIndirectCommand> all_commands = commands_;
+    for (auto& cmd : all_commands) {
+        cmd.instance_count = 1;
+    }
+    glNamedBufferSubData(command_template, 0, all_commands.size() * sizeof(DrawElementsIndirectCommand), all_commands.data());
+    template_dirty_ = false;
+}
+
+void StaticBatch::setAllVisible(bool visible) {
+    for (auto& cmd : commands_) {
+        cmd.instance_count = visible ? 1 : 0;
+    }
+}
+
+void StaticBatch::bind() const {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, draw_data_ssbo);
+    glBindVertexArray(VAO);
+}
+
+void StaticBatch::unbind() const {
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void StaticBatch::draw() {
+    if (VAO == 0) {
+        return;
+    }
+
+    glNamedBufferSubData(indirect_buffer, 0, commands_.size() * sizeof(DrawElementsIndirectCommand), commands_.data());
+
+    bind();
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commands_.size()), 0);
+    unbind();
+}
+
+void StaticBatch::drawIndirect(GLuint command_buffer, GLuint count_buffer) const {
+    if (VAO == 0) {
+        return;
+    }
+
+    bind();
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer);
+    if (count_buffer != 0) {
+        // počet příkazů čte GPU (ARB_indirect_parameters / GL 4.6)
+        glBindBuffer(GL_PARAMETER_BUFFER_ARB, count_buffer);
+        glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0, static_cast<GLsizei>(commands_.size()), 0);
+        glBindBuffer(GL_PARAMETER_BUFFER_ARB, 0);
+    } else {
+        // bez indirect count - nevyužité příkazy na konci bufferu mají count 0
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commands_.size()), 0);
+    }
+    unbind();
+}
+
+void StaticBatch::clear() {
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glDeleteBuffers(1, &draw_id_buffer);
+    glDeleteBuffers(1, &draw_data_ssbo);
+    glDeleteBuffers(1, &bounds_ssbo);
+    glDeleteBuffers(1, &indirect_buffer);
+    glDeleteBuffers(1, &command_template);
+    glDeleteVertexArrays(1, &VAO);
+    VAO = VBO = EBO = draw_id_buffer = draw_data_ssbo = bounds_ssbo = indirect_buffer = command_template = 0;
+
+    vertices_.clear();
+    indices_.clear();
+    ranges_.clear();
+    commands_.clear();
+    draw_data_.clear();
+    bounds_.clear();
+    template_dirty_ = false;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "assets.hpp"
+#include "Mesh.hpp"
+#include "ShaderProgram.hpp"
+
+// příkaz pro glMultiDrawElementsIndirect (rozložení daná specifikací OpenGL)
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint base_instance;
+};
+
+// data jednoho vykreslení v SSBO (std430), shader je čte podle indexu draw (instancovaný atribut + base_instance)
+struct DrawData {
+    glm::mat4 model_matrix;
+    glm::vec4 diffuse_color;
+    GLuint texture_layer;   // vrstva v poli textur materiálů
+    GLuint flags;
+    GLuint pad[2];
+};
+
+// příznaky vykreslení (DrawData.flags, phong_mdi.frag)
+enum DrawFlags : GLuint {
+    DRAW_TERRAIN = 1u << 0,     // texture_layer je první z vrstev terénu, míchají se podle výšky
+};
+
+// statická neprůhledná geometrie ve sdílených bufferech, kreslená jedním glMultiDrawElementsIndirect
+class StaticBatch {
+public:
+    // rozsah meshe ve sdíleném vertex/index bufferu
+    struct MeshRange {
+        GLuint first_index;
+        GLuint count;
+        GLint base_vertex;
+        AABB bounds;        // lokální bounding box meshe
+    };
+
+    // suballokace meshe (kopie vrcholů, shodné indexové vzory se sdílí přes base_vertex)
+    uint32_t addMesh(const Mesh& mesh);
+
+    // přidání vykreslení, vrací index draw (= base_instance příkazu)
+    uint32_t addDraw(uint32_t mesh_range, const glm::mat4& model_matrix, GLuint texture_layer, const glm::vec4& diffuse_color = glm::vec4(1.0f), GLuint flags = 0);
+
+    // další indexy nad již přidanými vrcholy (např. LOD vzory terénu), vrací first_index
+    GLuint addIndices(const std::vector<GLuint>& indices);
+
+    // nahrání do VRAM (po přidání všech meshů a vykreslení)
+    void upload();
+
+    // viditelnost vykreslení pro tento snímek (neviditelné mají instance_count = 0)
+    void setVisible(uint32_t draw, bool visible) { commands_[draw].instance_count = visible ? 1 : 0; }
+    bool isVisible(uint32_t draw) const { return commands_[draw].instance_count != 0; }
+    void setAllVisible(bool visible);
+
+    // jiný rozsah indexů vykreslení (LOD), do šablony GPU cullingu se dostane přes flushCommands()
+    void setDrawIndices(uint32_t draw, GLuint first_index, GLuint count);
+    void flushCommands();
+
+    // nahrání příkazů a vykreslení celé dávky jedním voláním
+    void draw();
+
+    // vykreslení příkazy z jiného bufferu (GPU culling), count_buffer = počet příkazů na GPU (0 = všechny)
+    void drawIndirect(GLuint command_buffer, GLuint count_buffer = 0) const;
+
+    void clear();
+
+    size_t drawCount() const { return commands_.size(); }
+    size_t vertexCount() const { return vertices_.size(); }
+    size_t indexCount() const { return indices_.size(); }
+
+    // pro GPU culling: bounding boxy vykreslení ve světových souřadnicích a šablona všech příkazů
+    const std::vector<AABB>& drawBounds() const { return bounds_; }
+    GLuint boundsBuffer() const { return bounds_ssbo; }
+    GLuint commandTemplateBuffer() const { return command_template; }
+
+private:
+    std::vector<vertex> vertices_;
+    std::vector<GLuint> indices_;
+    std::vector<MeshRange> ranges_;
+    std::vector<DrawElementsIndirectCommand> commands_;
+    std::vector<DrawData> draw_data_;
+    std::vector<AABB> bounds_;
+    bool template_dirty_ = false;
+
+    void bind() const;
+    void unbind() const;
+
+    GLuint VAO{ 0 }, VBO{ 0 }, EBO{ 0 };
+    GLuint draw_id_buffer{ 0 };     // 0..N-1, instancovaný atribut (index = base_instance)
+    GLuint draw_data_ssbo{ 0 };
+    GLuint bounds_ssbo{ 0 };        // vec4 min, vec4 max na vykreslení
+    GLuint indirect_buffer{ 0 };
+    GLuint command_template{ 0 };   // všechny příkazy s instance_count = 1
+};
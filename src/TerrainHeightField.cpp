@@ -0,0 +1,465 @@
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+#define TERRAIN_HAS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TERRAIN_HAS_SSE2 1
+#endif
+
+#include "TerrainHeightField.hpp"
+
+namespace {
+
+// mapa pro jádra dávek (rozbalené členy TerrainHeightField)
+struct Field {
+    const float* heights;
+    size_t row_stride;
+    float x_max, z_max;     // width - 1, height - 1
+
+    // přednačtení obou řádků čtyřúhelníku pod bodem (mimo mapu nic)
+    void prefetch(float x, float z) const {
+#ifdef TERRAIN_HAS_SSE2
+        if (x >= 0.0f && x < x_max && z >= 0.0f && z < z_max) {
+            const float* p = heights + static_cast<size_t>(z) * row_stride + static_cast<size_t>(x);
+            _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0);
+            _mm_prefetch(reinterpret_cast<const char*>(p + row_stride), _MM_HINT_T0);
+        }
+#else
+        (void)x;
+        (void)z;
+#endif
+    }
+};
+
+#ifdef TERRAIN_HAS_SSE2
+// 4 body: platnost, zlomky ve čtyřúhelníku a rohy h00, h10, h01, h11 (neplatné body čtou vzorek 0, 0)
+struct Quad4 {
+    __m128 valid, fx, fz, h00, h10, h01, h11;
+};
+
+Quad4 gather4(const Field& f, const float* x, const float* z) {
+    Quad4 q;
+    __m128 xv = _mm_loadu_ps(x), zv = _mm_loadu_ps(z);
+    const __m128 zero = _mm_setzero_ps();
+    q.valid = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(xv, zero), _mm_cmplt_ps(xv, _mm_set1_ps(f.x_max))),
+                         _mm_and_ps(_mm_cmpge_ps(zv, zero), _mm_cmplt_ps(zv, _mm_set1_ps(f.z_max))));
+    xv = _mm_and_ps(xv, q.valid);
+    zv = _mm_and_ps(zv, q.valid);
+    __m128i gx = _mm_cvttps_epi32(xv), gz = _mm_cvttps_epi32(zv);
+    q.fx = _mm_sub_ps(xv, _mm_cvtepi32_ps(gx));
+    q.fz = _mm_sub_ps(zv, _mm_cvtepi32_ps(gz));
+
+    // SSE2 nemá gather ani 32bitové násobení - adresy skalárně
+    alignas(16) int ix[4], iz[4];
+    alignas(16) float c[4][4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(ix), gx);
+    _mm_store_si128(reinterpret_cast<__m128i*>(iz), gz);
+    for (int l = 0; l < 4; ++l) {
+        const float* p = f.heights + static_cast<size_t>(iz[l]) * f.row_stride + ix[l];
+        c[0][l] = p[0];
+        c[1][l] = p[1];
+        c[2][l] = p[f.row_stride];
+        c[3][l] = p[f.row_stride + 1];
+    }
+    q.h00 = _mm_load_ps(c[0]);
+    q.h10 = _mm_load_ps(c[1]);
+    q.h01 = _mm_load_ps(c[2]);
+    q.h11 = _mm_load_ps(c[3]);
+    return q;
+}
+
+// sklony trojúhelníku pod body (viz TerrainHeightField::trianglePlane) - výběr maskou
+void plane4(const Quad4& q, __m128& dx, __m128& dz) {
+    const __m128 upper = _mm_cmpge_ps(q.fx, q.fz);
+    dx = _mm_or_ps(_mm_and_ps(upper, _mm_sub_ps(q.h10, q.h00)), _mm_andnot_ps(upper, _mm_sub_ps(q.h11, q.h01)));
+    dz = _mm_or_ps(_mm_and_ps(upper, _mm_sub_ps(q.h11, q.h10)), _mm_andnot_ps(upper, _mm_sub_ps(q.h01, q.h00)));
+}
+
+void heightsSse2(const Field& f, const float* x, const float* z, size_t begin, size_t end, float* out) {
+    for (size_t i = begin; i < end; i += 4) {
+        for (size_t p = i + TerrainHeightField::PREFETCH_DISTANCE; p < i + TerrainHeightField::PREFETCH_DISTANCE + 4 && p < end; ++p) {
+            f.prefetch(x[p], z[p]);
+        }
+        Quad4 q = gather4(f, x + i, z + i);
+        __m128 dx, dz;
+        plane4(q, dx, dz);
+        __m128 h = _mm_add_ps(q.h00, _mm_add_ps(_mm_mul_ps(q.fx, dx), _mm_mul_ps(q.fz, dz)));
+        _mm_storeu_ps(out + i, _mm_and_ps(h, q.valid));
+    }
+}
+
+void normalsSse2(const Field& f, const float* x, const float* z, size_t begin, size_t end, float* nx, float* ny, float* nz) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (size_t i = begin; i < end; i += 4) {
+        for (size_t p = i + TerrainHeightField::PREFETCH_DISTANCE; p < i + TerrainHeightField::PREFETCH_DISTANCE + 4 && p < end; ++p) {
+            f.prefetch(x[p], z[p]);
+        }
+        Quad4 q = gather4(f, x + i, z + i);
+        // normála (-dx, 1, -dz)
+        __m128 a, b;
+        plane4(q, a, b);
+        a = _mm_sub_ps(_mm_setzero_ps(), a);
+        b = _mm_sub_ps(_mm_setzero_ps(), b);
+        __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a, a), _mm_mul_ps(b, b)), one));
+        // neplatné body: a = b = 0, len = 1 -> (0, 1, 0)
+        a = _mm_and_ps(a, q.valid);
+        b = _mm_and_ps(b, q.valid);
+        len = _mm_or_ps(_mm_and_ps(q.valid, len), _mm_andnot_ps(q.valid, one));
+        _mm_storeu_ps(nx + i, _mm_div_ps(a, len));
+        _mm_storeu_ps(ny + i, _mm_div_ps(one, len));
+        _mm_storeu_ps(nz + i, _mm_div_ps(b, len));
+    }
+}
+#endif
+
+#ifdef TERRAIN_HAS_AVX2
+struct Quad8 {
+    __m256 valid, fx, fz, h00, h10, h01, h11;
+};
+
+Quad8 gather8(const Field& f, const float* x, const float* z) {
+    Quad8 q;
+    __m256 xv = _mm256_loadu_ps(x), zv = _mm256_loadu_ps(z);
+    const __m256 zero = _mm256_setzero_ps();
+    q.valid = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(xv, zero, _CMP_GE_OQ), _mm256_cmp_ps(xv, _mm256_set1_ps(f.x_max), _CMP_LT_OQ)),
+                            _mm256_and_ps(_mm256_cmp_ps(zv, zero, _CMP_GE_OQ), _mm256_cmp_ps(zv, _mm256_set1_ps(f.z_max), _CMP_LT_OQ)));
+    xv = _mm256_and_ps(xv, q.valid);
+    zv = _mm256_and_ps(zv, q.valid);
+    __m256i gx = _mm256_cvttps_epi32(xv), gz = _mm256_cvttps_epi32(zv);
+    q.fx = _mm256_sub_ps(xv, _mm256_cvtepi32_ps(gx));
+    q.fz = _mm256_sub_ps(zv, _mm256_cvtepi32_ps(gz));
+
+    // index vzorku v 32 bitech (mapy do 2^31 vzorků), rohy čtyřmi gathery
+    const __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(gz, _mm256_set1_epi32(static_cast<int>(f.row_stride))), gx);
+    q.h00 = _mm256_i32gather_ps(f.heights, index, 4);
+    q.h10 = _mm256_i32gather_ps(f.heights + 1, index, 4);
+    q.h01 = _mm256_i32gather_ps(f.heights + f.row_stride, index, 4);
+    q.h11 = _mm256_i32gather_ps(f.heights + f.row_stride + 1, index, 4);
+    return q;
+}
+
+void plane8(const Quad8& q, __m256& dx, __m256& dz) {
+    const __m256 upper = _mm256_cmp_ps(q.fx, q.fz, _CMP_GE_OQ);
+    dx = _mm256_blendv_ps(_mm256_sub_ps(q.h11, q.h01), _mm256_sub_ps(q.h10, q.h00), upper);
+    dz = _mm256_blendv_ps(_mm256_sub_ps(q.h01, q.h00), _mm256_sub_ps(q.h11, q.h10), upper);
+}
+
+void heightsAvx2(const Field& f, const float* x, const float* z, size_t begin, size_t end, float* out) {
+    for (size_t i = begin; i < end; i += 8) {
+        for (size_t p = i + TerrainHeightField::PREFETCH_DISTANCE; p < i + TerrainHeightField::PREFETCH_DISTANCE + 8 && p < end; ++p) {
+            f.prefetch(x[p], z[p]);
+        }
+        Quad8 q = gather8(f, x + i, z + i);
+        __m256 dx, dz;
+        plane8(q, dx, dz);
+        __m256 h = _mm256_fmadd_ps(q.fz, dz, _mm256_fmadd_ps(q.fx, dx, q.h00));
+        _mm256_storeu_ps(out + i, _mm256_and_ps(h, q.valid));
+    }
+}
+
+void normalsAvx2(const Field& f, const float* x, const float* z, size_t begin, size_t end, float* nx, float* ny, float* nz) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (size_t i = begin; i < end; i += 8) {
+        for (size_t p = i + TerrainHeightField::PREFETCH_DISTANCE; p < i + TerrainHeightField::PREFETCH_DISTANCE + 8 && p < end; ++p) {
+            f.prefetch(x[p], z[p]);
+        }
+        Quad8 q = gather8(f, x + i, z + i);
+        __m256 a, b;
+        plane8(q, a, b);
+        a = _mm256_sub_ps(_mm256_setzero_ps(), a);
+        b = _mm256_sub_ps(_mm256_setzero_ps(), b);
+        a = _mm256_and_ps(a, q.valid);
+        b = _mm256_and_ps(b, q.valid);
+        __m256 len = _mm256_sqrt_ps(_mm256_fmadd_ps(a, a, _mm256_fmadd_ps(b, b, one)));
+        _mm256_storeu_ps(nx + i, _mm256_div_ps(a, len));
+        _mm256_storeu_ps(ny + i, _mm256_div_ps(one, len));
+        _mm256_storeu_ps(nz + i, _mm256_div_ps(b, len));
+    }
+}
+#endif
+
+// nejbližší bod trojúhelníku abc k bodu p (Ericson, Real-Time Collision Detection 5.1.5)
+glm::vec3 closestOnTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    const glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    const float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+    const glm::vec3 bp = p - b;
+    const float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
+    const glm::vec3 cp = p - c;
+    const float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    const float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// bod roviny trojúhelníku leží uvnitř (barycentricky)
+bool insideTriangle(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+    const glm::vec3 v0 = b - a, v1 = c - a, v2 = p - a;
+    const float d00 = glm::dot(v0, v0), d01 = glm::dot(v0, v1), d11 = glm::dot(v1, v1);
+    const float d20 = glm::dot(v2, v0), d21 = glm::dot(v2, v1);
+    const float denom = d00 * d11 - d01 * d01;
+    const float v = (d11 * d20 - d01 * d21) / denom;
+    const float w = (d00 * d21 - d01 * d20) / denom;
+    return v >= 0.0f && w >= 0.0f && v + w <= 1.0f;
+}
+
+// menší kořen a t^2 + b t + c = 0, pokud leží v [0, max_t) (záporný = koule už překrývá, řeší test startu)
+bool lowestRoot(float a, float b, float c, float max_t, float& root) {
+    if (a == 0.0f) return false;
+    const float det = b * b - 4.0f * a * c;
+    if (det < 0.0f) return false;
+    // stabilní tvar bez odečítání blízkých čísel (daleké starty by jinak ztratily přesnost)
+    const float q = -0.5f * (b + std::copysign(std::sqrt(det), b));
+    if (q == 0.0f) return false;
+    root = (std::min)(q / a, c / q);
+    return root >= 0.0f && root < max_t;
+}
+
+// Pohyb koule proti jednomu trojúhelníku. Souřadnice jsou relativní ke startu středu (střed v počátku),
+// takže i na velké mapě stačí float. Při dotyku už na startu se hlásí t = 0 jen pro pohyb do povrchu,
+// pohyb od něj (nebo po něm) trojúhelník přeskočí - jinak by klouzání po zemi uvízlo.
+struct SphereSweep {
+    glm::vec3 v;        // pohyb
+    float r;
+    float t = 1.0f;     // zatím nejbližší dotyk
+    glm::vec3 point{ 0.0f };
+    bool hit = false;
+
+    void triangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, bool near_start) {
+        if (near_start) {
+            const glm::vec3 q = closestOnTriangle(glm::vec3(0.0f), a, b, c);
+            if (glm::dot(q, q) < r * r) {
+                if (glm::dot(v, q) > 0.0f) {
+                    t = 0.0f;
+                    point = q;
+                    hit = true;
+                }
+                return;
+            }
+        }
+
+        // stěna: vzdálenost středu od roviny klesne na r (dřív se koule trojúhelníku dotknout nemůže)
+        glm::vec3 n = glm::normalize(glm::cross(c - a, b - a));
+        if (n.y < 0.0f) n = -n;
+        const float dist = -glm::dot(n, a);
+        const float vn = glm::dot(n, v);
+        if (dist >= r) {
+            if (vn >= 0.0f) return;
+            const float tc = (dist - r) / -vn;
+            if (tc >= t) return;
+            const glm::vec3 p = v * tc - n * r;
+            if (insideTriangle(p, a, b, c)) {
+                t = tc;
+                point = p;
+                hit = true;
+                return;
+            }
+        }
+
+        // vrcholy: |t v - p|^2 = r^2
+        const float vv = glm::dot(v, v);
+        for (const glm::vec3* p : { &a, &b, &c }) {
+            float tc;
+            if (lowestRoot(vv, -2.0f * glm::dot(v, *p), glm::dot(*p, *p) - r * r, t, tc)) {
+                t = tc;
+                point = *p;
+                hit = true;
+            }
+        }
+
+        // hrany: vzdálenost středu od přímky hrany = r (pohyb a start kolmo k hraně) a bod dotyku uvnitř úsečky
+        const glm::vec3* edges[3][2] = { { &a, &b }, { &b, &c }, { &c, &a } };
+        for (const auto& edge : edges) {
+            const glm::vec3& base = *edge[0];
+            const glm::vec3 e = *edge[1] - base;
+            const float ee = glm::dot(e, e);
+            const glm::vec3 v_perp = v - e * (glm::dot(v, e) / ee);
+            const glm::vec3 base_perp = base - e * (glm::dot(base, e) / ee);
+            float tc;
+            if (lowestRoot(glm::dot(v_perp, v_perp), -2.0f * glm::dot(v_perp, base_perp), glm::dot(base_perp, base_perp) - r * r, t, tc)) {
+                const float f = glm::dot(v * tc - base, e) / ee;
+                if (f >= 0.0f && f <= 1.0f) {
+                    t = tc;
+                    point = base + e * f;
+                    hit = true;
+                }
+            }
+        }
+    }
+};
+
+// úsečka origin + t * dir, t z [0, max_t], protíná box
+bool segmentHitsBox(const glm::vec3& origin, const glm::vec3& dir, float max_t, const glm::vec3& lo, const glm::vec3& hi) {
+    float t0 = 0.0f, t1 = max_t;
+    for (int k = 0; k < 3; ++k) {
+        if (std::abs(dir[k]) < 1e-12f) {
+            if (origin[k] < lo[k] || origin[k] > hi[k]) return false;
+            continue;
+        }
+        const float inv = 1.0f / dir[k];
+        float ta = (lo[k] - origin[k]) * inv, tb = (hi[k] - origin[k]) * inv;
+        if (ta > tb) std::swap(ta, tb);
+        t0 = (std::max)(t0, ta);
+        t1 = (std::min)(t1, tb);
+        if (t0 > t1) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+void TerrainHeightField::heights(const float* x, const float* z, size_t count, float* out, TerrainSimd simd) const {
+    const Field f{ heights_, row_stride_, static_cast<float>(width_ - 1), static_cast<float>(height_ - 1) };
+    simd = (std::min)(simd, TerrainMesh::bestSimd());
+    size_t i = 0;
+#if defined(TERRAIN_HAS_AVX2)
+    if (simd == TERRAIN_SIMD_AVX2) {
+        i = count - count % 8;
+        heightsAvx2(f, x, z, 0, i, out);
+    }
+#endif
+#if defined(TERRAIN_HAS_SSE2)
+    if (simd == TERRAIN_SIMD_SSE2) {
+        i = count - count % 4;
+        heightsSse2(f, x, z, 0, i, out);
+    }
+#endif
+    // zbytek dávky (a skalární cesta)
+    for (; i < count; ++i) {
+        if (i + PREFETCH_DISTANCE < count) {
+            f.prefetch(x[i + PREFETCH_DISTANCE], z[i + PREFETCH_DISTANCE]);
+        }
+        out[i] = height(x[i], z[i]);
+    }
+}
+
+void TerrainHeightField::normals(const float* x, const float* z, size_t count, float* nx, float* ny, float* nz, TerrainSimd simd) const {
+    const Field f{ heights_, row_stride_, static_cast<float>(width_ - 1), static_cast<float>(height_ - 1) };
+    simd = (std::min)(simd, TerrainMesh::bestSimd());
+    size_t i = 0;
+#if defined(TERRAIN_HAS_AVX2)
+    if (simd == TERRAIN_SIMD_AVX2) {
+        i = count - count % 8;
+        normalsAvx2(f, x, z, 0, i, nx, ny, nz);
+    }
+#endif
+#if defined(TERRAIN_HAS_SSE2)
+    if (simd == TERRAIN_SIMD_SSE2) {
+        i = count - count % 4;
+        normalsSse2(f, x, z, 0, i, nx, ny, nz);
+    }
+#endif
+    for (; i < count; ++i) {
+        if (i + PREFETCH_DISTANCE < count) {
+            f.prefetch(x[i + PREFETCH_DISTANCE], z[i + PREFETCH_DISTANCE]);
+        }
+        glm::vec3 n = normal(x[i], z[i]);
+        nx[i] = n.x;
+        ny[i] = n.y;
+        nz[i] = n.z;
+    }
+}
+
+bool TerrainHeightField::sweepSphere(const glm::vec3& from, const glm::vec3& to, float radius, TerrainHit& hit) const {
+    if (!valid() || width_ < 2 || height_ < 2) {
+        return false;
+    }
+    // střed pod povrchem (koule celá v terénu) - dotyk hned, ven po normále
+    const float ground = height(from.x, from.z);
+    if (from.x >= 0.0f && from.x < width_ - 1 && from.z >= 0.0f && from.z < height_ - 1 && from.y < ground) {
+        hit.t = 0.0f;
+        hit.center = from;
+        hit.point = glm::vec3(from.x, ground, from.z);
+        hit.normal = normal(from.x, from.z);
+        return true;
+    }
+
+    SphereSweep sweep{ to - from, radius };
+    const int x_begin = (std::max)(0, static_cast<int>(std::floor((std::min)(from.x, to.x) - radius)));
+    const int x_end = (std::min)(width_ - 2, static_cast<int>(std::floor((std::max)(from.x, to.x) + radius)));
+    const int z_begin = (std::max)(0, static_cast<int>(std::floor((std::min)(from.z, to.z) - radius)));
+    const int z_end = (std::min)(height_ - 2, static_cast<int>(std::floor((std::max)(from.z, to.z) + radius)));
+
+    // buňky ve směru pohybu - blízké dotyky zkrátí t dřív a box dalších buněk pak častěji mine
+    const int x_first = sweep.v.x >= 0.0f ? x_begin : x_end, x_dir = sweep.v.x >= 0.0f ? 1 : -1;
+    const int z_first = sweep.v.z >= 0.0f ? z_begin : z_end, z_dir = sweep.v.z >= 0.0f ? 1 : -1;
+    const glm::vec3 pad(radius);
+    for (int ix = 0; ix <= x_end - x_begin; ++ix) {
+        const int gx = x_first + ix * x_dir;
+        for (int iz = 0; iz <= z_end - z_begin; ++iz) {
+            const int gz = z_first + iz * z_dir;
+            const float h00 = sample(gx, gz), h10 = sample(gx + 1, gz);
+            const float h01 = sample(gx, gz + 1), h11 = sample(gx + 1, gz + 1);
+            const glm::vec3 lo = glm::vec3(gx, (std::min)((std::min)(h00, h10), (std::min)(h01, h11)), gz) - pad;
+            const glm::vec3 hi = glm::vec3(gx + 1, (std::max)((std::max)(h00, h10), (std::max)(h01, h11)), gz + 1) + pad;
+            if (!segmentHitsBox(from, sweep.v, sweep.t, lo, hi)) {
+                continue;
+            }
+            const bool near_start = segmentHitsBox(from, sweep.v, 0.0f, lo, hi);   // start v boxu
+            // vrcholy relativně ke startu, trojúhelníky (p0, p1, p2) a (p0, p2, p3)
+            const glm::vec3 p0 = glm::vec3(gx, h00, gz) - from;
+            const glm::vec3 p1 = glm::vec3(gx + 1, h10, gz) - from;
+            const glm::vec3 p2 = glm::vec3(gx + 1, h11, gz + 1) - from;
+            const glm::vec3 p3 = glm::vec3(gx, h01, gz + 1) - from;
+            sweep.triangle(p0, p1, p2, near_start);
+            sweep.triangle(p0, p2, p3, near_start);
+            if (sweep.hit && sweep.t == 0.0f) {
+                break;
+            }
+        }
+        if (sweep.hit && sweep.t == 0.0f) {
+            break;
+        }
+    }
+    if (!sweep.hit) {
+        return false;
+    }
+
+    hit.t = sweep.t;
+    hit.center = from + sweep.v * sweep.t;
+    hit.point = from + sweep.point;
+    const glm::vec3 away = sweep.v * sweep.t - sweep.point;
+    const float len = glm::length(away);
+    hit.normal = len > 1e-6f ? away / len : normal(hit.point.x, hit.point.z);
+    return true;
+}
+
+bool TerrainHeightField::overlapSphere(const glm::vec3& center, float radius) const {
+    if (!valid() || width_ < 2 || height_ < 2) {
+        return false;
+    }
+    if (center.x >= 0.0f && center.x < width_ - 1 && center.z >= 0.0f && center.z < height_ - 1 && center.y < height(center.x, center.z)) {
+        return true;
+    }
+    const int x_begin = (std::max)(0, static_cast<int>(std::floor(center.x - radius)));
+    const int x_end = (std::min)(width_ - 2, static_cast<int>(std::floor(center.x + radius)));
+    const int z_begin = (std::max)(0, static_cast<int>(std::floor(center.z - radius)));
+    const int z_end = (std::min)(height_ - 2, static_cast<int>(std::floor(center.z + radius)));
+    const float r2 = radius * radius;
+    for (int gx = x_begin; gx <= x_end; ++gx) {
+        for (int gz = z_begin; gz <= z_end; ++gz) {
+            const glm::vec3 p0(gx, sample(gx, gz), gz);
+            const glm::vec3 p1(gx + 1, sample(gx + 1, gz), gz);
+            const glm::vec3 p2(gx + 1, sample(gx + 1, gz + 1), gz + 1);
+            const glm::vec3 p3(gx, sample(gx, gz + 1), gz + 1);
+            for (const glm::vec3& q : { closestOnTriangle(center, p0, p1, p2), closestOnTriangle(center, p0, p2, p3) }) {
+                const glm::vec3 d = q - center;
+                if (glm::dot(d, d) < r2) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include "TerrainMesh.hpp"
+
+// výsledek TerrainHeightField::sweepSphere
+struct TerrainHit {
+    float t = 1.0f;         // zlomek pohybu do prvního dotyku
+    glm::vec3 center{ 0.0f };   // střed koule při dotyku
+    glm::vec3 point{ 0.0f };    // bod dotyku na povrchu
+    glm::vec3 normal{ 0.0f, 1.0f, 0.0f };  // od povrchu ke středu koule
+};
+
+// Dotazy na výšku a normálu terénu nad výškovou mapou v paměti (float, řádek = z).
+// Povrch je přesně ten, který kreslí GPU: čtyřúhelník (p0, p1, p2, p3) = ((x, z), (x+1, z), (x+1, z+1), (x, z+1))
+// je rozdělený na trojúhelníky (p0, p1, p2) a (p0, p2, p3) jako v dlaždicích z App::GenHeightMapTiles a výška i normála
+// se počítají na tom z nich, nad kterým bod leží (barycentricky, normála stěny trojúhelníku).
+// Jednotlivé body (hráč) i dávky (NPC, projektily, částice): dávka bere souřadnice jako SoA pole,
+// počítá 4 / 8 bodů najednou (SSE2 / AVX2 gather) a s předstihem přednačítá řádky mapy pro body,
+// které přijdou na řadu - náhodně rozházené body jinak čekají hlavně na cache miss.
+// Mimo mapu ([0, width - 1) x [0, height - 1)) je výška 0 a normála (0, 1, 0).
+class TerrainHeightField {
+public:
+    static constexpr size_t PREFETCH_DISTANCE = 16;    // o kolik bodů dopředu se přednačítá
+
+    TerrainHeightField() = default;
+    // mapa musí platit po celou dobu používání (row_stride v prvcích)
+    TerrainHeightField(const float* heights, int width, int height, size_t row_stride)
+        : heights_(heights), width_(width), height_(height), row_stride_(row_stride) {}
+
+    bool valid() const { return heights_ != nullptr; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    float sample(int x, int z) const { return heights_[static_cast<size_t>(z) * row_stride_ + x]; }
+
+    // výška a normála trojúhelníku pod bodem
+    float height(float x, float z) const { return heightAt([this](int sx, int sz) { return sample(sx, sz); }, width_, height_, x, z); }
+    glm::vec3 normal(float x, float z) const { return normalAt([this](int sx, int sz) { return sample(sx, sz); }, width_, height_, x, z); }
+
+    // dávky: x, z a výstupy mají count prvků
+    void heights(const float* x, const float* z, size_t count, float* out, TerrainSimd simd = TerrainMesh::bestSimd()) const;
+    void normals(const float* x, const float* z, size_t count, float* nx, float* ny, float* nz, TerrainSimd simd = TerrainMesh::bestSimd()) const;
+
+    // Pohyb koule from -> to proti povrchu: první dotyk (i přes hřeben, který by krok s kontrolou jen koncové
+    // pozice přeskočil). Testují se trojúhelníky buněk v pásu pohybu: stěna, hrany a vrcholy (rovnice
+    // pro čas dotyku), buňky mimo dosah odřízne box s výškami rohů. Koule, která už povrchu
+    // dotýká, má t = 0. Mimo mapu žádný povrch není.
+    bool sweepSphere(const glm::vec3& from, const glm::vec3& to, float radius, TerrainHit& hit) const;
+    // koule protíná povrch (nebo leží pod ním)
+    bool overlapSphere(const glm::vec3& center, float radius) const;
+
+    // stejný výpočet nad libovolným zdrojem vzorků (sample(x, z) = výška vzorku), např. namapovaným souborem
+    template <class SampleFn>
+    static float heightAt(SampleFn&& sample, int width, int height, float x, float z) {
+        if (!(x >= 0.0f && x < width - 1 && z >= 0.0f && z < height - 1)) {
+            return 0.0f;
+        }
+        const int gx = static_cast<int>(x), gz = static_cast<int>(z);
+        const float fx = x - gx, fz = z - gz;
+        float h0, dx, dz;
+        trianglePlane(sample, gx, gz, fx >= fz, h0, dx, dz);
+        return h0 + fx * dx + fz * dz;
+    }
+
+    template <class SampleFn>
+    static glm::vec3 normalAt(SampleFn&& sample, int width, int height, float x, float z) {
+        if (!(x >= 0.0f && x < width - 1 && z >= 0.0f && z < height - 1)) {
+            return glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+        const int gx = static_cast<int>(x), gz = static_cast<int>(z);
+        float h0, dx, dz;
+        trianglePlane(sample, gx, gz, x - gx >= z - gz, h0, dx, dz);
+        return glm::normalize(glm::vec3(-dx, 1.0f, -dz));
+    }
+
+    // Rovina trojúhelníku buňky (gx, gz): h = h0 + fx * dx + fz * dz, normála nahoru (-dx, 1, -dz).
+    // upper = (p0, p1, p2) pro fx >= fz, jinak (p0, p2, p3) - na úhlopříčce se oba shodují.
+    template <class SampleFn>
+    static void trianglePlane(SampleFn&& sample, int gx, int gz, bool upper, float& h0, float& dx, float& dz) {
+        h0 = sample(gx, gz);
+        const float h11 = sample(gx + 1, gz + 1);
+        if (upper) {
+            const float h10 = sample(gx + 1, gz);
+            dx = h10 - h0;
+            dz = h11 - h10;
+        } else {
+            const float h01 = sample(gx, gz + 1);
+            dx = h11 - h01;
+            dz = h01 - h0;
+        }
+    }
+
+private:
+    const float* heights_ = nullptr;
+    int width_ = 0, height_ = 0;
+    size_t row_stride_ = 0;
+};
@@ -0,0 +1,141 @@
+#include <limits>
+
+#include "TerrainLod.hpp"
+
+void TerrainLod::init(unsigned int tile_size, unsigned int tiles_x, unsigned int tiles_z) {
+    tile_size_ = tile_size;
+    tiles_x_ = tiles_x;
+    tiles_z_ = tiles_z;
+
+    // nejhrubší úroveň má 2x2 čtyřúhelníky (sešití potřebuje sudý počet na straně)
+    levels_ = 1;
+    while (levels_ < MAX_LEVELS && (tile_size >> levels_) >= 2) {
+        levels_++;
+    }
+
+    patterns_.clear();
+    patterns_.reserve(levels_ * EDGE_MASKS);
+    for (unsigned int level = 0; level < levels_; ++level) {
+        for (uint32_t mask = 0; mask < EDGE_MASKS; ++mask) {
+            patterns_.push_back(buildPattern(tile_size, level, mask));
+        }
+    }
+
+    errors_.assign(levels_, 0.0f);
+    ranges_.assign(levels_, std::numeric_limits<float>::max());
+}
+
+std::vector<GLuint> TerrainLod::buildPattern(unsigned int tile_size, unsigned int level, uint32_t mask) {
+    const unsigned int s = 1u << level;
+    const unsigned int n = tile_size / s;
+    const unsigned int samples = tile_size + 1;
+
+    // Sešití: na straně s hrubším sousedem chybí jeho liché vrcholy, lichý okrajový vrchol se proto
+    // slije s předchozím sudým (k menší souřadnici). Trojúhelníky u něj zdegenerují a vypustí se,
+    // zbylé tvoří vějíř kolem sudého vrcholu - pro toto dělení čtyřúhelníku se žádný neobrátí.
+    auto index = [&](unsigned int x, unsigned int z) -> GLuint {
+        if ((mask & EDGE_X_MIN) && x == 0 && (z / s) % 2 == 1) z -= s;
+        if ((mask & EDGE_X_MAX) && x == tile_size && (z / s) % 2 == 1) z -= s;
+        if ((mask & EDGE_Z_MIN) && z == 0 && (x / s) % 2 == 1) x -= s;
+        if ((mask & EDGE_Z_MAX) && z == tile_size && (x / s) % 2 == 1) x -= s;
+        return x * samples + z;
+    };
+    auto triangle = [](std::vector<GLuint>& out, GLuint a, GLuint b, GLuint c) {
+        if (a != b && b != c && a != c) {
+            out.push_back(a);
+            out.push_back(b);
+            out.push_back(c);
+        }
+    };
+
+    std::vector<GLuint> indices;
+    indices.reserve(static_cast<size_t>(n) * n * 6);
+    for (unsigned int i = 0; i < n; ++i) {
+        for (unsigned int j = 0; j < n; ++j) {
+            GLuint p0 = index(i * s, j * s);
+            GLuint p1 = index((i + 1) * s, j * s);
+            GLuint p2 = index((i + 1) * s, (j + 1) * s);
+            GLuint p3 = index(i * s, (j + 1) * s);
+            triangle(indices, p0, p1, p2);
+            triangle(indices, p0, p2, p3);
+        }
+    }
+    return indices;
+}
+
+void TerrainLod::updateRanges(float screen_error, float viewport_height, float fov_y, float tile_diagonal) {
+    // chyba e ve vzdálenosti d má na obrazovce e * K / d pixelů
+    const float k = viewport_height / (2.0f * std::tan(fov_y * 0.5f));
+    const float min_range = tile_diagonal / (1.0f - MORPH_REGION);
+
+    for (unsigned int level = 0; level + 1 < levels_; ++level) {
+        float range = errors_[level + 1] * k / (std::max)(screen_error, 0.01f);
+        // Každá hranice aspoň dvojnásobek předchozí a nejbližší aspoň úhlopříčka / (1 - MORPH_REGION):
+        // dlaždice úrovně L pak nemá žádný vrchol v morph oblasti úrovně L + 1.
+        float previous = (level == 0) ? min_range * 0.5f : ranges_[level - 1];
+        ranges_[level] = (std::max)(range, 2.0f * previous);
+    }
+    ranges_[levels_ - 1] = std::numeric_limits<float>::max();
+}
+
+glm::vec2 TerrainLod::morphRange(unsigned int level) const {
+    if (level + 1 >= levels_) {
+        return glm::vec2(std::numeric_limits<float>::max());
+    }
+    float end = ranges_[level];
+    float previous = (level == 0) ? 0.0f : ranges_[level - 1];
+    return glm::vec2(end - MORPH_REGION * (end - previous), end);
+}
+
+void TerrainLod::selectLevels(const std::vector<AABB>& tile_bounds, const glm::vec3& camera, std::vector<uint8_t>& levels, std::vector<uint8_t>& masks) const {
+    const unsigned int count = tileCount();
+    levels.resize(count);
+    masks.resize(count);
+
+    // 1. Úroveň podle vodorovné vzdálenosti kamery od boxu dlaždice (výška kamery chybu jen zmenší)
+    for (unsigned int t = 0; t < count; ++t) {
+        const AABB& box = tile_bounds[t];
+        glm::vec2 c(camera.x, camera.z);
+        float distance = glm::length(glm::max(glm::max(glm::vec2(box.min.x, box.min.z) - c, c - glm::vec2(box.max.x, box.max.z)), glm::vec2(0.0f)));
+        unsigned int level = 0;
+        while (level + 1 < levels_ && distance >= ranges_[level]) {
+            level++;
+        }
+        levels[t] = static_cast<uint8_t>(level);
+    }
+
+    // 2. Sousedé se smí lišit nejvýš o jednu úroveň - hrubší dlaždice se zjemní (chyba jen klesne)
+    auto at = [&](unsigned int x, unsigned int z) -> uint8_t& { return levels[x * tiles_z_ + z]; };
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (unsigned int x = 0; x < tiles_x_; ++x) {
+            for (unsigned int z = 0; z < tiles_z_; ++z) {
+                uint8_t limit = at(x, z) + 1;
+                auto relax = [&](uint8_t& neighbour) {
+                    if (neighbour > limit) {
+                        neighbour = limit;
+                        changed = true;
+                    }
+                };
+                if (x > 0) relax(at(x - 1, z));
+                if (x + 1 < tiles_x_) relax(at(x + 1, z));
+                if (z > 0) relax(at(x, z - 1));
+                if (z + 1 < tiles_z_) relax(at(x, z + 1));
+            }
+        }
+    }
+
+    // 3. Maska sešití - strany s hrubším sousedem
+    for (unsigned int x = 0; x < tiles_x_; ++x) {
+        for (unsigned int z = 0; z < tiles_z_; ++z) {
+            uint8_t level = at(x, z);
+            uint8_t mask = 0;
+            if (x > 0 && at(x - 1, z) > level) mask |= EDGE_X_MIN;
+            if (x + 1 < tiles_x_ && at(x + 1, z) > level) mask |= EDGE_X_MAX;
+            if (z > 0 && at(x, z - 1) > level) mask |= EDGE_Z_MIN;
+            if (z + 1 < tiles_z_ && at(x, z + 1) > level) mask |= EDGE_Z_MAX;
+            masks[x * tiles_z_ + z] = mask;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+
+// strany dlaždice - bit masky = soused na této straně má o úroveň hrubší LOD (okraj se sešije)
+enum TerrainEdge : uint32_t {
+    EDGE_X_MIN = 1u << 0,
+    EDGE_X_MAX = 1u << 1,
+    EDGE_Z_MIN = 1u << 2,
+    EDGE_Z_MAX = 1u << 3,
+    EDGE_MASKS = 16,
+};
+
+// Geomipmapping terénu nad dlaždicemi se sdílenou mřížkou vrcholů.
+// Úroveň L kreslí každý 2^L-tý vrchol, tedy jen jiné indexy nad stejným vertex bufferem. Vzory se
+// předpočítají pro každou úroveň a masku sešití (okrajové liché vrcholy se slijí se sousedním sudým),
+// sousední dlaždice se liší nejvýš o jednu úroveň. Úrovně se volí podle vzdálenosti od kamery,
+// hranice (vodorovná vzdálenost) vychází z geometrické chyby úrovně a cílové chyby na obrazovce v pixelech. Mizející vrcholy
+// se ve vertex shaderu plynule posouvají (morph) k hrubší ploše - posun závisí jen na pozici vrcholu
+// a kameře, takže sdílené okraje sousedních dlaždic zůstanou vždy stejné.
+class TerrainLod {
+public:
+    static constexpr unsigned int MAX_LEVELS = 8;       // phong_mdi.vert: MAX_LOD_LEVELS
+    static constexpr float MORPH_REGION = 0.3f;         // morph v poslední části rozsahu úrovně
+
+    // tile_size = čtyřúhelníků na stranu dlaždice (mocnina 2), dlaždice v mřížce tiles_x * tiles_z
+    // (index dlaždice = tile_x * tiles_z + tile_z), vrchol (x, z) dlaždice má index x * (tile_size + 1) + z
+    void init(unsigned int tile_size, unsigned int tiles_x, unsigned int tiles_z);
+
+    static bool supportsTileSize(unsigned int tile_size) { return tile_size >= 2 && (tile_size & (tile_size - 1)) == 0; }
+
+    unsigned int levels() const { return levels_; }
+    unsigned int tileCount() const { return tiles_x_ * tiles_z_; }
+
+    // indexy dlaždice pro úroveň a masku sešití (TerrainEdge)
+    const std::vector<GLuint>& pattern(unsigned int level, uint32_t mask) const { return patterns_[level * EDGE_MASKS + mask]; }
+    static std::vector<GLuint> buildPattern(unsigned int tile_size, unsigned int level, uint32_t mask);
+
+    // maximální odchylka výšky úrovně od plného rozlišení, errors[0] = 0 (viz levelError)
+    void setLevelErrors(const std::vector<float>& errors) { errors_ = errors; }
+
+    // hranice úrovní (vodorovné vzdálenosti) z cílové chyby v pixelech (viewport_height, fov_y v radiánech),
+    // tile_diagonal = vodorovná úhlopříčka dlaždice (morph musí skončit dřív, než dlaždice přepne)
+    void updateRanges(float screen_error, float viewport_height, float fov_y, float tile_diagonal);
+
+    // úroveň a maska sešití každé dlaždice pro pozici kamery (bounds ve stejném pořadí jako dlaždice)
+    void selectLevels(const std::vector<AABB>& tile_bounds, const glm::vec3& camera, std::vector<uint8_t>& levels, std::vector<uint8_t>& masks) const;
+
+    // vzdálenost, kde úroveň končí (za ní stačí level + 1)
+    float range(unsigned int level) const { return ranges_[level]; }
+    // (začátek, konec) morphu vrcholů úrovně k level + 1 (uniformy u_lod_morph)
+    glm::vec2 morphRange(unsigned int level) const;
+
+    // Odchylka úrovně 'level' dlaždice od plného rozlišení: pro každý vzorek rozdíl skutečné výšky
+    // a výšky hrubé mřížky (stejné dělení čtyřúhelníku (p0, p1, p2), (p0, p2, p3) jako GenHeightMapTiles).
+    // height(x, z) = výška vzorku, x0/z0 = první vzorek dlaždice, step = krok vzorků mezi vrcholy.
+    template <class HeightFn>
+    static float levelError(HeightFn&& height, int x0, int z0, int step, unsigned int tile_size, unsigned int level) {
+        const int s = 1 << level;
+        const int n = static_cast<int>(tile_size);
+        float error = 0.0f;
+        for (int cx = 0; cx < n; cx += s) {
+            for (int cz = 0; cz < n; cz += s) {
+                float h0 = height(x0 + cx * step, z0 + cz * step);
+                float h1 = height(x0 + (cx + s) * step, z0 + cz * step);
+                float h2 = height(x0 + (cx + s) * step, z0 + (cz + s) * step);
+                float h3 = height(x0 + cx * step, z0 + (cz + s) * step);
+                for (int i = 0; i <= s; ++i) {
+                    for (int j = 0; j <= s; ++j) {
+                        float u = static_cast<float>(i) / s;
+                        float v = static_cast<float>(j) / s;
+                        float coarse = (u >= v) ? h0 + u * (h1 - h0) + v * (h2 - h1)
+                                                : h0 + u * (h2 - h3) + v * (h3 - h0);
+                        error = (std::max)(error, std::abs(height(x0 + (cx + i) * step, z0 + (cz + j) * step) - coarse));
+                    }
+                }
+            }
+        }
+        return error;
+    }
+
+private:
+    unsigned int tile_size_ = 0;
+    unsigned int tiles_x_ = 0, tiles_z_ = 0;
+    unsigned int levels_ = 1;
+    std::vector<std::vector<GLuint>> patterns_;     // [level * EDGE_MASKS + mask]
+    std::vector<float> errors_;
+    std::vector<float> ranges_;
+};
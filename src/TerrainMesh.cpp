@@ -0,0 +1,227 @@
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+#define TERRAIN_HAS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TERRAIN_HAS_SSE2 1
+#endif
+
+#include "TerrainMesh.hpp"
+
+static_assert(sizeof(vertex) == 8 * sizeof(float), "SIMD jadro zapisuje vrchol jako 8 floatu");
+
+namespace {
+
+// Sloupec vrcholů dlaždice (pevné x, z = z0 + k * step) nad blokem výšek dlaždice transponovaným
+// tak, že z je v paměti souvislé: center[k] = výška (x, z), left/right = sousední x, center[k -/+ 1] = sousední z.
+// Vrcholy jdou na out[k], tedy také souvisle - čtení i zápis v pořadí paměti.
+struct Column {
+    const float* center;
+    const float* left;
+    const float* right;
+    float x;
+    float z0;
+    float step;
+};
+
+void columnScalar(const Column& c, int begin, int end, vertex* out) {
+    for (int k = begin; k < end; ++k) {
+        const float z = c.z0 + k * c.step;
+        out[k].position = glm::vec3(c.x, c.center[k], z);
+        out[k].normal = glm::normalize(glm::vec3(c.left[k] - c.right[k], 2.0f * c.step, c.center[k - 1] - c.center[k + 1]));
+        out[k].texCoords = glm::vec2(c.x, z);
+    }
+}
+
+#ifdef TERRAIN_HAS_SSE2
+void columnSse2(const Column& c, int begin, int end, vertex* out) {
+    const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 step = _mm_set1_ps(c.step);
+    const __m128 ny = _mm_set1_ps(2.0f * c.step), ny2 = _mm_mul_ps(ny, ny);
+    const __m128 half = _mm_set1_ps(0.5f), three_halves = _mm_set1_ps(1.5f);
+    const __m128 x = _mm_set1_ps(c.x);
+    int k = begin;
+    for (; k + 4 <= end; k += 4) {
+        __m128 h = _mm_loadu_ps(c.center + k);
+        __m128 nx = _mm_sub_ps(_mm_loadu_ps(c.left + k), _mm_loadu_ps(c.right + k));
+        __m128 nz = _mm_sub_ps(_mm_loadu_ps(c.center + k - 1), _mm_loadu_ps(c.center + k + 1));
+
+        // 1 / |n| - rsqrt (12 bitů) a jeden krok Newtonovy metody
+        __m128 len2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(nz, nz)), ny2);
+        __m128 inv = _mm_rsqrt_ps(len2);
+        inv = _mm_mul_ps(inv, _mm_sub_ps(three_halves, _mm_mul_ps(_mm_mul_ps(half, len2), _mm_mul_ps(inv, inv))));
+
+        // (px, py, pz, nx) a (ny, nz, u, v) pro 4 vrcholy -> transpozice 4x4
+        __m128 z = _mm_add_ps(_mm_set1_ps(c.z0), _mm_mul_ps(_mm_add_ps(_mm_set1_ps(float(k)), lanes), step));
+        __m128 a0 = x, a1 = h, a2 = z, a3 = _mm_mul_ps(nx, inv);
+        __m128 b0 = _mm_mul_ps(ny, inv), b1 = _mm_mul_ps(nz, inv), b2 = x, b3 = z;
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+        _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+        float* v = reinterpret_cast<float*>(out + k);
+        _mm_storeu_ps(v, a0);       _mm_storeu_ps(v + 4, b0);
+        _mm_storeu_ps(v + 8, a1);   _mm_storeu_ps(v + 12, b1);
+        _mm_storeu_ps(v + 16, a2);  _mm_storeu_ps(v + 20, b2);
+        _mm_storeu_ps(v + 24, a3);  _mm_storeu_ps(v + 28, b3);
+    }
+    columnScalar(c, k, end, out);
+}
+#endif
+
+#ifdef TERRAIN_HAS_AVX2
+void columnAvx2(const Column& c, int begin, int end, vertex* out) {
+    const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 step = _mm256_set1_ps(c.step);
+    const __m256 ny = _mm256_set1_ps(2.0f * c.step), ny2 = _mm256_mul_ps(ny, ny);
+    const __m256 half = _mm256_set1_ps(0.5f), three_halves = _mm256_set1_ps(1.5f);
+    const __m256 x = _mm256_set1_ps(c.x);
+    int k = begin;
+    for (; k + 8 <= end; k += 8) {
+        __m256 h = _mm256_loadu_ps(c.center + k);
+        __m256 nx = _mm256_sub_ps(_mm256_loadu_ps(c.left + k), _mm256_loadu_ps(c.right + k));
+        __m256 nz = _mm256_sub_ps(_mm256_loadu_ps(c.center + k - 1), _mm256_loadu_ps(c.center + k + 1));
+
+        __m256 len2 = _mm256_fmadd_ps(nx, nx, _mm256_fmadd_ps(nz, nz, ny2));
+        __m256 inv = _mm256_rsqrt_ps(len2);
+        inv = _mm256_mul_ps(inv, _mm256_fnmadd_ps(_mm256_mul_ps(half, len2), _mm256_mul_ps(inv, inv), three_halves));
+
+        // 8 řad (px, py, pz, nx, ny, nz, u, v) -> 8 vrcholů (transpozice 8x8)
+        __m256 z = _mm256_fmadd_ps(_mm256_add_ps(_mm256_set1_ps(float(k)), lanes), step, _mm256_set1_ps(c.z0));
+        __m256 r0 = x, r1 = h, r2 = z, r3 = _mm256_mul_ps(nx, inv);
+        __m256 r4 = _mm256_mul_ps(ny, inv), r5 = _mm256_mul_ps(nz, inv), r6 = x, r7 = z;
+
+        __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+        __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+        __m256 t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5);
+        __m256 t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+        __m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44), s1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+        __m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44), s3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+        __m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44), s5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+        __m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44), s7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+
+        float* v = reinterpret_cast<float*>(out + k);
+        _mm256_storeu_ps(v, _mm256_permute2f128_ps(s0, s4, 0x20));
+        _mm256_storeu_ps(v + 8, _mm256_permute2f128_ps(s1, s5, 0x20));
+        _mm256_storeu_ps(v + 16, _mm256_permute2f128_ps(s2, s6, 0x20));
+        _mm256_storeu_ps(v + 24, _mm256_permute2f128_ps(s3, s7, 0x20));
+        _mm256_storeu_ps(v + 32, _mm256_permute2f128_ps(s0, s4, 0x31));
+        _mm256_storeu_ps(v + 40, _mm256_permute2f128_ps(s1, s5, 0x31));
+        _mm256_storeu_ps(v + 48, _mm256_permute2f128_ps(s2, s6, 0x31));
+        _mm256_storeu_ps(v + 56, _mm256_permute2f128_ps(s3, s7, 0x31));
+    }
+#ifdef TERRAIN_HAS_SSE2
+    columnSse2(c, k, end, out);
+#else
+    columnScalar(c, k, end, out);
+#endif
+}
+#endif
+
+void column(const Column& c, int count, vertex* out, TerrainSimd simd) {
+#if defined(TERRAIN_HAS_AVX2)
+    if (simd == TERRAIN_SIMD_AVX2) {
+        columnAvx2(c, 0, count, out);
+        return;
+    }
+#endif
+#if defined(TERRAIN_HAS_SSE2)
+    if (simd == TERRAIN_SIMD_SSE2) {
+        columnSse2(c, 0, count, out);
+        return;
+    }
+#endif
+    columnScalar(c, 0, count, out);
+}
+
+// vrcholy jedné dlaždice z bloku výšek po sloupcích (x), blok má kolem dlaždice okraj jednoho vzorku
+void meshBlock(const float* block, int block_stride, unsigned int samples, int x0, int z0, int s, vertex* out, TerrainSimd simd) {
+    for (unsigned int i = 0; i < samples; ++i) {
+        const float* center = block + (i + 1) * block_stride + 1;
+        const Column c{ center, center - block_stride, center + block_stride, float(x0 + static_cast<int>(i) * s), float(z0), float(s) };
+        column(c, static_cast<int>(samples), out + static_cast<size_t>(i) * samples, simd);
+    }
+}
+
+} // namespace
+
+TerrainSimd TerrainMesh::bestSimd() {
+#if defined(TERRAIN_HAS_AVX2)
+    return TERRAIN_SIMD_AVX2;
+#elif defined(TERRAIN_HAS_SSE2)
+    return TERRAIN_SIMD_SSE2;
+#else
+    return TERRAIN_SIMD_SCALAR;
+#endif
+}
+
+const char* TerrainMesh::simdName(TerrainSimd simd) {
+    switch (simd) {
+    case TERRAIN_SIMD_AVX2: return "AVX2";
+    case TERRAIN_SIMD_SSE2: return "SSE2";
+    default: return "skalar";
+    }
+}
+
+TerrainTileGrid TerrainMesh::layout(int width, int height, unsigned int step, unsigned int tile_size) {
+    TerrainTileGrid grid;
+    const unsigned int extent = tile_size * step;
+    grid.tiles_x = (width > static_cast<int>(step)) ? (width - step + extent - 1) / extent : 0;
+    grid.tiles_z = (height > static_cast<int>(step)) ? (height - step + extent - 1) / extent : 0;
+    grid.samples = tile_size + 1;
+    return grid;
+}
+
+void TerrainMesh::generate(const float* heights, int width, int height, size_t row_stride, unsigned int step, unsigned int tile_size,
+                           vertex* out, ThreadPool* pool, TerrainSimd simd) {
+    const TerrainTileGrid grid = layout(width, height, step, tile_size);
+    const unsigned int samples = grid.samples;
+    const int s = static_cast<int>(step);
+    simd = (std::min)(simd, bestSimd());
+
+    // úloha = jedna dlaždice: výšky dlaždice i s okrajem (ořez na mapu) se nejdřív přepíšou do bloku
+    // po sloupcích (x) - SIMD jádro pak čte i zapisuje souvisle a okraje mapy nepotřebují zvláštní větev
+    const int block_stride = static_cast<int>(samples) + 2;
+    auto tiles = [&](size_t begin, size_t end) {
+        std::vector<float> block(static_cast<size_t>(block_stride) * block_stride);
+        for (size_t tile = begin; tile < end; ++tile) {
+            const int x0 = static_cast<int>((tile / grid.tiles_z) * tile_size) * s;
+            const int z0 = static_cast<int>((tile % grid.tiles_z) * tile_size) * s;
+            for (int bz = 0; bz < block_stride; ++bz) {
+                const float* row = heights + std::clamp(z0 + (bz - 1) * s, 0, height - 1) * row_stride;
+                for (int bx = 0; bx < block_stride; ++bx) {
+                    block[bx * block_stride + bz] = row[std::clamp(x0 + (bx - 1) * s, 0, width - 1)];
+                }
+            }
+
+            meshBlock(block.data(), block_stride, samples, x0, z0, s, out + tile * grid.tileVertices(), simd);
+        }
+    };
+
+    if (pool) {
+        pool->parallelFor(grid.tileCount(), 1, tiles);
+    } else {
+        tiles(0, grid.tileCount());
+    }
+}
+
+void TerrainMesh::generateTile(const float* heights, size_t row_stride, int x0, int z0, unsigned int step, unsigned int tile_size,
+                               vertex* out, TerrainSimd simd) {
+    const unsigned int samples = tile_size + 1;
+    const int s = static_cast<int>(step);
+    const int block_stride = static_cast<int>(samples) + 2;
+    simd = (std::min)(simd, bestSimd());
+
+    // okno už okraj obsahuje, jen se přepíše po sloupcích
+    std::vector<float> block(static_cast<size_t>(block_stride) * block_stride);
+    for (int bz = 0; bz < block_stride; ++bz) {
+        const float* row = heights + static_cast<ptrdiff_t>((bz - 1) * s) * static_cast<ptrdiff_t>(row_stride);
+        for (int bx = 0; bx < block_stride; ++bx) {
+            block[bx * block_stride + bz] = row[(bx - 1) * s];
+        }
+    }
+    meshBlock(block.data(), block_stride, samples, x0, z0, s, out, simd);
+}
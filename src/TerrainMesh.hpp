@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "assets.hpp"
+#include "ThreadPool.hpp"
+
+// rozložení dlaždic terénu nad výškovou mapou (sdílí ho generate, App::GenHeightMapTiles a TerrainLod)
+struct TerrainTileGrid {
+    unsigned int tiles_x = 0, tiles_z = 0;
+    unsigned int samples = 0;       // vrcholů na stranu dlaždice (tile_size + 1)
+
+    size_t tileCount() const { return static_cast<size_t>(tiles_x) * tiles_z; }
+    size_t tileVertices() const { return static_cast<size_t>(samples) * samples; }
+    size_t vertexCount() const { return tileCount() * tileVertices(); }
+};
+
+// instrukční sada jádra výpočtu vrcholů (AVX2 jen při překladu s /arch:AVX2 nebo -mavx2 -mfma)
+enum TerrainSimd {
+    TERRAIN_SIMD_SCALAR,
+    TERRAIN_SIMD_SSE2,      // 4 vzorky najednou
+    TERRAIN_SIMD_AVX2,      // 8 vzorků najednou
+};
+
+// CPU část generování terénu: vrcholy všech dlaždic do jednoho předem alokovaného pole.
+// Dlaždice t = tile_x * tiles_z + tile_z leží od t * tileVertices(), její vrchol (i, j) na indexu
+// i * samples + j. Každá dlaždice je samostatná úloha pro ThreadPool - zapisuje jen do svého
+// úseku, takže výsledek nezávisí na počtu vláken. Sloupce vrcholů počítá SIMD jádro po 4 / 8
+// vzorcích: centrální diference, normalizace přes rsqrt s jedním krokem
+// Newtonovy metody a transpozice do vrcholů (vertex = 8 floatů).
+class TerrainMesh {
+public:
+    // poslední řada dlaždic přesahuje mapu, chybějící vzorky opakují okraj
+    static TerrainTileGrid layout(int width, int height, unsigned int step, unsigned int tile_size);
+
+    // heights = výšková mapa (řádek = z, row_stride v prvcích), out musí mít layout().vertexCount() prvků
+    static void generate(const float* heights, int width, int height, size_t row_stride, unsigned int step, unsigned int tile_size,
+                         vertex* out, ThreadPool* pool = nullptr, TerrainSimd simd = bestSimd());
+
+    // Jedna dlaždice z okna výšek (streamování): heights ukazuje na první vrchol dlaždice (x0, z0) a okno
+    // musí mít okraj jednoho kroku na všech stranách. out = tileVertices() vrcholů ve stejném pořadí jako generate.
+    static void generateTile(const float* heights, size_t row_stride, int x0, int z0, unsigned int step, unsigned int tile_size,
+                             vertex* out, TerrainSimd simd = bestSimd());
+
+    // nejlepší přeložená instrukční sada a zda je daná sada v tomto sestavení
+    static TerrainSimd bestSimd();
+    static bool supportsSimd(TerrainSimd simd) { return simd <= bestSimd(); }
+    static const char* simdName(TerrainSimd simd);
+};
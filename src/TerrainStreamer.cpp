@@ -0,0 +1,411 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "TerrainStreamer.hpp"
+#include "TerrainMesh.hpp"
+#include "TerrainLod.hpp"
+
+void TerrainStreamer::init(const HeightMapFile& source, const Settings& settings, GLuint terrain_layer, RegionFilter filter) {
+    clear();
+    source_ = &source;
+    settings_ = settings;
+    settings_.tile_size = (std::max)(settings_.tile_size, 1u);
+    settings_.workers = (std::max)(settings_.workers, 1u);
+    filter_ = std::move(filter);
+
+    const TerrainTileGrid grid = TerrainMesh::layout(source.width(), source.height(), 1, settings_.tile_size);
+    tiles_x_ = static_cast<int>(grid.tiles_x);
+    tiles_z_ = static_cast<int>(grid.tiles_z);
+    tile_vertices_ = grid.tileVertices();
+
+    // Sloty VRAM: všechny dlaždice, kterých se může okruh dotknout, plus řada navíc jako cache za okrajem
+    const float extent = static_cast<float>(settings_.tile_size);
+    const size_t span = static_cast<size_t>(std::ceil(2.0f * settings_.radius / extent)) + 2;
+    const size_t slots = (std::min)(span * span, grid.tileCount());
+    stats_.capacity = slots;
+    free_slots_.resize(slots);
+    for (size_t i = 0; i < slots; ++i) {
+        free_slots_[i] = static_cast<int>(slots - 1 - i);     // pop_back vydává od slotu 0
+    }
+    const size_t tile_bytes = tileBytes();
+
+    // 1. Vrcholy všech slotů v jednom bufferu (slot = base_vertex), indexy jedné dlaždice sdílené
+    const std::vector<GLuint> indices = TerrainLod::buildPattern(settings_.tile_size, 0, 0);
+    index_count_ = indices.size();
+    tile_triangles_ = indices.size() / 3;
+
+    glCreateVertexArrays(1, &VAO);
+    glCreateBuffers(1, &vertex_pool);
+    glNamedBufferStorage(vertex_pool, slots * tile_bytes, nullptr, 0);
+    glCreateBuffers(1, &EBO);
+    glNamedBufferStorage(EBO, indices.size() * sizeof(GLuint), indices.data(), 0);
+
+    // 2. Formát vrcholů a index vykreslení stejně jako StaticBatch (phong_mdi.vert), jediný DrawData
+    glVertexArrayVertexBuffer(VAO, 0, vertex_pool, 0, sizeof(vertex));
+    glVertexArrayElementBuffer(VAO, EBO);
+
+    glEnableVertexArrayAttrib(VAO, 0);
+    glVertexArrayAttribFormat(VAO, 0, 3, GL_FLOAT, GL_FALSE, offsetof(vertex, position));
+    glVertexArrayAttribBinding(VAO, 0, 0);
+
+    glEnableVertexArrayAttrib(VAO, 1);
+    glVertexArrayAttribFormat(VAO, 1, 3, GL_FLOAT, GL_FALSE, offsetof(vertex, normal));
+    glVertexArrayAttribBinding(VAO, 1, 0);
+
+    glEnableVertexArrayAttrib(VAO, 2);
+    glVertexArrayAttribFormat(VAO, 2, 2, GL_FLOAT, GL_FALSE, offsetof(vertex, texCoords));
+    glVertexArrayAttribBinding(VAO, 2, 0);
+
+    const GLuint draw_id = 0;
+    glCreateBuffers(1, &draw_id_buffer);
+    glNamedBufferStorage(draw_id_buffer, sizeof(GLuint), &draw_id, 0);
+    glVertexArrayVertexBuffer(VAO, 1, draw_id_buffer, 0, sizeof(GLuint));
+    glVertexArrayBindingDivisor(VAO, 1, 1);
+
+    glEnableVertexArrayAttrib(VAO, 3);
+    glVertexArrayAttribIFormat(VAO, 3, 1, GL_UNSIGNED_INT, 0);
+    glVertexArrayAttribBinding(VAO, 3, 1);
+
+    DrawData data{};
+    data.model_matrix = glm::mat4(1.0f);
+    data.diffuse_color = glm::vec4(1.0f);
+    data.texture_layer = terrain_layer;
+    data.flags = DRAW_TERRAIN;
+    glCreateBuffers(1, &draw_data_ssbo);
+    glNamedBufferStorage(draw_data_ssbo, sizeof(DrawData), &data, 0);
+
+    glCreateBuffers(1, &indirect_buffer);
+    glNamedBufferStorage(indirect_buffer, slots * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    // 3. Staging: trvale a koherentně namapovaný, rozdělený na úseky po jedné dlaždici
+    const size_t staging_tiles = (std::max)(settings_.staging_bytes / tile_bytes, size_t(1));
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &staging);
+    glNamedBufferStorage(staging, staging_tiles * tile_bytes, nullptr, flags);
+    staging_ptr_ = static_cast<uint8_t*>(glMapNamedBufferRange(staging, 0, staging_tiles * tile_bytes, flags));
+    staging_fences_.assign(staging_tiles, nullptr);
+    staging_next_ = 0;
+
+    // 4. Pracovní vlákna
+    stop_ = false;
+    for (unsigned int i = 0; i < settings_.workers; ++i) {
+        workers_.emplace_back(&TerrainStreamer::workerLoop, this);
+    }
+}
+
+float TerrainStreamer::distance(uint64_t k) const {
+    // vodorovná vzdálenost kamery od čtverce dlaždice
+    const float extent = static_cast<float>(settings_.tile_size);
+    const glm::vec2 min(keyX(k) * extent, keyZ(k) * extent);
+    const glm::vec2 d = glm::max(glm::max(min - camera_, camera_ - (min + extent)), glm::vec2(0.0f));
+    return glm::length(d);
+}
+
+void TerrainStreamer::update(const glm::vec3& camera) {
+    if (!source_) {
+        return;
+    }
+    frame_++;
+    camera_ = glm::vec2(camera.x, camera.z);
+
+    // 1. Dlaždice v okruhu - známé se jen označí jako použité, chybějící se vyžádají
+    const float extent = static_cast<float>(settings_.tile_size);
+    const int x_begin = (std::max)(static_cast<int>(std::floor((camera_.x - settings_.radius) / extent)), 0);
+    const int x_end = (std::min)(static_cast<int>(std::floor((camera_.x + settings_.radius) / extent)), tiles_x_ - 1);
+    const int z_begin = (std::max)(static_cast<int>(std::floor((camera_.y - settings_.radius) / extent)), 0);
+    const int z_end = (std::min)(static_cast<int>(std::floor((camera_.y + settings_.radius) / extent)), tiles_z_ - 1);
+
+    std::vector<uint64_t> missing;
+    for (int x = x_begin; x <= x_end; ++x) {
+        for (int z = z_begin; z <= z_end; ++z) {
+            const uint64_t k = key(x, z);
+            if (distance(k) >= settings_.radius) {
+                continue;
+            }
+            auto it = chunks_.find(k);
+            if (it == chunks_.end()) {
+                chunks_[k].last_used = frame_;
+                missing.push_back(k);
+            } else {
+                it->second.last_used = frame_;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 2. Hotové dlaždice od vláken - mezitím opuštěné okruh se zahodí
+    for (Result& result : done_) {
+        // (zrušená a znovu vyžádaná dlaždice může přijít dvakrát - platí první výsledek)
+        auto it = chunks_.find(result.key);
+        if (it == chunks_.end() || it->second.state != CHUNK_REQUESTED) {
+            continue;
+        }
+        if (it->second.last_used != frame_) {
+            chunks_.erase(it);
+            continue;
+        }
+        it->second.state = CHUNK_READY;
+        it->second.bounds = result.bounds;
+        it->second.vertices = std::move(result.vertices);
+        it->second.heights = std::move(result.heights);
+        ready_.push_back(result.key);
+    }
+    done_.clear();
+
+    // 3. Fronta znovu podle vzdálenosti - úlohy, které ještě nezačaly a jsou mimo okruh, se zruší
+    std::vector<uint64_t> queue;
+    queue.reserve(queue_.size() + missing.size());
+    for (uint64_t k : queue_) {
+        if (chunks_[k].last_used == frame_) {
+            queue.push_back(k);
+        } else {
+            chunks_.erase(k);
+        }
+    }
+    queue.insert(queue.end(), missing.begin(), missing.end());
+    std::sort(queue.begin(), queue.end(), [&](uint64_t a, uint64_t b) { return distance(a) < distance(b); });
+    queue_.assign(queue.begin(), queue.end());
+    if (!missing.empty()) {
+        wake_.notify_all();
+    }
+
+    stats_.queued = queue_.size();
+    stats_.loading = loading_;
+}
+
+int TerrainStreamer::acquireSlot() {
+    if (!free_slots_.empty()) {
+        int slot = free_slots_.back();
+        free_slots_.pop_back();
+        return slot;
+    }
+
+    // LRU: nejdéle nepoužitá rezidentní dlaždice mimo okruh (v okruhu se nic nevyhazuje)
+    auto victim = chunks_.end();
+    for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+        const Chunk& chunk = it->second;
+        if (chunk.state == CHUNK_RESIDENT && chunk.last_used != frame_ &&
+            (victim == chunks_.end() || chunk.last_used < victim->second.last_used)) {
+            victim = it;
+        }
+    }
+    if (victim == chunks_.end()) {
+        return -1;
+    }
+    int slot = victim->second.slot;
+    chunks_.erase(victim);
+    stats_.evicted++;
+    return slot;
+}
+
+void TerrainStreamer::upload() {
+    stats_.uploaded_tiles = 0;
+    stats_.uploaded_bytes = 0;
+    stats_.upload_ms = 0.0;
+    if (!source_) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed_ms = [&]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+
+    // zahození dlaždic, které mezitím opustily okruh, a nejbližší napřed
+    ready_.erase(std::remove_if(ready_.begin(), ready_.end(), [&](uint64_t k) {
+        if (chunks_[k].last_used != frame_) {
+            chunks_.erase(k);
+            return true;
+        }
+        return false;
+    }), ready_.end());
+    std::sort(ready_.begin(), ready_.end(), [&](uint64_t a, uint64_t b) { return distance(a) > distance(b); });
+
+    const size_t tile_bytes = tileBytes();
+    while (!ready_.empty() && (stats_.uploaded_tiles == 0 || elapsed_ms() < settings_.upload_budget_ms)) {
+        // úsek stagingu je volný, až GPU dokončí jeho předchozí kopii - jinak se pokračuje příští snímek
+        GLsync& fence = staging_fences_[staging_next_];
+        if (fence) {
+            GLenum status = glClientWaitSync(fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED) {
+                break;
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        const int slot = acquireSlot();
+        if (slot < 0) {
+            break;
+        }
+
+        const uint64_t k = ready_.back();
+        ready_.pop_back();
+        Chunk& chunk = chunks_[k];
+        const size_t staging_offset = staging_next_ * tile_bytes;
+        std::memcpy(staging_ptr_ + staging_offset, chunk.vertices.data(), tile_bytes);
+        glCopyNamedBufferSubData(staging, vertex_pool, staging_offset, static_cast<size_t>(slot) * tile_bytes, tile_bytes);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        staging_next_ = (staging_next_ + 1) % staging_fences_.size();
+
+        chunk.state = CHUNK_RESIDENT;
+        chunk.slot = slot;
+        chunk.vertices = std::vector<vertex>();
+        stats_.uploaded_tiles++;
+        stats_.uploaded_bytes += tile_bytes;
+    }
+
+    stats_.upload_ms = elapsed_ms();
+    stats_.ready = ready_.size();
+    stats_.resident = stats_.capacity - free_slots_.size();
+}
+
+void TerrainStreamer::draw(const Frustum& frustum) {
+    commands_.clear();
+    for (const auto& [k, chunk] : chunks_) {
+        if (chunk.state == CHUNK_RESIDENT && frustum.intersects(chunk.bounds)) {
+            commands_.push_back({ static_cast<GLuint>(index_count_), 1, 0, static_cast<GLint>(chunk.slot * tile_vertices_), 0 });
+        }
+    }
+    stats_.visible = commands_.size();
+    if (commands_.empty() || VAO == 0) {
+        return;
+    }
+
+    glNamedBufferSubData(indirect_buffer, 0, commands_.size() * sizeof(DrawElementsIndirectCommand), commands_.data());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, draw_data_ssbo);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirect_buffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commands_.size()), 0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+bool TerrainStreamer::idle() const {
+    for (const auto& [k, chunk] : chunks_) {
+        if (chunk.last_used == frame_ && chunk.state != CHUNK_RESIDENT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t TerrainStreamer::gpuBytes() const {
+    return stats_.capacity * (tileBytes() + sizeof(DrawElementsIndirectCommand)) + index_count_ * sizeof(GLuint) +
+           staging_fences_.size() * tileBytes() + sizeof(DrawData);
+}
+
+void TerrainStreamer::workerLoop() {
+    std::vector<float> window;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+        if (stop_) {
+            return;
+        }
+        const uint64_t k = queue_.front();
+        queue_.pop_front();
+        loading_++;
+
+        lock.unlock();
+        Result result = buildTile(k, window);
+        lock.lock();
+
+        loading_--;
+        done_.push_back(std::move(result));
+    }
+}
+
+TerrainStreamer::Result TerrainStreamer::buildTile(uint64_t k, std::vector<float>& window) const {
+    // Výšky dlaždice s okrajem jednoho vzorku (normály na hranici dlaždice vidí souseda), mimo mapu opakuje okraj
+    const int tile = static_cast<int>(settings_.tile_size);
+    const int x0 = keyX(k) * tile;
+    const int z0 = keyZ(k) * tile;
+    const int size = tile + 3;
+    window.resize(static_cast<size_t>(size) * size);
+    source_->readRegion(x0 - 1, z0 - 1, size, size, window.data(), size);
+    if (filter_) {
+        filter_(x0 - 1, z0 - 1, size, size, window.data(), size);
+    }
+
+    Result result;
+    result.key = k;
+    result.vertices.resize(tile_vertices_);
+    TerrainMesh::generateTile(window.data() + size + 1, size, x0, z0, 1, settings_.tile_size, result.vertices.data());
+
+    float h_min = std::numeric_limits<float>::max(), h_max = -std::numeric_limits<float>::max();
+    for (const vertex& v : result.vertices) {
+        h_min = (std::min)(h_min, v.position.y);
+        h_max = (std::max)(h_max, v.position.y);
+    }
+    result.bounds = AABB{ glm::vec3(x0, h_min, z0), glm::vec3(x0 + tile, h_max, z0 + tile) };
+
+    // výšky dlaždice bez okraje pro dotazy hlavního vlákna (sampleHeight)
+    result.heights.resize(static_cast<size_t>(tile + 1) * (tile + 1));
+    for (int z = 0; z <= tile; ++z) {
+        std::memcpy(result.heights.data() + static_cast<size_t>(z) * (tile + 1), window.data() + static_cast<size_t>(z + 1) * size + 1, (tile + 1) * sizeof(float));
+    }
+    return result;
+}
+
+bool TerrainStreamer::sampleHeight(int x, int z, float& height) const {
+    if (!source_) {
+        return false;
+    }
+    x = std::clamp(x, 0, source_->width() - 1);
+    z = std::clamp(z, 0, source_->height() - 1);
+    const int tile = static_cast<int>(settings_.tile_size);
+    auto it = chunks_.find(key(x / tile, z / tile));
+    if (it == chunks_.end() || it->second.heights.empty()) {
+        return false;
+    }
+    height = it->second.heights[static_cast<size_t>(z % tile) * (tile + 1) + (x % tile)];
+    return true;
+}
+
+void TerrainStreamer::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        queue_.clear();
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    done_.clear();
+    loading_ = 0;
+}
+
+void TerrainStreamer::clear() {
+    stopWorkers();
+
+    for (GLsync& fence : staging_fences_) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    staging_fences_.clear();
+    if (staging_ptr_) {
+        glUnmapNamedBuffer(staging);
+        staging_ptr_ = nullptr;
+    }
+    glDeleteBuffers(1, &vertex_pool);
+    glDeleteBuffers(1, &EBO);
+    glDeleteBuffers(1, &draw_id_buffer);
+    glDeleteBuffers(1, &draw_data_ssbo);
+    glDeleteBuffers(1, &indirect_buffer);
+    glDeleteBuffers(1, &staging);
+    glDeleteVertexArrays(1, &VAO);
+    VAO = vertex_pool = EBO = draw_id_buffer = draw_data_ssbo = indirect_buffer = staging = 0;
+
+    source_ = nullptr;
+    chunks_.clear();
+    ready_.clear();
+    free_slots_.clear();
+    commands_.clear();
+    stats_ = Stats();
+    frame_ = 0;
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+#include "StaticBatch.hpp"
+#include "HeightMapFile.hpp"
+
+// Streamování terénu z dlaždicové výškové mapy (HeightMapFile) kolem kamery.
+// update() vybere dlaždice v okruhu a pošle chybějící (nejbližší první) pracovním vláknům, ta přečtou
+// výšky z namapovaného souboru a spočítají vrcholy (TerrainMesh::generateTile). upload() na GL vlákně
+// kopíruje hotové dlaždice přes trvale namapovaný staging buffer do pevných slotů ve VRAM, jen do
+// časového rozpočtu snímku a bez čekání na GPU (obsazený úsek stagingu hlídá fence). Když sloty dojdou,
+// uvolní se nejdéle nepoužitá dlaždice mimo okruh (LRU). Hlavní smyčka tak nikdy nečeká na disk.
+// draw() kreslí rezidentní dlaždice jedním glMultiDrawElementsIndirect se stejným formátem vrcholů
+// a DrawData jako StaticBatch (shader phong_mdi).
+class TerrainStreamer {
+public:
+    struct Settings {
+        unsigned int tile_size = 64;        // čtyřúhelníků na stranu dlaždice
+        float radius = 512.0f;              // vodorovná vzdálenost, do které se dlaždice načítají
+        unsigned int workers = 2;           // pracovní vlákna (čtení + generování vrcholů)
+        float upload_budget_ms = 2.0f;      // čas nahrávání na snímek (aspoň jedna dlaždice)
+        size_t staging_bytes = 8u << 20;    // trvale namapovaný staging buffer
+    };
+
+    struct Stats {
+        size_t queued = 0;          // čekají na vlákno
+        size_t loading = 0;         // právě se čtou / generují
+        size_t ready = 0;           // hotové v RAM, čekají na upload
+        size_t resident = 0;        // ve VRAM
+        size_t capacity = 0;        // slotů ve VRAM
+        size_t visible = 0;         // vykreslené v posledním snímku
+        size_t uploaded_tiles = 0;  // tento snímek
+        size_t uploaded_bytes = 0;  // tento snímek
+        double upload_ms = 0.0;     // tento snímek
+        size_t evicted = 0;         // celkem
+
+        size_t pending() const { return queued + loading + ready; }
+    };
+
+    // úprava přečtených výšek na pracovním vlákně (např. zplacatění oblasti), okno x0, z0, w x h
+    using RegionFilter = std::function<void(int x0, int z0, int w, int h, float* heights, size_t row_stride)>;
+
+    TerrainStreamer() = default;
+    ~TerrainStreamer() { stopWorkers(); }     // GL objekty uvolní clear() (s platným kontextem)
+    TerrainStreamer(const TerrainStreamer&) = delete;
+    TerrainStreamer& operator=(const TerrainStreamer&) = delete;
+
+    // source musí zůstat otevřený až do clear(), terrain_layer = první vrstva terénu v poli materiálů
+    void init(const HeightMapFile& source, const Settings& settings, GLuint terrain_layer, RegionFilter filter = {});
+
+    // výběr dlaždic kolem kamery a fronta úloh (nečeká na vlákna)
+    void update(const glm::vec3& camera);
+    // hotové dlaždice do VRAM v rámci rozpočtu (GL vlákno)
+    void upload();
+    // frustum culling a vykreslení rezidentních dlaždic (shader aktivní, textury navázané volajícím)
+    void draw(const Frustum& frustum);
+
+    // všechny dlaždice v okruhu jsou ve VRAM
+    bool idle() const;
+
+    // výška vzorku (po filtru) z dlaždice, kterou už přečetlo vlákno - bez přístupu do souboru,
+    // false = dlaždice ještě není načtená (mimo mapu opakuje okraj, jen hlavní vlákno)
+    bool sampleHeight(int x, int z, float& height) const;
+
+    // stav front z posledního update(), upload z posledního upload()
+    const Stats& stats() const { return stats_; }
+    size_t tileBytes() const { return tile_vertices_ * sizeof(vertex); }
+    size_t gpuBytes() const;
+    size_t triangleCount() const { return stats_.visible * tile_triangles_; }
+
+    void clear();
+
+private:
+    enum ChunkState : uint8_t {
+        CHUNK_REQUESTED,    // ve frontě nebo u vlákna
+        CHUNK_READY,        // vrcholy v RAM
+        CHUNK_RESIDENT,     // ve slotu VRAM
+    };
+    struct Chunk {
+        ChunkState state = CHUNK_REQUESTED;
+        uint64_t last_used = 0;     // poslední snímek v okruhu (LRU)
+        int slot = -1;
+        AABB bounds;
+        std::vector<vertex> vertices;
+        std::vector<float> heights;     // (tile_size + 1)^2 vzorků dlaždice, zůstávají i ve VRAM stavu
+    };
+    struct Result {
+        uint64_t key;
+        AABB bounds;
+        std::vector<vertex> vertices;
+        std::vector<float> heights;
+    };
+
+    static uint64_t key(int tile_x, int tile_z) { return (static_cast<uint64_t>(tile_x) << 32) | static_cast<uint32_t>(tile_z); }
+    static int keyX(uint64_t k) { return static_cast<int>(k >> 32); }
+    static int keyZ(uint64_t k) { return static_cast<int>(k & 0xFFFFFFFFu); }
+    float distance(uint64_t k) const;
+
+    void workerLoop();
+    void stopWorkers();
+    Result buildTile(uint64_t k, std::vector<float>& window) const;
+    int acquireSlot();
+
+    const HeightMapFile* source_ = nullptr;
+    Settings settings_;
+    RegionFilter filter_;
+    int tiles_x_ = 0, tiles_z_ = 0;
+    size_t tile_vertices_ = 0;
+    size_t tile_triangles_ = 0;
+    glm::vec2 camera_{ 0.0f };
+    uint64_t frame_ = 0;
+
+    // stav dlaždic - jen hlavní vlákno
+    std::unordered_map<uint64_t, Chunk> chunks_;
+    std::vector<uint64_t> ready_;
+    std::vector<int> free_slots_;
+    Stats stats_;
+
+    // sdíleno s vlákny (mutex_)
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<uint64_t> queue_;        // seřazeno od nejbližší
+    std::vector<Result> done_;
+    size_t loading_ = 0;
+    bool stop_ = false;
+
+    // GPU: sloty vrcholů, sdílené indexy dlaždice, staging ring s fence na úsek
+    GLuint VAO{ 0 }, vertex_pool{ 0 }, EBO{ 0 };
+    GLuint draw_id_buffer{ 0 }, draw_data_ssbo{ 0 }, indirect_buffer{ 0 };
+    GLuint staging{ 0 };
+    uint8_t* staging_ptr_ = nullptr;
+    std::vector<GLsync> staging_fences_;
+    size_t staging_next_ = 0;
+    size_t index_count_ = 0;
+    std::vector<DrawElementsIndirectCommand> commands_;
+};
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <string>
+#include <limits>
+
+#include "TerrainTessellation.hpp"
+
+GLuint TerrainTessellation::createHeightTexture(const float* heights, int width, int height, size_t row_stride) {
+    GLuint texture;
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    glTextureStorage2D(texture, 1, GL_R32F, width, height);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(row_stride));
+    glTextureSubImage2D(texture, 0, 0, 0, width, height, GL_RED, GL_FLOAT, heights);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return texture;
+}
+
+void TerrainTessellation::init(const float* heights, int width, int height, size_t row_stride, int patch_size) {
+    clear();
+    patch_size = (std::max)(patch_size, 1);
+
+    // 1. Výšky jako textura (R32F, výška ve světových jednotkách)
+    height_texture = createHeightTexture(heights, width, height, row_stride);
+
+    // 2. Patche - rohy a rozsah výšek (pro culling v teselačním shaderu)
+    struct PatchCorner {
+        glm::vec2 corner;
+        glm::vec2 height_range;
+    };
+    std::vector<PatchCorner> corners;
+    for (int x0 = 0; x0 < width - 1; x0 += patch_size) {
+        for (int z0 = 0; z0 < height - 1; z0 += patch_size) {
+            int x1 = (std::min)(x0 + patch_size, width - 1);
+            int z1 = (std::min)(z0 + patch_size, height - 1);
+
+            float h_min = std::numeric_limits<float>::max(), h_max = -std::numeric_limits<float>::max();
+            for (int z = z0; z <= z1; ++z) {
+                const float* row = heights + z * row_stride;
+                auto [lo, hi] = std::minmax_element(row + x0, row + x1 + 1);
+                h_min = (std::min)(h_min, *lo);
+                h_max = (std::max)(h_max, *hi);
+            }
+
+            AABB box{ glm::vec3(x0, h_min, z0), glm::vec3(x1, h_max, z1) };
+            patches_.push_back(box);
+            glm::vec2 range(h_min, h_max);
+            corners.push_back({ glm::vec2(x0, z0), range });
+            corners.push_back({ glm::vec2(x1, z0), range });
+            corners.push_back({ glm::vec2(x1, z1), range });
+            corners.push_back({ glm::vec2(x0, z1), range });
+        }
+    }
+
+    glCreateVertexArrays(1, &VAO);
+    glCreateBuffers(1, &VBO);
+    glNamedBufferStorage(VBO, corners.size() * sizeof(PatchCorner), corners.data(), 0);
+    glVertexArrayVertexBuffer(VAO, 0, VBO, 0, sizeof(PatchCorner));
+
+    glEnableVertexArrayAttrib(VAO, 0);
+    glVertexArrayAttribFormat(VAO, 0, 2, GL_FLOAT, GL_FALSE, offsetof(PatchCorner, corner));
+    glVertexArrayAttribBinding(VAO, 0, 0);
+
+    glEnableVertexArrayAttrib(VAO, 1);
+    glVertexArrayAttribFormat(VAO, 1, 2, GL_FLOAT, GL_FALSE, offsetof(PatchCorner, height_range));
+    glVertexArrayAttribBinding(VAO, 1, 0);
+
+    glCreateQueries(GL_PRIMITIVES_GENERATED, 2, queries_);
+    glGetIntegerv(GL_MAX_TESS_GEN_LEVEL, &max_level_);
+    gpu_bytes_ = static_cast<size_t>(width) * height * sizeof(float) + corners.size() * sizeof(PatchCorner);
+}
+
+void TerrainTessellation::draw(ShaderProgram& shader, const Frustum& frustum, const glm::vec2& viewport, float edge_pixels, GLuint terrain_layer) {
+    if (VAO == 0) {
+        return;
+    }
+
+    shader.activate();
+    for (int i = 0; i < 6; ++i) {
+        shader.setUniform("u_planes[" + std::to_string(i) + "]", frustum.planes[i]);
+    }
+    shader.setUniform("u_viewport", viewport);
+    shader.setUniform("u_edge_pixels", (std::max)(edge_pixels, 0.5f));
+    shader.setUniform("u_max_level", static_cast<float>(max_level_));
+    shader.setUniform("u_heightmap", 1);
+    shader.setUniform("u_terrain_layer", terrain_layer);
+    glBindTextureUnit(1, height_texture);
+
+    // počet trojúhelníků - čte se výsledek předchozího snímku, jen pokud je hotový
+    GLuint previous = queries_[(frame_ + 1) % 2];
+    GLint available = 0;
+    if (frame_ > 0) {
+        glGetQueryObjectiv(previous, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 count = 0;
+            glGetQueryObjectui64v(previous, GL_QUERY_RESULT, &count);
+            primitives_ = count;
+        }
+    }
+
+    glBeginQuery(GL_PRIMITIVES_GENERATED, queries_[frame_ % 2]);
+    glPatchParameteri(GL_PATCH_VERTICES, 4);
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_PATCHES, 0, static_cast<GLsizei>(patches_.size() * 4));
+    glBindVertexArray(0);
+    glEndQuery(GL_PRIMITIVES_GENERATED);
+    frame_++;
+}
+
+size_t TerrainTessellation::visiblePatches(const Frustum& frustum) const {
+    return std::count_if(patches_.begin(), patches_.end(), [&](const AABB& box) { return frustum.intersects(box); });
+}
+
+void TerrainTessellation::clear() {
+    glDeleteBuffers(1, &VBO);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteTextures(1, &height_texture);
+    if (queries_[0] != 0) {
+        glDeleteQueries(2, queries_);
+    }
+    VAO = VBO = height_texture = 0;
+    queries_[0] = queries_[1] = 0;
+
+    patches_.clear();
+    frame_ = 0;
+    primitives_ = 0;
+    gpu_bytes_ = 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+#include "ShaderProgram.hpp"
+
+// Terén přímo z textury výškové mapy: hrubá mřížka patchů (4 rohy), dělení a posun vrcholů
+// dělají teselační shadery podle délky hran na obrazovce. Na GPU je jen textura a rohy patchů,
+// start nepotřebuje žádné vrcholy terénu. Kolize dál čtou CPU kopii výškové mapy.
+class TerrainTessellation {
+public:
+    // výšková mapa (width x height vzorků, řádek = z, row_stride v prvcích), patch_size = vzorků na stranu patche
+    void init(const float* heights, int width, int height, size_t row_stride, int patch_size);
+
+    // vykreslení shaderem terrain_tess.* (matice a světla nastaví volající, materiály na jednotce 0),
+    // edge_pixels = cílová délka hrany trojúhelníku na obrazovce
+    void draw(ShaderProgram& shader, const Frustum& frustum, const glm::vec2& viewport, float edge_pixels, GLuint terrain_layer);
+
+    size_t patchCount() const { return patches_.size(); }
+    // patche ve frustu (stejný test jako terrain_tess.tesc)
+    size_t visiblePatches(const Frustum& frustum) const;
+    // trojúhelníky z teselace (GL_PRIMITIVES_GENERATED o snímek zpět, neblokuje)
+    uint64_t primitiveCount() const { return primitives_; }
+    // obsazená VRAM (textura + rohy patchů)
+    size_t gpuBytes() const { return gpu_bytes_; }
+
+    void clear();
+
+    // R32F textura výšek s lineárním filtrem a clamp na okraj (sdílí i TerrainVertexPulling)
+    static GLuint createHeightTexture(const float* heights, int width, int height, size_t row_stride);
+
+private:
+    std::vector<AABB> patches_;
+
+    GLuint VAO{ 0 }, VBO{ 0 };
+    GLuint height_texture{ 0 };
+    GLuint queries_[2]{ 0, 0 };
+    uint32_t frame_ = 0;
+    uint64_t primitives_ = 0;
+    GLint max_level_ = 64;
+    size_t gpu_bytes_ = 0;
+};
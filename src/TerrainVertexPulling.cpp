@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <limits>
+
+#include "TerrainVertexPulling.hpp"
+#include "TerrainLod.hpp"
+#include "TerrainTessellation.hpp"
+
+void TerrainVertexPulling::init(const float* heights, int width, int height, size_t row_stride, int tile_size) {
+    clear();
+    tile_size_ = (std::max)(tile_size, 1);
+
+    height_texture = TerrainTessellation::createHeightTexture(heights, width, height, row_stride);
+
+    // Dlaždice jako TerrainMesh::generate - poslední řada přesahuje mapu, výšky za okrajem opakují okraj
+    for (int x0 = 0; x0 < width - 1; x0 += tile_size_) {
+        for (int z0 = 0; z0 < height - 1; z0 += tile_size_) {
+            int x1 = (std::min)(x0 + tile_size_, width - 1);
+            int z1 = (std::min)(z0 + tile_size_, height - 1);
+
+            float h_min = std::numeric_limits<float>::max(), h_max = -std::numeric_limits<float>::max();
+            for (int z = z0; z <= z1; ++z) {
+                const float* row = heights + z * row_stride;
+                auto [lo, hi] = std::minmax_element(row + x0, row + x1 + 1);
+                h_min = (std::min)(h_min, *lo);
+                h_max = (std::max)(h_max, *hi);
+            }
+            tiles_.push_back(AABB{ glm::vec3(x0, h_min, z0), glm::vec3(x0 + tile_size_, h_max, z0 + tile_size_) });
+            origins_.push_back(glm::ivec2(x0, z0));
+        }
+    }
+
+    // Indexy jedné dlaždice (stejné jako plné rozlišení LOD) - hodnota indexu je gl_VertexID
+    const std::vector<GLuint> indices = TerrainLod::buildPattern(tile_size_, 0, 0);
+    index_count_ = indices.size();
+    tile_triangles_ = indices.size() / 3;
+
+    glCreateVertexArrays(1, &VAO);
+    glCreateBuffers(1, &EBO);
+    glNamedBufferStorage(EBO, indices.size() * sizeof(GLuint), indices.data(), 0);
+    glVertexArrayElementBuffer(VAO, EBO);
+
+    glCreateBuffers(1, &tile_ssbo);
+    glNamedBufferStorage(tile_ssbo, origins_.size() * sizeof(glm::ivec2), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    gpu_bytes_ = static_cast<size_t>(width) * height * sizeof(float) + indices.size() * sizeof(GLuint) + origins_.size() * sizeof(glm::ivec2);
+}
+
+void TerrainVertexPulling::draw(ShaderProgram& shader, const Frustum& frustum, GLuint terrain_layer) {
+    visible_.clear();
+    for (size_t i = 0; i < tiles_.size(); ++i) {
+        if (frustum.intersects(tiles_[i])) {
+            visible_.push_back(origins_[i]);
+        }
+    }
+    if (visible_.empty() || VAO == 0) {
+        return;
+    }
+    glNamedBufferSubData(tile_ssbo, 0, visible_.size() * sizeof(glm::ivec2), visible_.data());
+
+    shader.activate();
+    shader.setUniform("u_heightmap", 1);
+    shader.setUniform("u_tile_size", tile_size_);
+    shader.setUniform("u_terrain_layer", terrain_layer);
+    glBindTextureUnit(1, height_texture);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, tile_ssbo);
+
+    glBindVertexArray(VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(index_count_), GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(visible_.size()));
+    glBindVertexArray(0);
+}
+
+void TerrainVertexPulling::clear() {
+    glDeleteBuffers(1, &EBO);
+    glDeleteBuffers(1, &tile_ssbo);
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteTextures(1, &height_texture);
+    VAO = EBO = tile_ssbo = height_texture = 0;
+
+    tiles_.clear();
+    origins_.clear();
+    visible_.clear();
+    tile_triangles_ = index_count_ = 0;
+    gpu_bytes_ = 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "Frustum.hpp"
+#include "ShaderProgram.hpp"
+
+// Terén bez vertex bufferu: vertex shader (terrain_pull.vert) skládá pozici z gl_VertexID
+// (index ve sdílené mřížce dlaždice) a gl_InstanceID (viditelná dlaždice), výšku a normálu čte
+// z R32F textury. Na vzorek mapy připadají 4 bajty místo 32 B vrcholu, geometrie je stejná jako
+// u dlaždic z App::GenHeightMapTiles (včetně dělení čtyřúhelníků a přesahu poslední řady).
+class TerrainVertexPulling {
+public:
+    // výšková mapa (width x height vzorků, řádek = z, row_stride v prvcích), tile_size = čtyřúhelníků na stranu dlaždice
+    void init(const float* heights, int width, int height, size_t row_stride, int tile_size);
+
+    // frustum culling dlaždic na CPU a vykreslení viditelných jedním instancovaným voláním
+    // (matice a světla nastaví volající, materiály na jednotce 0)
+    void draw(ShaderProgram& shader, const Frustum& frustum, GLuint terrain_layer);
+
+    size_t tileCount() const { return tiles_.size(); }
+    size_t visibleTiles() const { return visible_.size(); }
+    size_t triangleCount() const { return visible_.size() * tile_triangles_; }
+    // obsazená VRAM (textura, indexy jedné dlaždice, seznam dlaždic)
+    size_t gpuBytes() const { return gpu_bytes_; }
+
+    void clear();
+
+private:
+    std::vector<AABB> tiles_;
+    std::vector<glm::ivec2> origins_;
+    std::vector<glm::ivec2> visible_;   // počátky viditelných dlaždic (SSBO, index = gl_InstanceID)
+    int tile_size_ = 0;
+    size_t tile_triangles_ = 0;
+    size_t index_count_ = 0;
+
+    GLuint VAO{ 0 };                    // prázdný - core profil ho pro kreslení vyžaduje
+    GLuint EBO{ 0 };
+    GLuint tile_ssbo{ 0 };
+    GLuint height_texture{ 0 };
+    size_t gpu_bytes_ = 0;
+};
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "TextureUploader.hpp"
+
+size_t TextureUploader::MipChain::bytes() const {
+    size_t sum = 0;
+    for (const auto& level : levels) {
+        sum += level.size();
+    }
+    return sum;
+}
+
+GLsizei TextureUploader::levelCount(int width, int height) {
+    return 1 + static_cast<GLsizei>(std::floor(std::log2((std::max)({ width, height, 1 }))));
+}
+
+size_t TextureUploader::blockBytes(GLenum format) {
+    switch (format) {
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        return 8;
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+TextureUploader::MipChain TextureUploader::buildMipChain(const uint8_t* bgra, int width, int height, size_t row_bytes) {
+    MipChain chain;
+    chain.width = width;
+    chain.height = height;
+    const GLsizei count = levelCount(width, height);
+    chain.levels.resize(count);
+
+    // úroveň 0 s těsnými řádky
+    const size_t tight = static_cast<size_t>(width) * 4;
+    chain.levels[0].resize(tight * height);
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(chain.levels[0].data() + y * tight, bgra + y * row_bytes, tight);
+    }
+
+    // další úrovně průměrem 2x2 z předchozí (lichý rozměr: poslední sloupec/řádek se zopakuje)
+    int w = width, h = height;
+    for (GLsizei level = 1; level < count; ++level) {
+        const int nw = (std::max)(w / 2, 1), nh = (std::max)(h / 2, 1);
+        const uint8_t* src = chain.levels[level - 1].data();
+        std::vector<uint8_t>& dst = chain.levels[level];
+        dst.resize(static_cast<size_t>(nw) * nh * 4);
+        for (int y = 0; y < nh; ++y) {
+            const uint8_t* row0 = src + static_cast<size_t>((std::min)(2 * y, h - 1)) * w * 4;
+            const uint8_t* row1 = src + static_cast<size_t>((std::min)(2 * y + 1, h - 1)) * w * 4;
+            uint8_t* out = dst.data() + static_cast<size_t>(y) * nw * 4;
+            for (int x = 0; x < nw; ++x) {
+                const int x0 = (std::min)(2 * x, w - 1) * 4, x1 = (std::min)(2 * x + 1, w - 1) * 4;
+                for (int c = 0; c < 4; ++c) {
+                    out[x * 4 + c] = static_cast<uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+                }
+            }
+        }
+        w = nw;
+        h = nh;
+    }
+    return chain;
+}
+
+void TextureUploader::init(const Settings& settings) {
+    clear();
+    settings_ = settings;
+    settings_.slots = (std::max)(settings_.slots, 1u);
+
+    // staging trvale a koherentně namapovaný, rozdělený na settings_.slots úseků s vlastním fence
+    const size_t total = settings_.slots * settings_.slot_bytes;
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &staging);
+    glNamedBufferStorage(staging, total, nullptr, flags);
+    staging_ptr_ = static_cast<uint8_t*>(glMapNamedBufferRange(staging, 0, total, flags));
+    staging_fences_.assign(settings_.slots, nullptr);
+    staging_next_ = 0;
+}
+
+void TextureUploader::enqueue(GLuint texture, GLint layer, MipChain chain) {
+    const size_t block = blockBytes(chain.format);
+    const size_t row_bytes = block ? (chain.width + 3) / 4 * block : static_cast<size_t>(chain.width) * 4;
+    if (row_bytes > settings_.slot_bytes) {
+        throw std::runtime_error("Radek textury je delsi nez usek stagingu: " + std::to_string(chain.width) + " px");
+    }
+    Request request;
+    request.texture = texture;
+    request.layer = layer;
+    request.chain = std::move(chain);
+    queue_.push_back(std::move(request));
+}
+
+size_t TextureUploader::fillSlot(size_t offset) {
+    size_t used = 0;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging);
+    while (!queue_.empty()) {
+        Request& request = queue_.front();
+        const int w = (std::max)(request.chain.width >> request.level, 1);
+        const int h = (std::max)(request.chain.height >> request.level, 1);
+        // řádek = řádek texelů, u komprimovaných řádek bloků 4x4
+        const size_t block = blockBytes(request.chain.format);
+        const int texel_rows = block ? 4 : 1;
+        const int level_rows = block ? (h + 3) / 4 : h;
+        const size_t row_bytes = block ? (w + 3) / 4 * block : static_cast<size_t>(w) * 4;
+        const int rows = (std::min)(level_rows - request.row, static_cast<int>((settings_.slot_bytes - used) / row_bytes));
+        if (rows <= 0) {
+            break;
+        }
+
+        // řádky úrovně do stagingu, GPU je zkopíruje do textury z offsetu v GL_PIXEL_UNPACK_BUFFER
+        const std::vector<uint8_t>& level = request.chain.levels[request.level];
+        std::memcpy(staging_ptr_ + offset + used, level.data() + request.row * row_bytes, rows * row_bytes);
+        const void* source = reinterpret_cast<const void*>(offset + used);
+        const GLint y = request.row * texel_rows;
+        const GLsizei height = (std::min)(rows * texel_rows, h - y);
+        const GLsizei size = static_cast<GLsizei>(rows * row_bytes);
+        const GLint mip = static_cast<GLint>(request.level);
+        if (block && request.layer < 0) {
+            glCompressedTextureSubImage2D(request.texture, mip, 0, y, w, height, request.chain.format, size, source);
+        } else if (block) {
+            glCompressedTextureSubImage3D(request.texture, mip, 0, y, request.layer, w, height, 1, request.chain.format, size, source);
+        } else if (request.layer < 0) {
+            glTextureSubImage2D(request.texture, mip, 0, y, w, height, GL_BGRA, GL_UNSIGNED_BYTE, source);
+        } else {
+            glTextureSubImage3D(request.texture, mip, 0, y, request.layer, w, height, 1, GL_BGRA, GL_UNSIGNED_BYTE, source);
+        }
+        used += rows * row_bytes;
+
+        request.row += rows;
+        if (request.row == level_rows) {
+            request.row = 0;
+            request.level++;
+            if (request.level == request.chain.levels.size()) {
+                queue_.pop_front();
+            }
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return used;
+}
+
+void TextureUploader::upload() {
+    auto t0 = std::chrono::steady_clock::now();
+    auto elapsed_ms = [&]() { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count(); };
+    stats_.uploaded_bytes = 0;
+
+    bool first = true;
+    while (!queue_.empty() && staging_ptr_ && (first || elapsed_ms() < settings_.upload_budget_ms)) {
+        // úsek je volný, až GPU dokončí jeho předchozí kopii - jinak se pokračuje příští snímek
+        GLsync& fence = staging_fences_[staging_next_];
+        if (fence) {
+            GLenum status = glClientWaitSync(fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED) {
+                stats_.fence_waits++;
+                break;
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        const size_t used = fillSlot(staging_next_ * settings_.slot_bytes);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        staging_next_ = (staging_next_ + 1) % staging_fences_.size();
+        stats_.uploaded_bytes += used;
+        first = false;
+    }
+
+    stats_.upload_ms = elapsed_ms();
+    stats_.total_bytes += stats_.uploaded_bytes;
+}
+
+void TextureUploader::flush() {
+    auto t0 = std::chrono::steady_clock::now();
+    stats_.uploaded_bytes = 0;
+    while (!queue_.empty() && staging_ptr_) {
+        GLsync& fence = staging_fences_[staging_next_];
+        if (fence) {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {
+            }
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+        stats_.uploaded_bytes += fillSlot(staging_next_ * settings_.slot_bytes);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        staging_next_ = (staging_next_ + 1) % staging_fences_.size();
+    }
+    stats_.upload_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    stats_.total_bytes += stats_.uploaded_bytes;
+}
+
+void TextureUploader::clear() {
+    for (GLsync& fence : staging_fences_) {
+        if (fence) {
+            glDeleteSync(fence);
+        }
+    }
+    staging_fences_.clear();
+    if (staging_ptr_) {
+        glUnmapNamedBuffer(staging);
+        staging_ptr_ = nullptr;
+    }
+    glDeleteBuffers(1, &staging);
+    staging = 0;
+    staging_next_ = 0;
+    queue_.clear();
+    stats_ = Stats();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+
+#include <GL/glew.h>
+
+// Nahrávání textur do VRAM přes kruh trvale namapovaných staging bufferů.
+// Obrázky se dekódují a zmenšují na mip úrovně na pracovních vláknech (buildMipChain), upload() na GL
+// vlákně jen kopíruje řádky do volného úseku stagingu a zadá glTextureSubImage z GL_PIXEL_UNPACK_BUFFER.
+// Úsek se znovu použije, až GPU dokončí jeho kopii (fence) - když ještě není hotový, upload() skončí
+// a pokračuje příští snímek. Za snímek se nahrává jen do časového rozpočtu, velká textura se rozdělí
+// po řádcích do více úseků (a snímků). glGenerateTextureMipmap se nevolá, úrovně přijdou hotové z CPU.
+// Komprimované textury (BC1/BC3/BC7) se nahrávají stejně, jen po řádcích bloků 4x4
+// (glCompressedTextureSubImage).
+class TextureUploader {
+public:
+    struct Settings {
+        unsigned int slots = 4;             // úseků stagingu v kruhu
+        size_t slot_bytes = 2u << 20;       // velikost úseku (aspoň jeden řádek největší textury)
+        float upload_budget_ms = 2.0f;      // čas nahrávání na snímek (aspoň jeden úsek)
+    };
+
+    // mip úrovně s řádky těsně za sebou, [0] = plné rozlišení
+    struct MipChain {
+        int width = 0;
+        int height = 0;
+        GLenum format = 0;      // 0 = BGRA8, jinak GL_COMPRESSED_* po blocích 4x4
+        std::vector<std::vector<uint8_t>> levels;
+
+        size_t bytes() const;
+    };
+
+    struct Stats {
+        size_t uploaded_bytes = 0;  // poslední upload()
+        double upload_ms = 0.0;     // poslední upload()
+        size_t total_bytes = 0;     // celkem od init()
+        size_t fence_waits = 0;     // celkem: upload() skončil kvůli úseku, který GPU ještě nedokončilo
+    };
+
+    TextureUploader() = default;
+    TextureUploader(const TextureUploader&) = delete;
+    TextureUploader& operator=(const TextureUploader&) = delete;
+
+    // počet úrovní plné mip pyramidy
+    static GLsizei levelCount(int width, int height);
+    // bajtů na blok 4x4 komprimovaného formátu (BC1 8, BC3/BC7 16), 0 = nekomprimovaný BGRA8
+    static size_t blockBytes(GLenum format);
+    // mip pyramida průměrováním 2x2 (CPU, smí běžet na pracovním vlákně), bgra s řádky po row_bytes
+    static MipChain buildMipChain(const uint8_t* bgra, int width, int height, size_t row_bytes);
+
+    void init(const Settings& settings);
+
+    // texture musí mít úložiště ve formátu chain (RGBA8 nebo chain.format) s aspoň chain.levels.size()
+    // úrovněmi (glTextureStorage2D/3D), layer >= 0 = vrstva GL_TEXTURE_2D_ARRAY, -1 = GL_TEXTURE_2D
+    void enqueue(GLuint texture, GLint layer, MipChain chain);
+    // z fronty do VRAM v rámci rozpočtu, nečeká na GPU (GL vlákno)
+    void upload();
+    // celá fronta najednou, na obsazené úseky čeká (start bez progresivního načítání, benchmark)
+    void flush();
+
+    // textury, jejichž data ještě nejsou celá zadaná (po zadání je GL použije ve správném pořadí)
+    size_t pending() const { return queue_.size(); }
+    const Stats& stats() const { return stats_; }
+
+    void clear();
+
+private:
+    struct Request {
+        GLuint texture = 0;
+        GLint layer = -1;
+        MipChain chain;
+        size_t level = 0;   // další úroveň a řádek (u komprimovaných řádek bloků) k nahrání
+        int row = 0;
+    };
+
+    // kopie řádků z fronty do úseku stagingu od offset a zadání uploadu, vrací zaplněné bajty
+    size_t fillSlot(size_t offset);
+
+    Settings settings_;
+    std::deque<Request> queue_;
+    Stats stats_;
+
+    GLuint staging{ 0 };
+    uint8_t* staging_ptr_ = nullptr;
+    std::vector<GLsync> staging_fences_;
+    size_t staging_next_ = 0;
+};
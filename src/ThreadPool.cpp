@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <chrono>
+
+#include "ThreadPool.hpp"
+
+namespace {
+
+// plánovač a fronta vlákna, které právě běží (nullptr = vlákno mimo plánovač)
+thread_local const ThreadPool* tls_pool = nullptr;
+thread_local unsigned int tls_slot = 0;
+// čas úloh spuštěných vnořeně (wait uvnitř úlohy) - odečte se od času rodičovské úlohy
+thread_local uint64_t tls_nested_ns = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned int threads) {
+    if (threads == 0) {
+        threads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+    for (unsigned int i = 0; i < threads; ++i) {
+        slots_.push_back(std::make_unique<Slot>());
+    }
+    for (unsigned int i = 1; i < threads; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::currentSlot() const {
+    return tls_pool == this ? tls_slot : 0;
+}
+
+void ThreadPool::submit(std::function<void()> fn, JobCounter* counter) {
+    if (counter) {
+        counter->pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    push(Job{ std::move(fn), counter });
+}
+
+void ThreadPool::submitAfter(JobCounter& dependency, std::function<void()> fn, JobCounter* counter) {
+    if (counter) {
+        counter->pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    {
+        // pod zámkem závislosti - poslední úloha závislosti si pokračování vyzvedne pod stejným zámkem
+        std::lock_guard<std::mutex> lock(dependency.mutex_);
+        if (dependency.pending_.load(std::memory_order_acquire) != 0) {
+            dependency.continuations_.push_back({ std::move(fn), counter });
+            return;
+        }
+    }
+    push(Job{ std::move(fn), counter });
+}
+
+void ThreadPool::push(Job job) {
+    Slot& slot = *slots_[currentSlot()];
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.jobs.push_back(std::move(job));
+    }
+    // queued_ a sleeping_ sekvenčně konzistentně: buď pracovník uvidí novou úlohu, nebo my jeho spánek
+    queued_.fetch_add(1);
+    if (sleeping_.load() > 0) {
+        { std::lock_guard<std::mutex> lock(mutex_); }
+        wake_.notify_one();
+    }
+}
+
+bool ThreadPool::findJob(unsigned int index, Job& job, bool& stolen) {
+    if (queued_.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    // vlastní fronta od konce
+    {
+        Slot& own = *slots_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            queued_.fetch_sub(1);
+            stolen = false;
+            return true;
+        }
+    }
+    // krádež od začátku cizí fronty, počínaje sousedem (vlákna nekradou všechna od stejné oběti)
+    const unsigned int count = threadCount();
+    for (unsigned int k = 1; k < count; ++k) {
+        Slot& victim = *slots_[(index + k) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            queued_.fetch_sub(1);
+            stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runOne(unsigned int index) {
+    Job job;
+    bool stolen = false;
+    if (!findJob(index, job, stolen)) {
+        return false;
+    }
+    Slot& slot = *slots_[index];
+    if (profiling_.load(std::memory_order_relaxed)) {
+        const uint64_t outer_nested = tls_nested_ns;
+        tls_nested_ns = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        job.fn();
+        const uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+        slot.busy_ns.fetch_add(elapsed - (std::min)(tls_nested_ns, elapsed), std::memory_order_relaxed);
+        tls_nested_ns = outer_nested + elapsed;
+        slot.executed.fetch_add(1, std::memory_order_relaxed);
+        slot.steals.fetch_add(stolen ? 1 : 0, std::memory_order_relaxed);
+    } else {
+        job.fn();
+    }
+    finish(job.counter);
+    return true;
+}
+
+void ThreadPool::finish(JobCounter* counter) {
+    if (!counter) {
+        return;
+    }
+    std::vector<JobCounter::Continuation> ready;
+    {
+        // zámek drží čítač naživu - wait() se vrátí až po jeho uvolnění
+        std::lock_guard<std::mutex> lock(counter->mutex_);
+        if (counter->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(counter->continuations_);
+        }
+    }
+    for (auto& next : ready) {
+        push(Job{ std::move(next.fn), next.counter });
+    }
+}
+
+void ThreadPool::wait(JobCounter& counter) {
+    const unsigned int index = currentSlot();
+    while (!counter.done()) {
+        if (!runOne(index)) {
+            std::this_thread::yield();
+        }
+    }
+    // poslední finish() mohl ještě držet zámek čítače
+    std::lock_guard<std::mutex> lock(counter.mutex_);
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    grain = (std::max)(grain, size_t(1));
+    const size_t chunks = (count + grain - 1) / grain;
+    if (workers_.empty() || chunks == 1) {
+        fn(0, count);
+        return;
+    }
+
+    // jedna úloha na vlákno, bloky si úlohy berou přes atomický čítač (nerovnoměrné bloky se vyrovnají)
+    std::atomic<size_t> next{ 0 };
+    auto body = [&]() {
+        for (;;) {
+            size_t begin = next.fetch_add(grain, std::memory_order_relaxed);
+            if (begin >= count) {
+                return;
+            }
+            fn(begin, (std::min)(begin + grain, count));
+        }
+    };
+    JobCounter counter;
+    const size_t jobs = (std::min)(chunks, static_cast<size_t>(threadCount()));
+    for (size_t j = 0; j < jobs; ++j) {
+        submit(body, &counter);
+    }
+    wait(counter);
+}
+
+std::vector<ThreadPool::ThreadStats> ThreadPool::stats() const {
+    std::vector<ThreadStats> result(slots_.size());
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        result[i].jobs = slots_[i]->executed.load(std::memory_order_relaxed);
+        result[i].steals = slots_[i]->steals.load(std::memory_order_relaxed);
+        result[i].busy_ms = slots_[i]->busy_ns.load(std::memory_order_relaxed) / 1e6;
+    }
+    return result;
+}
+
+void ThreadPool::resetStats() {
+    for (auto& slot : slots_) {
+        slot->executed.store(0, std::memory_order_relaxed);
+        slot->steals.store(0, std::memory_order_relaxed);
+        slot->busy_ns.store(0, std::memory_order_relaxed);
+    }
+}
+
+void ThreadPool::workerLoop(unsigned int index) {
+    tls_pool = this;
+    tls_slot = index;
+    for (;;) {
+        if (runOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleeping_.fetch_add(1);
+        wake_.wait(lock, [this] { return stop_ || queued_.load() > 0; });
+        sleeping_.fetch_sub(1);
+        if (stop_) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+class ThreadPool;
+
+// Čítač nedokončených úloh (skupina úloh / závislost). submit(..., &counter) ho zvýší, dokončení
+// úlohy sníží. Úloha zadaná přes submitAfter(counter, ...) se spustí až ve chvíli, kdy čítač
+// klesne na nulu. Před zničením čítače je potřeba na něj počkat (ThreadPool::wait).
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool done() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class ThreadPool;
+    struct Continuation {
+        std::function<void()> fn;
+        JobCounter* counter;
+    };
+    std::atomic<int> pending_{ 0 };
+    std::mutex mutex_;                          // dokončení poslední úlohy vs. přidání pokračování
+    std::vector<Continuation> continuations_;
+};
+
+// Plánovač úloh sdílený načítáním, generováním terénu, cullingem a simulací.
+// Každé vlákno má vlastní frontu: nové úlohy dává na konec a bere je z konce (naposledy zadané
+// jsou ještě v cache), nečinné vlákno krade ze začátku fronty jiného vlákna. Vlákna, která nejsou
+// pracovníky plánovače (hlavní smyčka, streamování), sdílí frontu 0. Kdo čeká (wait, parallelFor),
+// mezitím sám zpracovává úlohy, takže úlohy smí zadávat a čekat i vnořeně.
+class ThreadPool {
+public:
+    // vytížení jednoho vlákna od posledního resetStats (jen se zapnutým profilováním)
+    struct ThreadStats {
+        uint64_t jobs = 0;      // provedené úlohy
+        uint64_t steals = 0;    // z toho ukradené z cizí fronty
+        double busy_ms = 0.0;   // čas strávený v úlohách (vnořené úlohy se počítají jen jednou)
+    };
+
+    // threads = celkový počet vláken včetně volajícího (0 = std::thread::hardware_concurrency)
+    explicit ThreadPool(unsigned int threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned int threadCount() const { return static_cast<unsigned int>(slots_.size()); }
+
+    // úloha do fronty volajícího vlákna, counter (volitelný) se zvýší hned a sníží po dokončení
+    void submit(std::function<void()> fn, JobCounter* counter = nullptr);
+    // úloha, která se zařadí až po dokončení všech úloh dependency
+    void submitAfter(JobCounter& dependency, std::function<void()> fn, JobCounter* counter = nullptr);
+    // čeká na dokončení úloh čítače a mezitím zpracovává úlohy
+    void wait(JobCounter& counter);
+
+    // fn(begin, end) pro bloky po grain položkách z [0, count), vrátí se po zpracování všech
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& fn);
+
+    // profilování - čas a počet úloh po vláknech (index 0 = vlákna mimo plánovač)
+    void setProfiling(bool enabled) { profiling_.store(enabled, std::memory_order_relaxed); }
+    std::vector<ThreadStats> stats() const;
+    void resetStats();
+
+private:
+    struct Job {
+        std::function<void()> fn;
+        JobCounter* counter = nullptr;
+    };
+    // fronta a statistiky jednoho vlákna (zarovnané, aby si vlákna nepřepisovala cache line)
+    struct alignas(64) Slot {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::atomic<uint64_t> executed{ 0 };
+        std::atomic<uint64_t> steals{ 0 };
+        std::atomic<uint64_t> busy_ns{ 0 };
+    };
+
+    void push(Job job);
+    bool findJob(unsigned int index, Job& job, bool& stolen);
+    bool runOne(unsigned int index);
+    void finish(JobCounter* counter);
+    unsigned int currentSlot() const;
+    void workerLoop(unsigned int index);
+
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::vector<std::thread> workers_;          // pracovník i obsluhuje slots_[i + 1]
+    std::atomic<size_t> queued_{ 0 };           // úlohy čekající ve frontách
+    std::atomic<unsigned int> sleeping_{ 0 };
+    std::atomic<bool> profiling_{ false };
+    std::mutex mutex_;                          // jen pro uspání / probuzení pracovníků
+    std::condition_variable wake_;
+    bool stop_ = false;
+};